@@ -0,0 +1,129 @@
+#include "AdaptiveFpsController.h"
+
+#include <cstdio>
+
+AdaptiveFpsController::AdaptiveFpsController(int64_t frequency, const AdaptiveFpsConfig& config)
+	: m_frequency(frequency), m_pacingError(frequency) {
+	Configure(config);
+}
+
+void AdaptiveFpsController::Configure(const AdaptiveFpsConfig& config) {
+	m_config = config;
+	if (m_config.minFps < 1) m_config.minFps = 1;
+	if (m_config.maxFps < m_config.minFps) m_config.maxFps = m_config.minFps;
+	if (m_config.windowFrames < 1) m_config.windowFrames = 1;
+	if (m_config.settleFrames < 0) m_config.settleFrames = 0;
+	if (m_config.resolutionFps < 1) m_config.resolutionFps = 1;
+}
+
+void AdaptiveFpsController::Start() {
+	m_probes.clear();
+	m_phase = AdaptivePhase::Ramp;
+	m_low = 0;
+	m_high = m_config.maxFps + 1;
+	m_best = 0;
+	BeginProbe(m_config.minFps);
+}
+
+void AdaptiveFpsController::BeginProbe(int targetFps) {
+	m_target = targetFps;
+	m_frames = 0;
+	m_windowTicks = 0;
+	m_lateFrames = 0;
+	m_pacingError.Reset();
+}
+
+bool AdaptiveFpsController::AddFrame(int64_t intervalTicks) {
+	if (Done() || intervalTicks <= 0) return false;
+
+	// The first frames after a retarget still carry the old rate.
+	m_frames++;
+	if (m_frames <= m_config.settleFrames) return false;
+
+	int64_t period = m_frequency / m_target;
+	int64_t error = intervalTicks - period;
+	m_pacingError.Add(error < 0 ? -error : error);
+	m_windowTicks += intervalTicks;
+	if (intervalTicks * 2 > period * 3) m_lateFrames++;
+	if (m_frames < m_config.settleFrames + m_config.windowFrames) return false;
+
+	int previous = m_target;
+	Decide(EvaluateProbe());
+	if (!Done() && m_target == previous) BeginProbe(m_target);
+	return m_target != previous || Done();
+}
+
+bool AdaptiveFpsController::EvaluateProbe() {
+	AdaptiveProbe probe;
+	probe.targetFps = m_target;
+	uint64_t frames = m_pacingError.Count();
+	if (m_windowTicks > 0) probe.achievedFps = static_cast<double>(frames) * static_cast<double>(m_frequency) / static_cast<double>(m_windowTicks);
+	probe.pacingP95Ms = m_pacingError.QuantileMs(0.95);
+	probe.lateFraction = frames ? static_cast<double>(m_lateFrames) / static_cast<double>(frames) : 1.0;
+
+	double periodMs = 1000.0 / m_target;
+	probe.passed = probe.achievedFps >= m_target * 0.99 &&
+		probe.pacingP95Ms <= periodMs * m_config.pacingBudget &&
+		probe.lateFraction <= m_config.dropBudget;
+	m_probes.push_back(probe);
+	return probe.passed;
+}
+
+int AdaptiveFpsController::HighestPassBelow(int fps) const {
+	int best = 0;
+	for (const AdaptiveProbe& probe : m_probes) {
+		if (probe.passed && probe.targetFps < fps && probe.targetFps > best) best = probe.targetFps;
+	}
+	return best;
+}
+
+void AdaptiveFpsController::Decide(bool passed) {
+	if (passed) {
+		if (m_target > m_low) m_low = m_target;
+	}
+	else if (m_target < m_high) {
+		m_high = m_target;
+	}
+
+	switch (m_phase) {
+	case AdaptivePhase::Ramp:
+		if (passed && m_target < m_config.maxFps) {
+			int next = m_target * 2;
+			BeginProbe(next < m_config.maxFps ? next : m_config.maxFps);
+			return;
+		}
+		m_phase = AdaptivePhase::Search;
+		break;
+	case AdaptivePhase::Confirm:
+		if (passed) {
+			m_best = m_target;
+			m_phase = AdaptivePhase::Done;
+			return;
+		}
+		// The earlier pass was noise: the bracket's top drops below it and the search resumes.
+		m_low = HighestPassBelow(m_high);
+		m_phase = AdaptivePhase::Search;
+		break;
+	default:
+		break;
+	}
+
+	if (m_low == 0) {
+		m_best = 0;
+		m_phase = AdaptivePhase::Done;
+		return;
+	}
+	if (m_high - m_low <= m_config.resolutionFps) {
+		m_phase = AdaptivePhase::Confirm;
+		BeginProbe(m_low);
+		return;
+	}
+	BeginProbe(m_low + (m_high - m_low) / 2);
+}
+
+std::string FormatAdaptiveProbe(const AdaptiveProbe& probe) {
+	char buffer[160];
+	snprintf(buffer, sizeof(buffer), "target=%d fps achieved=%.2f fps pacing p95=%.3f ms late=%.2f%% %s",
+		probe.targetFps, probe.achievedFps, probe.pacingP95Ms, probe.lateFraction * 100.0, probe.passed ? "pass" : "fail");
+	return buffer;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "FrameStatistics.h"
+
+struct AdaptiveFpsConfig {
+	int minFps = 30;
+	int maxFps = 1000;
+	int settleFrames = 30;
+	int windowFrames = 120;
+	// A probe passes when p95 |interval - period| stays within this fraction of the
+	// period, at most dropBudget of its frames run over 1.5 periods, and the achieved
+	// rate is within 1% of the target. Rare hitches are the drop budget's business,
+	// so one stall in a window does not fail the rate on pacing alone.
+	double pacingBudget = 0.10;
+	double dropBudget = 0.01;
+	int resolutionFps = 2;
+};
+
+enum class AdaptivePhase {
+	Ramp,
+	Search,
+	Confirm,
+	Done
+};
+
+struct AdaptiveProbe {
+	int targetFps = 0;
+	double achievedFps = 0.0;
+	double pacingP95Ms = 0.0;
+	double lateFraction = 0.0;
+	bool passed = false;
+};
+
+// Finds the highest sustainable target rate: doubles from minFps until a probe fails,
+// bisects between the best pass and the lowest fail, then re-probes the result. Each
+// probe is settleFrames + windowFrames long, and the bracket only ever shrinks, so it
+// converges in O(log(max/min)) probes without oscillating.
+class AdaptiveFpsController {
+public:
+	explicit AdaptiveFpsController(int64_t frequency, const AdaptiveFpsConfig& config = AdaptiveFpsConfig());
+
+	void Configure(const AdaptiveFpsConfig& config);
+	void Start();
+	void Stop() { m_phase = AdaptivePhase::Done; }
+	// Feed every presented frame's interval. Returns true when TargetFps() changed.
+	bool AddFrame(int64_t intervalTicks);
+
+	int TargetFps() const { return m_target; }
+	AdaptivePhase Phase() const { return m_phase; }
+	bool Done() const { return m_phase == AdaptivePhase::Done; }
+	// Highest confirmed rate; 0 if even minFps failed.
+	int BestFps() const { return m_best; }
+	const std::vector<AdaptiveProbe>& Probes() const { return m_probes; }
+
+private:
+	void BeginProbe(int targetFps);
+	bool EvaluateProbe();
+	void Decide(bool passed);
+	int HighestPassBelow(int fps) const;
+
+	int64_t m_frequency;
+	AdaptiveFpsConfig m_config;
+	AdaptivePhase m_phase = AdaptivePhase::Done;
+	int m_target = 0;
+	int m_low = 0;
+	int m_high = 0;
+	int m_best = 0;
+	int m_frames = 0;
+	int64_t m_windowTicks = 0;
+	uint64_t m_lateFrames = 0;
+	FrameStatistics m_pacingError;
+	std::vector<AdaptiveProbe> m_probes;
+};
+
+std::string FormatAdaptiveProbe(const AdaptiveProbe& probe);
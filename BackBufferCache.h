@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+struct BackBufferCacheStats {
+	uint64_t rebuilds = 0;
+	uint64_t lookups = 0;
+	uint64_t comCalls = 0;
+};
+
+// Per-swap-chain handles (texture + view per buffer), fetched once when the swap chain
+// is created or resized and looked up by buffer index on every frame afterwards.
+// Callbacks return the number of COM calls they made so the counters show that the
+// per-frame path makes none.
+template <typename Entry>
+class BackBufferCache {
+public:
+	template <typename Acquire>
+	bool Rebuild(int bufferCount, Acquire acquire) {
+		m_entries.assign(bufferCount > 0 ? bufferCount : 0, Entry());
+		m_stats.rebuilds++;
+		bool complete = true;
+		for (int i = 0; i < static_cast<int>(m_entries.size()); ++i) {
+			int comCalls = 0;
+			if (!acquire(i, m_entries[i], comCalls)) complete = false;
+			m_stats.comCalls += comCalls;
+		}
+		return complete;
+	}
+
+	template <typename Release>
+	void Clear(Release release) {
+		for (Entry& entry : m_entries) {
+			m_stats.comCalls += release(entry);
+		}
+		m_entries.clear();
+	}
+
+	Entry* Get(int bufferIndex) {
+		m_stats.lookups++;
+		if (bufferIndex < 0 || bufferIndex >= static_cast<int>(m_entries.size())) return nullptr;
+		return &m_entries[bufferIndex];
+	}
+
+	bool Empty() const { return m_entries.empty(); }
+	int Size() const { return static_cast<int>(m_entries.size()); }
+	const BackBufferCacheStats& Stats() const { return m_stats; }
+
+private:
+	std::vector<Entry> m_entries;
+	BackBufferCacheStats m_stats;
+};
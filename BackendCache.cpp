@@ -0,0 +1,86 @@
+#include "BackendCache.h"
+
+BackendReuse PlanBackendReuse(const BackendCacheKey& cached, const BackendCacheKey& wanted) {
+	if (cached.type != wanted.type || cached.renderAdapter != wanted.renderAdapter || cached.displayAdapter != wanted.displayAdapter) {
+		return BackendReuse::Rebuild;
+	}
+	if (cached.window != wanted.window || cached.allowTearing != wanted.allowTearing ||
+		cached.waitOnSwapChain != wanted.waitOnSwapChain || cached.maxFrameLatency != wanted.maxFrameLatency) {
+		return BackendReuse::SwapChain;
+	}
+	if (cached.width != wanted.width || cached.height != wanted.height) {
+		return BackendReuse::Resize;
+	}
+	return BackendReuse::Full;
+}
+
+const char* BackendReuseName(BackendReuse reuse) {
+	switch (reuse) {
+	case BackendReuse::Rebuild: return "rebuild";
+	case BackendReuse::SwapChain: return "swap-chain";
+	case BackendReuse::Resize: return "resize";
+	case BackendReuse::Full: return "reuse";
+	}
+	return "unknown";
+}
+
+BackendCache::BackendCache(const BackendCacheHooks& hooks)
+	: m_hooks(hooks) {
+}
+
+BackendCache::~BackendCache() {
+	Reset();
+}
+
+BackendReuse BackendCache::Plan(const BackendCacheKey& key) const {
+	if (!m_backend) return BackendReuse::Rebuild;
+	BackendReuse reuse = PlanBackendReuse(m_key, key);
+	if (!m_surfaceValid && reuse > BackendReuse::SwapChain) reuse = BackendReuse::SwapChain;
+	return reuse;
+}
+
+RenderBackend* BackendCache::Acquire(const BackendCacheKey& key, BackendReuse& reuse) {
+	reuse = Plan(key);
+	if (reuse == BackendReuse::SwapChain && !(m_hooks.resetSurface && m_hooks.resetSurface(*m_backend, key))) {
+		reuse = BackendReuse::Rebuild;
+	}
+
+	switch (reuse) {
+	case BackendReuse::Rebuild:
+		Reset();
+		if (m_hooks.create) m_backend = m_hooks.create(key);
+		if (!m_backend) {
+			m_stats.failures++;
+			return nullptr;
+		}
+		m_stats.rebuilds++;
+		break;
+	case BackendReuse::SwapChain:
+		m_stats.swapChainResets++;
+		break;
+	case BackendReuse::Resize:
+		m_backend->Resize(key.width, key.height);
+		m_stats.resizes++;
+		break;
+	case BackendReuse::Full:
+		m_stats.reuses++;
+		break;
+	}
+	m_key = key;
+	m_surfaceValid = true;
+	return m_backend.get();
+}
+
+void BackendCache::ReleaseSurface() {
+	if (m_backend && m_surfaceValid && m_hooks.releaseSurface) m_hooks.releaseSurface(*m_backend);
+	m_surfaceValid = false;
+}
+
+void BackendCache::Reset() {
+	if (m_backend) {
+		m_backend->Cleanup();
+		m_backend.reset();
+	}
+	m_key = BackendCacheKey();
+	m_surfaceValid = false;
+}
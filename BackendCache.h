@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "RenderBackend.h"
+
+// Everything a backend was built for. Adapters and the window are opaque handles so
+// the policy does not depend on DXGI.
+struct BackendCacheKey {
+	RenderBackendType type = RenderBackendType::D3D11;
+	const void* renderAdapter = nullptr;
+	const void* displayAdapter = nullptr;
+	const void* window = nullptr;
+	int width = 0;
+	int height = 0;
+	bool allowTearing = false;
+	bool waitOnSwapChain = false;
+	int maxFrameLatency = 1;
+};
+
+// How much of a cached backend survives a new key, cheapest last.
+enum class BackendReuse {
+	Rebuild,    // different backend type or adapters: new devices
+	SwapChain,  // same devices, new window or swap-chain flags
+	Resize,     // same swap chain, new buffer size
+	Full        // nothing to do beyond the present plan
+};
+
+BackendReuse PlanBackendReuse(const BackendCacheKey& cached, const BackendCacheKey& wanted);
+const char* BackendReuseName(BackendReuse reuse);
+
+struct BackendCacheHooks {
+	// Returns an initialised backend for the key, or null.
+	std::function<std::unique_ptr<RenderBackend>(const BackendCacheKey&)> create;
+	// Re-creates the window-bound surface (swap chain) on the existing devices.
+	std::function<bool(RenderBackend&, const BackendCacheKey&)> resetSurface;
+	// Drops the window-bound surface before its window is destroyed.
+	std::function<void(RenderBackend&)> releaseSurface;
+};
+
+struct BackendCacheStats {
+	uint64_t rebuilds = 0;
+	uint64_t swapChainResets = 0;
+	uint64_t resizes = 0;
+	uint64_t reuses = 0;
+	uint64_t failures = 0;
+};
+
+// Keeps one render backend alive between sessions, so going back to the settings
+// window and starting again only redoes what the new settings actually change.
+class BackendCache {
+public:
+	explicit BackendCache(const BackendCacheHooks& hooks);
+	~BackendCache();
+	BackendCache(const BackendCache&) = delete;
+	BackendCache& operator=(const BackendCache&) = delete;
+
+	BackendReuse Plan(const BackendCacheKey& key) const;
+	// Brings the cached backend in line with key; null if it could not be created.
+	RenderBackend* Acquire(const BackendCacheKey& key, BackendReuse& reuse);
+	// Call before destroying the window the cached surface belongs to.
+	void ReleaseSurface();
+	void Reset();
+
+	RenderBackend* Backend() const { return m_backend.get(); }
+	const BackendCacheKey& Key() const { return m_key; }
+	const BackendCacheStats& Stats() const { return m_stats; }
+
+private:
+	BackendCacheHooks m_hooks;
+	std::unique_ptr<RenderBackend> m_backend;
+	BackendCacheKey m_key;
+	bool m_surfaceValid = false;
+	BackendCacheStats m_stats;
+};
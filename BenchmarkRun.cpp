@@ -0,0 +1,251 @@
+#include "BenchmarkRun.h"
+
+#include <cstdio>
+#include "FrameClock.h"
+#include "FrameLogWriter.h"
+#include "HeadlessBackend.h"
+#include "LoadGenerator.h"
+#include "RenderThread.h"
+
+BenchmarkRun::BenchmarkRun(FrameLoop& loop, const RunConfig& config)
+	: m_loop(loop), m_config(config), m_pacingError(loop.Clock().Frequency()), m_search(loop.Clock().Frequency(), config.adaptive) {
+	const double frequency = static_cast<double>(loop.Clock().Frequency());
+	m_warmupTicks = static_cast<int64_t>(config.warmupSeconds * frequency);
+	m_durationTicks = static_cast<int64_t>(config.durationSeconds * frequency);
+	m_step = m_config.targetFps.size();
+}
+
+void BenchmarkRun::Start() {
+	m_results.clear();
+	m_step = 0;
+	m_loop.Start();
+	m_searching = m_config.findMaxFps;
+	if (m_searching) {
+		m_config.targetFps.assign(1, m_config.adaptive.minFps);
+		m_search.Start();
+		ApplyTarget(m_search.TargetFps(), m_loop.Clock().Now());
+	}
+	else if (!Finished()) {
+		BeginStep();
+	}
+}
+
+void BenchmarkRun::ApplyTarget(int targetFps, int64_t now) {
+	int scheduledFps = m_stepHandler ? m_stepHandler(targetFps) : targetFps;
+	m_loop.Scheduler().SetTargetFps(scheduledFps, now);
+}
+
+void BenchmarkRun::SearchFrame(const FrameRecord& record) {
+	if (!m_search.AddFrame(record.interval)) return;
+	if (!m_search.Done()) {
+		ApplyTarget(m_search.TargetFps(), record.present);
+		return;
+	}
+	// Nothing sustained: measure the bottom of the range so the report still has a step.
+	m_searching = false;
+	if (m_search.BestFps() > 0) m_config.targetFps[0] = m_search.BestFps();
+	BeginStep();
+}
+
+void BenchmarkRun::BeginStep() {
+	int64_t now = m_loop.Clock().Now();
+	ApplyTarget(m_config.targetFps[m_step], now);
+	m_stepStart = now;
+	m_measuring = false;
+	if (m_warmupTicks <= 0) BeginMeasurement(now);
+}
+
+void BenchmarkRun::BeginMeasurement(int64_t now) {
+	m_loop.Statistics().Reset();
+	m_pacingError.Reset();
+	m_measureStart = now;
+	m_skippedAtStart = m_loop.Scheduler().SkippedFrames();
+	m_lateFrames = 0;
+	m_cpuAtStart = ProcessCpuSeconds();
+	if (m_pPatternCheck) m_pPatternCheck->Reset();
+	m_measuring = true;
+}
+
+void BenchmarkRun::Measure(const FrameRecord& record) {
+	if (record.interval <= 0) return;
+	int64_t period = m_loop.Scheduler().PeriodTicks();
+	int64_t error = record.interval - period;
+	m_pacingError.Add(error < 0 ? -error : error);
+	if (record.interval * 2 > period * 3) m_lateFrames++;
+}
+
+void BenchmarkRun::EndStep(int64_t now) {
+	RunStepResult result;
+	result.backend = m_config.backend;
+	result.output = m_config.outputIndex;
+	result.width = m_config.width;
+	result.height = m_config.height;
+	result.presentMode = m_config.presentMode;
+	result.targetFps = m_config.targetFps[m_step];
+	result.sustainable = m_config.findMaxFps && m_search.BestFps() > 0;
+	result.seconds = static_cast<double>(now - m_measureStart) / static_cast<double>(m_loop.Clock().Frequency());
+	result.skippedFrames = m_loop.Scheduler().SkippedFrames() - m_skippedAtStart;
+	result.lateFrames = m_lateFrames;
+	result.summary = m_loop.Statistics().Summary();
+	result.pacingError = m_pacingError.Summary();
+	if (m_pPatternCheck) result.pattern = m_pPatternCheck->Stats();
+
+	double cpuSeconds = ProcessCpuSeconds() - m_cpuAtStart;
+	if (result.summary.frames > 0) result.cpuMsPerFrame = cpuSeconds * 1000.0 / static_cast<double>(result.summary.frames);
+	if (result.seconds > 0.0) result.cpuPercent = cpuSeconds * 100.0 / result.seconds;
+	m_results.push_back(result);
+}
+
+bool BenchmarkRun::Tick() {
+	if (Finished()) return false;
+
+	const FrameRecord& record = m_loop.RunFrame();
+	if (m_searching) {
+		SearchFrame(record);
+		return true;
+	}
+	if (!m_measuring) {
+		if (record.present - m_stepStart >= m_warmupTicks) BeginMeasurement(record.present);
+		return true;
+	}
+	Measure(record);
+	if (record.present - m_measureStart < m_durationTicks) return true;
+
+	EndStep(record.present);
+	m_step++;
+	if (Finished()) return false;
+	BeginStep();
+	return true;
+}
+
+namespace {
+	// The headless backend never presents to a display, so no present mode applies.
+	const char* ResultPresentModeName(const RunStepResult& result) {
+		return result.backend == RenderBackendType::Headless ? "none" : PresentModeName(result.presentMode);
+	}
+
+	void WriteStatsCsv(FILE* file, const std::vector<RunStepResult>& results) {
+		fprintf(file, "backend,width,height,present_mode,target_fps,sustainable,seconds,frames,skipped,late,avg_fps,mean_ms,stddev_ms,min_ms,p50_ms,p95_ms,p99_ms,p999_ms,max_ms,low1_fps,low01_fps,"
+			"pacing_mean_ms,pacing_p50_ms,pacing_p95_ms,pacing_p99_ms,pacing_max_ms,cpu_ms_per_frame,cpu_percent,"
+			"pattern_frames,pattern_undecoded,pattern_dropped,pattern_repeated,pattern_reordered,output\n");
+		for (const RunStepResult& result : results) {
+			const FrameSummary& s = result.summary;
+			const FrameSummary& p = result.pacingError;
+			const PatternCheckStats& t = result.pattern;
+			fprintf(file, "%s,%d,%d,%s,%d,%d,%.3f,%llu,%llu,%llu,%.3f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.3f,%.3f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.2f,%llu,%llu,%llu,%llu,%llu,%d\n",
+				RenderBackendName(result.backend), result.width, result.height, ResultPresentModeName(result), result.targetFps, result.sustainable ? 1 : 0, result.seconds,
+				static_cast<unsigned long long>(s.frames), static_cast<unsigned long long>(result.skippedFrames), static_cast<unsigned long long>(result.lateFrames),
+				s.averageFps, s.meanMs, s.stddevMs, s.minMs, s.p50Ms, s.p95Ms, s.p99Ms, s.p999Ms, s.maxMs, s.low1Fps, s.low01Fps,
+				p.meanMs, p.p50Ms, p.p95Ms, p.p99Ms, p.maxMs, result.cpuMsPerFrame, result.cpuPercent,
+				static_cast<unsigned long long>(t.frames), static_cast<unsigned long long>(t.undecoded), static_cast<unsigned long long>(t.dropped),
+				static_cast<unsigned long long>(t.repeated), static_cast<unsigned long long>(t.reordered), result.output);
+		}
+	}
+
+	void WriteStatsJson(FILE* file, const std::vector<RunStepResult>& results) {
+		fprintf(file, "{\n  \"steps\": [");
+		for (size_t i = 0; i < results.size(); ++i) {
+			const RunStepResult& result = results[i];
+			const FrameSummary& s = result.summary;
+			const FrameSummary& p = result.pacingError;
+			fprintf(file, "%s\n    {\"backend\": \"%s\", \"output\": %d, \"width\": %d, \"height\": %d, \"present_mode\": \"%s\", \"target_fps\": %d, \"sustainable\": %s, \"seconds\": %.3f,",
+				i ? "," : "", RenderBackendName(result.backend), result.output, result.width, result.height, ResultPresentModeName(result), result.targetFps,
+				result.sustainable ? "true" : "false", result.seconds);
+			fprintf(file, " \"frames\": %llu, \"skipped_frames\": %llu, \"late_frames\": %llu, \"achieved_fps\": %.3f, \"low1_fps\": %.3f, \"low01_fps\": %.3f,",
+				static_cast<unsigned long long>(s.frames), static_cast<unsigned long long>(result.skippedFrames), static_cast<unsigned long long>(result.lateFrames),
+				s.averageFps, s.low1Fps, s.low01Fps);
+			fprintf(file, " \"frametime_ms\": {\"mean\": %.4f, \"stddev\": %.4f, \"min\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"p999\": %.4f, \"max\": %.4f},",
+				s.meanMs, s.stddevMs, s.minMs, s.p50Ms, s.p95Ms, s.p99Ms, s.p999Ms, s.maxMs);
+			fprintf(file, " \"pacing_error_ms\": {\"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"p999\": %.4f, \"max\": %.4f},",
+				p.meanMs, p.p50Ms, p.p95Ms, p.p99Ms, p.p999Ms, p.maxMs);
+			const PatternCheckStats& t = result.pattern;
+			fprintf(file, " \"pattern\": {\"frames\": %llu, \"undecoded\": %llu, \"dropped\": %llu, \"repeated\": %llu, \"reordered\": %llu},",
+				static_cast<unsigned long long>(t.frames), static_cast<unsigned long long>(t.undecoded), static_cast<unsigned long long>(t.dropped),
+				static_cast<unsigned long long>(t.repeated), static_cast<unsigned long long>(t.reordered));
+			fprintf(file, " \"cpu_ms_per_frame\": %.4f, \"cpu_percent\": %.2f}", result.cpuMsPerFrame, result.cpuPercent);
+		}
+		fprintf(file, "\n  ]\n}\n");
+	}
+}
+
+bool WriteRunStats(const std::string& path, const std::vector<RunStepResult>& results, std::string& error) {
+	FILE* file = nullptr;
+#ifdef _MSC_VER
+	if (fopen_s(&file, path.c_str(), "w") != 0) file = nullptr;
+#else
+	file = fopen(path.c_str(), "w");
+#endif
+	if (!file) {
+		error = "cannot open stats file '" + path + "'";
+		return false;
+	}
+
+	bool json = path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+	if (json) WriteStatsJson(file, results);
+	else WriteStatsCsv(file, results);
+	bool ok = ferror(file) == 0;
+	if (fclose(file) != 0) ok = false;
+	if (!ok) error = "failed writing stats file '" + path + "'";
+	return ok;
+}
+
+std::string FormatRunStep(const RunStepResult& result) {
+	char buffer[256];
+	snprintf(buffer, sizeof(buffer), "%s output %d %dx%d %s target=%d fps%s skipped=%llu late=%llu pacing p99=%.3f ms cpu=%.3f ms/frame ",
+		RenderBackendName(result.backend), result.output, result.width, result.height, ResultPresentModeName(result), result.targetFps, result.sustainable ? " (max sustainable)" : "",
+		static_cast<unsigned long long>(result.skippedFrames), static_cast<unsigned long long>(result.lateFrames),
+		result.pacingError.p99Ms, result.cpuMsPerFrame);
+	std::string text = buffer + FormatFrameSummary(result.summary);
+	if (result.pattern.frames > 0) text += " pattern " + FormatPatternCheck(result.pattern);
+	return text;
+}
+
+int RunHeadlessBenchmark(const RunConfig& config, std::vector<RunStepResult>& results, std::string& error) {
+	RunConfig runConfig = config;
+	if (runConfig.width <= 0 || runConfig.height <= 0) {
+		runConfig.width = 1920;
+		runConfig.height = 1080;
+	}
+
+	SystemClock clock;
+	HeadlessBackend backend;
+	if (!backend.Init(runConfig.width, runConfig.height)) {
+		error = "headless backend init failed";
+		return kRunExitInitFailed;
+	}
+
+	FrameLoop loop(backend, clock, config.targetFps.empty() ? 60 : config.targetFps.front(), config.catchUpPolicy);
+	FrameLogWriter frameLog;
+	if (!config.frameLogPath.empty()) {
+		if (!frameLog.Open(config.frameLogPath, FrameLogFormatForPath(config.frameLogPath), clock.Frequency())) {
+			error = "cannot open frame log '" + config.frameLogPath + "'";
+			backend.Cleanup();
+			return kRunExitInitFailed;
+		}
+		loop.SetFrameLog(&frameLog);
+	}
+
+	LoadGenerator load(clock);
+	load.Configure(config.load);
+	loop.SetLoadGenerator(&load);
+	PerfOverlay overlay(clock.Frequency());
+	if (config.overlay) loop.SetOverlay(&overlay);
+
+	BenchmarkRun run(loop, runConfig);
+	TestPattern pattern(config.pattern);
+	TestPatternDecoder patternCheck(config.pattern);
+	if (config.pattern.Enabled()) {
+		loop.SetTestPattern(&pattern);
+		backend.SetPatternCheck(&patternCheck);
+		run.SetPatternCheck(&patternCheck);
+	}
+	run.Start();
+	RenderThread renderThread;
+	renderThread.Start(config.renderThread, nullptr, [&run]() { return run.Tick(); }, nullptr);
+	renderThread.Join();
+	backend.Cleanup();
+	frameLog.Close();
+
+	results = run.Results();
+	return kRunExitOk;
+}
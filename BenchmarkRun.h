@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "FrameLoop.h"
+#include "FrameStatistics.h"
+#include "RunConfig.h"
+#include "TestPattern.h"
+
+struct RunStepResult {
+	RenderBackendType backend = RenderBackendType::D3D11;
+	// Display output index; tells the outputs of a multi-output run apart.
+	int output = 0;
+	int width = 0;
+	int height = 0;
+	PresentMode presentMode = PresentMode::VSync;
+	int targetFps = 0;
+	// Set when the step measures the result of a --find-max search.
+	bool sustainable = false;
+	double seconds = 0.0;
+	uint64_t skippedFrames = 0;
+	uint64_t lateFrames = 0;
+	double cpuMsPerFrame = 0.0;
+	double cpuPercent = 0.0;
+	FrameSummary summary;
+	// |interval - target period| per frame; reuses the frametime histogram.
+	FrameSummary pacingError;
+	// Decoded test pattern over the measured window; frames == 0 when nothing checked it.
+	PatternCheckStats pattern;
+};
+
+// Drives a FrameLoop through each target FPS of a RunConfig: a warm-up that is
+// discarded, then the measured window. With findMaxFps an adaptive search runs first
+// and its result becomes the only step. One Tick() is one frame, so it slots into
+// a message pump as easily as into a plain loop. Frames more than 1.5 periods apart
+// count as late.
+class BenchmarkRun {
+public:
+	BenchmarkRun(FrameLoop& loop, const RunConfig& config);
+
+	// Called at the start of each step with the requested FPS; returns the FPS to
+	// schedule (e.g. after present planning).
+	void SetStepHandler(const std::function<int(int)>& handler) { m_stepHandler = handler; }
+	// Reset at the start of each measured window; its stats go into the step result.
+	void SetPatternCheck(TestPatternDecoder* pCheck) { m_pPatternCheck = pCheck; }
+
+	void Start();
+	bool Tick();
+	bool Finished() const { return m_step >= m_config.targetFps.size(); }
+	const std::vector<RunStepResult>& Results() const { return m_results; }
+	const AdaptiveFpsController& Search() const { return m_search; }
+
+private:
+	void ApplyTarget(int targetFps, int64_t now);
+	void SearchFrame(const FrameRecord& record);
+	void BeginStep();
+	void BeginMeasurement(int64_t now);
+	void Measure(const FrameRecord& record);
+	void EndStep(int64_t now);
+
+	FrameLoop& m_loop;
+	RunConfig m_config;
+	std::function<int(int)> m_stepHandler;
+	TestPatternDecoder* m_pPatternCheck = nullptr;
+	std::vector<RunStepResult> m_results;
+	FrameStatistics m_pacingError;
+	AdaptiveFpsController m_search;
+	bool m_searching = false;
+	size_t m_step = 0;
+	bool m_measuring = false;
+	int64_t m_stepStart = 0;
+	int64_t m_measureStart = 0;
+	int64_t m_warmupTicks = 0;
+	int64_t m_durationTicks = 0;
+	uint64_t m_skippedAtStart = 0;
+	uint64_t m_lateFrames = 0;
+	double m_cpuAtStart = 0.0;
+};
+
+// Writes JSON when the path ends in ".json", CSV otherwise.
+bool WriteRunStats(const std::string& path, const std::vector<RunStepResult>& results, std::string& error);
+std::string FormatRunStep(const RunStepResult& result);
+// Runs every step of a single-cell config against the headless backend; returns a RunExitCode.
+int RunHeadlessBenchmark(const RunConfig& config, std::vector<RunStepResult>& results, std::string& error);
@@ -0,0 +1,100 @@
+#include "BenchmarkSuite.h"
+
+#include "FrameLogWriter.h"
+#include "MultiOutputRun.h"
+#include "Tracer.h"
+
+std::vector<SuiteCell> BuildSuiteCells(const RunConfig& config) {
+	std::vector<RenderBackendType> backends = config.backends;
+	if (backends.empty()) backends.push_back(config.backend);
+	std::vector<RunResolution> resolutions = config.resolutions;
+	if (resolutions.empty()) {
+		RunResolution resolution;
+		resolution.width = config.width;
+		resolution.height = config.height;
+		resolutions.push_back(resolution);
+	}
+	std::vector<PresentMode> presentModes = config.presentModes;
+	if (presentModes.empty()) presentModes.push_back(config.presentMode);
+
+	std::vector<SuiteCell> cells;
+	for (RenderBackendType backend : backends) {
+		for (const RunResolution& resolution : resolutions) {
+			for (PresentMode presentMode : presentModes) {
+				SuiteCell cell;
+				cell.backend = backend;
+				cell.resolution = resolution;
+				cell.presentMode = presentMode;
+				cells.push_back(cell);
+			}
+		}
+	}
+	return cells;
+}
+
+RunConfig CellRunConfig(const RunConfig& config, const SuiteCell& cell) {
+	RunConfig cellConfig = config;
+	cellConfig.backends.clear();
+	cellConfig.resolutions.clear();
+	cellConfig.presentModes.clear();
+	cellConfig.backend = cell.backend;
+	cellConfig.presentMode = cell.presentMode;
+	cellConfig.width = cell.resolution.width;
+	cellConfig.height = cell.resolution.height;
+	if (!config.resolutions.empty()) cellConfig.fullscreen = false;
+	return cellConfig;
+}
+
+bool SuiteUsesBackend(const RunConfig& config, RenderBackendType backend) {
+	for (const SuiteCell& cell : BuildSuiteCells(config)) {
+		if (cell.backend == backend) return true;
+	}
+	return false;
+}
+
+int RunBenchmarkSuite(const RunConfig& config, const SuiteCellRunner& runCell, std::vector<RunStepResult>& results, std::string& error) {
+	results.clear();
+	int exitCode = kRunExitOk;
+	if (!config.tracePath.empty()) Tracer::Instance().Start();
+	std::vector<SuiteCell> cells = BuildSuiteCells(config);
+	for (size_t i = 0; i < cells.size(); ++i) {
+		RunConfig cellConfig = CellRunConfig(config, cells[i]);
+		if (cells.size() > 1 && !config.frameLogPath.empty()) {
+			cellConfig.frameLogPath = TaggedFrameLogPath(config.frameLogPath, "cell" + std::to_string(i));
+		}
+		std::vector<RunStepResult> cellResults;
+		exitCode = runCell(cellConfig, cellResults, error);
+		results.insert(results.end(), cellResults.begin(), cellResults.end());
+		if (exitCode != kRunExitOk) break;
+	}
+	// The pattern counter is stamped and checked on every frame, so any error is a bug
+	// in the frame path rather than noise, and fails the run.
+	for (const RunStepResult& result : results) {
+		if (exitCode != kRunExitOk) break;
+		if (result.pattern.frames == 0 || PatternCheckPassed(result.pattern)) continue;
+		error = "test pattern errors at " + std::to_string(result.targetFps) + " fps on output " + std::to_string(result.output) + ": " + FormatPatternCheck(result.pattern);
+		exitCode = kRunExitPatternFailed;
+	}
+
+	// Partial results are still worth keeping when a cell fails or is aborted.
+	std::string statsError;
+	if (!config.statsPath.empty() && !WriteRunStats(config.statsPath, results, statsError)) {
+		if (exitCode == kRunExitOk) {
+			error = statsError;
+			exitCode = kRunExitStatsFailed;
+		}
+	}
+	if (!config.tracePath.empty()) {
+		Tracer::Instance().Stop();
+		if (!Tracer::Instance().WriteChromeTrace(config.tracePath, statsError) && exitCode == kRunExitOk) {
+			error = statsError;
+			exitCode = kRunExitStatsFailed;
+		}
+	}
+	return exitCode;
+}
+
+int RunHeadlessCell(const RunConfig& config, std::vector<RunStepResult>& results, std::string& error) {
+	if (!config.outputs.empty()) return RunHeadlessMultiOutput(config, results, error);
+	return RunHeadlessBenchmark(config, results, error);
+}
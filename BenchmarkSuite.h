@@ -0,0 +1,30 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "BenchmarkRun.h"
+#include "RunConfig.h"
+
+struct SuiteCell {
+	RenderBackendType backend = RenderBackendType::D3D11;
+	RunResolution resolution;
+	PresentMode presentMode = PresentMode::VSync;
+};
+
+// Runs one cell's config (all of its target FPS steps); returns a RunExitCode.
+typedef std::function<int(const RunConfig&, std::vector<RunStepResult>&, std::string&)> SuiteCellRunner;
+
+// Expands the suite matrix; unset axes fall back to the single-run values.
+std::vector<SuiteCell> BuildSuiteCells(const RunConfig& config);
+RunConfig CellRunConfig(const RunConfig& config, const SuiteCell& cell);
+bool SuiteUsesBackend(const RunConfig& config, RenderBackendType backend);
+
+// Runs every cell in order, stopping at the first failure, then writes the report to
+// config.statsPath and the capture to config.tracePath. A plain unattended run is the
+// one-cell case; with several cells each logs frames to its own file, numbered in
+// matrix order ("frames.cell0.bin", "frames.cell1.bin", ...). A step whose test pattern
+// check saw undecoded, dropped, repeated or reordered frames fails the run.
+int RunBenchmarkSuite(const RunConfig& config, const SuiteCellRunner& runCell, std::vector<RunStepResult>& results, std::string& error);
+// Runs a headless cell: one backend, or one per output when config.outputs is set.
+int RunHeadlessCell(const RunConfig& config, std::vector<RunStepResult>& results, std::string& error);
@@ -2,13 +2,42 @@
 #include <d3d11.h>
 #include <dxgi.h>
 #include <string>
+#include <cstdio>
 #include <gdiplus.h>
 #include <commctrl.h>
 #include <vector>
 #include <numeric>
 #include <olectl.h>
 #include <timeapi.h>
+#include <memory>
+#include <shellapi.h>
 #include "resource.h"
+#include "AdaptiveFpsController.h"
+#include "BackendCache.h"
+#include "BenchmarkRun.h"
+#include "BenchmarkSuite.h"
+#include "D3D11Backend.h"
+#include "EnumerationCache.h"
+#include "FrameClock.h"
+#include "FrameLogWriter.h"
+#include "FrameLoop.h"
+#include "FrameScheduler.h"
+#include "FrameStatistics.h"
+#include "LatencyProbe.h"
+#include "HeadlessBackend.h"
+#include "LoadGenerator.h"
+#include "MemoryStream.h"
+#include "MultiOutputRun.h"
+#include "PresentPolicy.h"
+#include "RenderBackend.h"
+#include "RenderThread.h"
+#include "ResizeCoalescer.h"
+#include "RunConfig.h"
+#include "StartupTasks.h"
+#include "TestPattern.h"
+#include "TimerResolution.h"
+#include "Tracer.h"
+#include "UiResourceCache.h"
 
 #pragma comment(lib, "d3d11.lib")
 #pragma comment(lib, "dxgi.lib")
@@ -17,6 +46,7 @@
 #pragma comment(lib, "comctl32.lib")
 #pragma comment(lib, "Ole32.lib")
 #pragma comment(lib, "winmm.lib")
+#pragma comment(lib, "shell32.lib")
 
 #define IDC_CLOSE_BUTTON 101
 #define IDC_LOGO_STATIC 102
@@ -29,34 +59,47 @@
 #define IDC_CLOSE_SETTINGS_BUTTON 109
 #define IDC_FULLSCREEN_CHECKBOX 111
 #define IDI_APPICON 112
+#define IDC_PRESENT_COMBO 113
+#define IDC_PRESENT_LABEL 114
+#define IDC_FRAMELOG_CHECKBOX 115
+#define IDC_LOAD_LABEL 116
+#define IDC_PASSES_LABEL 117
+
+#define WM_RENDER_STOPPED (WM_APP + 1)
 
 struct AdapterOutputPair {
 	IDXGIAdapter* pAdapter;
 	IDXGIOutput* pOutput;
 };
 
-ID3D11Device* g_pDevice = nullptr;
-ID3D11DeviceContext* g_pDeviceContext = nullptr;
-IDXGISwapChain* g_pSwapChain = nullptr;
-ID3D11RenderTargetView* g_pRenderTargetView = nullptr;
+// One DXGI factory's view of the adapters and their outputs.
+struct DisplayTopology {
+	IDXGIFactory1* pFactory = nullptr;
+	std::vector<IDXGIAdapter*> adapters;
+	std::vector<AdapterOutputPair> outputs;
+};
+
+BackendCacheHooks MakeBackendCacheHooks();
+
+RenderBackend* g_pRenderBackend = nullptr;
+BackendCache g_backendCache(MakeBackendCacheHooks());
+BackendReuse g_lastBackendReuse = BackendReuse::Rebuild;
+RenderBackendType g_renderBackendType = RenderBackendType::D3D11;
 
 IDXGIAdapter* g_pSelectedAdapter = nullptr;
 IDXGIAdapter* g_pDisplayAdapter = nullptr;
 IDXGIOutput* g_pSelectedOutput = nullptr;
-std::vector<IDXGIAdapter*> g_vAdapters;
-std::vector<AdapterOutputPair> g_vOutputs;
-
-bool g_isMultiGpu = false;
-ID3D11Device* g_pProcessingDevice = nullptr;
-ID3D11DeviceContext* g_pProcessingDeviceContext = nullptr;
-ID3D11Texture2D* g_pSharedTexture = nullptr;
-ID3D11RenderTargetView* g_pSharedRTV = nullptr;
+// Enumerated once and reused by every settings window until the topology changes.
+EnumerationCache<DisplayTopology> g_displayTopology;
 
-HWND g_hRenderWnd;
+HWND g_hRenderWnd = nullptr;
+IDXGIOutput* g_pRenderWindowOutput = nullptr;
+bool g_renderWindowBorderless = false;
 HFONT g_hUiFont = nullptr;
 HFONT g_hAuthorFont = nullptr;
 HWND g_hGpuCombo = nullptr;
 HWND g_hOutputCombo = nullptr;
+HWND g_hPresentCombo = nullptr;
 
 ULONG_PTR g_gdiplusToken;
 Gdiplus::Bitmap* g_pLogoBitmap = nullptr;
@@ -65,51 +108,141 @@ HBRUSH g_hbrGlow = nullptr;
 HBRUSH g_hbrWhite = nullptr;
 HBRUSH g_hbrBackground = nullptr;
 
+// Render window client size. UI thread only: the render thread gets sizes through the
+// payload of Resize commands.
 int g_currentWidth = 800;
 int g_currentHeight = 600;
 int g_targetFPS = 60;
 bool g_settingsConfirmed = false;
 bool g_borderlessFullscreen = true;
-bool g_resizeRequested = false;
-
+CatchUpPolicy g_catchUpPolicy = CatchUpPolicy::Skip;
+FrameLogWriter g_frameLog;
+// Opt-in from the settings window; empty leaves interactive sessions unlogged.
+const char* const kInteractiveFrameLogPath = "CustomFPS_frames.bin";
+std::string g_frameLogPath;
+LoadConfig g_loadConfig;
+PresentMode g_presentMode = PresentMode::VSync;
+PresentPlan g_presentPlan;
+RenderThread* g_pRenderThread = nullptr;
+RenderThreadConfig g_renderThreadConfig;
+FrameClock* g_pFrameClock = nullptr;
+MultiOutputRun* g_pMultiOutputRun = nullptr;
+bool g_showOverlay = true;
+std::vector<int> g_latencySweepFps = { 30, 60, 120, 144, 240 };
+uint64_t g_latencySamplesPerStep = 100;
+
+void RegisterRenderWindowClass(HINSTANCE hInstance);
 void InitRenderWindow(HINSTANCE hInstance);
 LRESULT CALLBACK RenderWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
-void InitD3D();
-void RenderFrame();
-void CleanupD3D();
-void CreateRenderTarget();
-void CleanupRenderTarget();
-void UpdateWindowSize(int width, int height);
-void CleanupSharedResources();
-bool CreateSharedResources(int width, int height);
+bool InitRenderBackend();
+void CleanupRenderBackend();
+void PostRenderCommand(RenderCommandType type, int width = 0, int height = 0);
+void ApplyPendingResize(ResizeCoalescer& resizes, FrameClock& clock);
+std::string FormatResizeStats(const ResizeCoalescer& resizes);
+int GetOutputRefreshRate(IDXGIOutput* pOutput);
 
 void InitInputWindow(HINSTANCE hInstance);
 LRESULT CALLBACK InputWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
 bool LoadLogoImage();
 LRESULT CALLBACK EditProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
-void EnumerateAdapters();
-void EnumerateOutputs(HWND hWidthEdit, HWND hHeightEdit);
+void RefreshDisplayTopology();
+void EnumerateDisplayTopology(DisplayTopology& topology);
+void ReleaseDisplayTopology(DisplayTopology& topology);
+void PopulateOutputCombo(HWND hWidthEdit, HWND hHeightEdit);
 void UpdateResolutionFields(HWND hWidthEdit, HWND hHeightEdit, int outputIndex);
 void ToggleResolutionControls(HWND hWnd, bool show);
 
+std::vector<std::string> GetCommandLineArgs();
+int RunUnattendedSuite(HINSTANCE hInstance, const RunConfig& config);
+int RunUnattendedSession(HINSTANCE hInstance, const RunConfig& config, std::vector<RunStepResult>& results, std::string& error);
+int RunMultiOutputSession(HINSTANCE hInstance, const RunConfig& config, std::vector<RunStepResult>& results, std::string& error);
+void LogRunMessage(const std::string& message);
+void LogTraceCapture(const RunConfig& config);
+void LogGpuTimings(const D3D11Backend& backend, const std::string& label);
+
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int)
 {
-	Gdiplus::GdiplusStartupInput gdiplusStartupInput;
-	Gdiplus::GdiplusStartup(&g_gdiplusToken, &gdiplusStartupInput, NULL);
+	TRACE_THREAD_NAME("ui");
+	RunConfig runConfig;
+	std::string runError;
+	if (!ParseRunArguments(GetCommandLineArgs(), runConfig, runError)) {
+		LogRunMessage(runError);
+		return kRunExitUsage;
+	}
+	if (runConfig.showHelp) {
+		MessageBoxA(NULL, RunUsage(), "CustomFPS", MB_ICONINFORMATION | MB_OK);
+		return kRunExitOk;
+	}
+	if (!runConfig.checkCapturePath.empty()) {
+		TestPatternConfig patternConfig = runConfig.pattern;
+		if (!patternConfig.Enabled()) patternConfig.barcode = true;
+		TestPatternDecoder decoder(patternConfig);
+		bool ok = CheckPatternCapture(runConfig.checkCapturePath, runConfig.width, runConfig.height, decoder, runError);
+		LogRunMessage("capture " + FormatPatternCheck(decoder.Stats()));
+		if (!ok) LogRunMessage(runError);
+		if (!ok) return kRunExitInitFailed;
+		return PatternCheckPassed(decoder.Stats()) ? kRunExitOk : kRunExitPatternFailed;
+	}
+	if (runConfig.unattended && !SuiteUsesBackend(runConfig, RenderBackendType::D3D11)) {
+		std::vector<RunStepResult> results;
+		int exitCode = kRunExitOk;
+		{
+			TimerResolutionScope timerResolution;
+			exitCode = RunBenchmarkSuite(runConfig, RunHeadlessCell, results, runError);
+		}
+		for (const RunStepResult& result : results) LogRunMessage(FormatRunStep(result));
+		LogTraceCapture(runConfig);
+		if (exitCode != kRunExitOk) LogRunMessage(runError);
+		return exitCode;
+	}
+
+	// GDI+ and the logo decode run alongside adapter/output enumeration; the main
+	// thread only waits once it has nothing else to do. Unattended runs skip the logo.
+	SystemClock startupClock;
+	int64_t startupStart = startupClock.Now();
+	bool logoLoaded = false;
+	{
+		StartupTasks startup(startupClock);
+		int gdiplus = startup.Add("gdiplus", []() {
+			Gdiplus::GdiplusStartupInput gdiplusStartupInput;
+			return Gdiplus::GdiplusStartup(&g_gdiplusToken, &gdiplusStartupInput, NULL) == Gdiplus::Ok;
+		});
+		int logo = runConfig.unattended ? -1 : startup.Add("logo", LoadLogoImage, { gdiplus });
+		startup.Add("enumerate", []() {
+			RefreshDisplayTopology();
+			return !g_displayTopology.Current().adapters.empty();
+		});
+		startup.Start();
+		startup.RunInline("wait", [&startup]() { return startup.WaitAll(); });
+		logoLoaded = startup.Wait(logo);
+		LogRunMessage("startup " + FormatStartupPhases(startup.Phases()));
+	}
 
-	if (!LoadLogoImage()) {
+	if (!runConfig.unattended && !logoLoaded) {
 		MessageBox(NULL, L"Could not load logo from resources.", L"Error", MB_ICONERROR | MB_OK);
 		return 1;
 	}
-	EnumerateAdapters();
-
-	timeBeginPeriod(1);
 
+	int exitCode = kRunExitOk;
+	bool settingsShown = false;
+	FrameStatistics restartLatency;
 	while (true)
 	{
+		if (runConfig.unattended) {
+			exitCode = RunUnattendedSuite(hInstance, runConfig);
+			break;
+		}
+
 		g_settingsConfirmed = false;
 		InitInputWindow(hInstance);
+		if (!settingsShown) {
+			char shown[64];
+			snprintf(shown, sizeof(shown), "startup settings window after %.2f ms",
+				static_cast<double>(startupClock.Now() - startupStart) * 1000.0 / static_cast<double>(startupClock.Frequency()));
+			LogRunMessage(shown);
+			settingsShown = true;
+		}
 
 		MSG inputMsg = { 0 };
 		while (GetMessage(&inputMsg, nullptr, 0, 0))
@@ -121,86 +254,491 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE, LPSTR, int)
 		if (!g_settingsConfirmed) {
 			break;
 		}
+		// Raised for this render session only; the settings window runs at the default rate.
+		TimerResolutionScope timerResolution;
 
+		// Restart latency: settings confirmed -> first frame presented.
+		SystemClock frameClock;
+		int64_t restartStart = frameClock.Now();
 		InitRenderWindow(hInstance);
-		InitD3D();
+		if (!InitRenderBackend()) {
+			MessageBox(NULL, L"Could not create the render device.", L"Error", MB_ICONERROR | MB_OK);
+			continue;
+		}
 
-		LARGE_INTEGER frequency, startTime, currentTime;
-		QueryPerformanceFrequency(&frequency);
-		QueryPerformanceCounter(&startTime);
+		std::unique_ptr<FrameLoop> frameLoop = std::make_unique<FrameLoop>(*g_pRenderBackend, frameClock, g_presentPlan.targetFps, g_catchUpPolicy);
+		frameLoop->SetCpuLimiter(g_presentPlan.useCpuLimiter);
+		if (!g_frameLogPath.empty() && g_frameLog.Open(g_frameLogPath, FrameLogFormatForPath(g_frameLogPath), frameClock.Frequency())) {
+			frameLoop->SetFrameLog(&g_frameLog);
+		}
+		LoadGenerator loadGenerator(frameClock);
+		loadGenerator.Configure(g_loadConfig);
+		frameLoop->SetLoadGenerator(&loadGenerator);
+		LatencyProbe latencyProbe(frameClock);
+		LatencySweep latencySweep;
+		AdaptiveFpsController maxFpsSearch(frameClock.Frequency());
+		frameLoop->SetLatencyProbe(&latencyProbe);
+		PerfOverlay overlay(frameClock.Frequency());
+		if (g_showOverlay) frameLoop->SetOverlay(&overlay);
+		ResizeCoalescer resizes(frameClock.Frequency());
+		resizes.SetCurrent(g_currentWidth, g_currentHeight);
+		// Barcode and moving bar only: a full-screen colour cycle is too harsh to switch on by hand.
+		TestPatternConfig patternConfig;
+		patternConfig.barcode = true;
+		patternConfig.movingBar = true;
+		TestPattern testPattern(patternConfig);
+
+		// Everything below runs on the render thread; the UI thread only posts commands.
+		auto onCommand = [&](const RenderCommand& command) {
+			switch (command.type) {
+			case RenderCommandType::Resize:
+				resizes.Request(command.width, command.height, frameClock.Now());
+				break;
+			case RenderCommandType::ToggleOverlay:
+				g_showOverlay = !g_showOverlay;
+				frameLoop->SetOverlay(g_showOverlay ? &overlay : nullptr);
+				break;
+			case RenderCommandType::StartLatencySweep:
+				// Sweeps fire synthetic inputs and pace with the CPU limiter so every step hits its target.
+				maxFpsSearch.Stop();
+				latencySweep.Start(g_latencySweepFps, g_latencySamplesPerStep);
+				latencyProbe.Reset();
+				latencyProbe.SetAutoTrigger(frameClock.Frequency() / 8);
+				frameLoop->SetCpuLimiter(true);
+				frameLoop->Scheduler().SetTargetFps(latencySweep.CurrentFps(), frameClock.Now());
+				break;
+			case RenderCommandType::StartMaxFpsSearch:
+				if (!latencySweep.Active()) {
+					maxFpsSearch.Start();
+					frameLoop->SetCpuLimiter(true);
+					frameLoop->Scheduler().SetTargetFps(maxFpsSearch.TargetFps(), frameClock.Now());
+				}
+				break;
+			case RenderCommandType::ToggleTestPattern:
+				frameLoop->SetTestPattern(frameLoop->Pattern() ? nullptr : &testPattern);
+				break;
+			case RenderCommandType::Input:
+				latencyProbe.OnInput(command.timestamp);
+				break;
+			}
+		};
 
-		double targetFrameTime = 1.0 / g_targetFPS;
+		auto onFrame = [&]() {
+			ApplyPendingResize(resizes, frameClock);
+			const FrameRecord& record = frameLoop->RunFrame();
 
-		MSG renderMsg = { 0 };
-		while (renderMsg.message != WM_QUIT)
-		{
-			if (PeekMessage(&renderMsg, NULL, 0U, 0U, PM_REMOVE))
+			if (restartStart != 0)
 			{
-				TranslateMessage(&renderMsg);
-				DispatchMessage(&renderMsg);
+				if (restartLatency.Count() == 0) restartLatency.Reset(frameClock.Frequency());
+				restartLatency.Add(record.present - restartStart);
+				char restart[128];
+				snprintf(restart, sizeof(restart), "CustomFPS restart: %s in %.2f ms\n", BackendReuseName(g_lastBackendReuse),
+					static_cast<double>(record.present - restartStart) * 1000.0 / static_cast<double>(frameClock.Frequency()));
+				OutputDebugStringA(restart);
+				restartStart = 0;
 			}
-			else
+
+			if (maxFpsSearch.AddFrame(record.interval))
 			{
-				if (g_resizeRequested)
-				{
-					UpdateWindowSize(g_currentWidth, g_currentHeight);
-					g_resizeRequested = false;
+				std::string probe = "CustomFPS find-max: " + FormatAdaptiveProbe(maxFpsSearch.Probes().back()) + "\n";
+				OutputDebugStringA(probe.c_str());
+				if (!maxFpsSearch.Done()) {
+					frameLoop->Scheduler().SetTargetFps(maxFpsSearch.TargetFps(), frameClock.Now());
 				}
+				else {
+					std::string best = "CustomFPS find-max: highest sustainable rate " + std::to_string(maxFpsSearch.BestFps()) + " fps\n";
+					OutputDebugStringA(best.c_str());
+					frameLoop->SetCpuLimiter(g_presentPlan.useCpuLimiter);
+					frameLoop->Scheduler().SetTargetFps(g_presentPlan.targetFps, frameClock.Now());
+				}
+			}
 
-				QueryPerformanceCounter(&currentTime);
-				double elapsed = static_cast<double>(currentTime.QuadPart - startTime.QuadPart) / frequency.QuadPart;
-
-				if (elapsed >= targetFrameTime)
-				{
-					RenderFrame();
-					startTime = currentTime;
+			if (latencySweep.Update(latencyProbe))
+			{
+				std::string step = "CustomFPS latency: " + FormatLatencySummary(latencySweep.Results().back()) + "\n";
+				OutputDebugStringA(step.c_str());
+				if (latencySweep.Active()) {
+					frameLoop->Scheduler().SetTargetFps(latencySweep.CurrentFps(), frameClock.Now());
 				}
-				else
-				{
-					Sleep(0);
+				else {
+					latencyProbe.SetAutoTrigger(0);
+					frameLoop->SetCpuLimiter(g_presentPlan.useCpuLimiter);
+					frameLoop->Scheduler().SetTargetFps(g_presentPlan.targetFps, frameClock.Now());
 				}
 			}
+			return true;
+		};
+
+		RenderThread renderThread;
+		g_pFrameClock = &frameClock;
+		g_pRenderThread = &renderThread;
+		frameLoop->Start();
+		renderThread.Start(g_renderThreadConfig, onCommand, onFrame, []() { PostMessage(g_hRenderWnd, WM_RENDER_STOPPED, 0, 0); });
+
+		MSG renderMsg = { 0 };
+		while (GetMessage(&renderMsg, nullptr, 0, 0))
+		{
+			TRACE_ZONE("dispatch message");
+			TranslateMessage(&renderMsg);
+			DispatchMessage(&renderMsg);
+		}
+		renderThread.RequestStop();
+		renderThread.Join();
+		g_pRenderThread = nullptr;
+		g_pFrameClock = nullptr;
+		std::string resizeStats = "CustomFPS resize: " + FormatResizeStats(resizes) + "\n";
+		OutputDebugStringA(resizeStats.c_str());
+		std::string timer = "CustomFPS timer: " + FormatTimerCalibration(frameLoop->Pacer().Calibration(), frameClock.Frequency()) + "\n";
+		OutputDebugStringA(timer.c_str());
+		g_frameLog.Close();
+
+		std::string summary = "CustomFPS: " + FormatFrameSummary(frameLoop->Statistics().Summary());
+		if (!g_frameLogPath.empty()) summary += " logged=" + std::to_string(g_frameLog.Written()) + " dropped=" + std::to_string(g_frameLog.Dropped());
+		summary += "\n";
+		OutputDebugStringA(summary.c_str());
+		if (overlay.Cost().Count() > 0) {
+			std::string overlayCost = "CustomFPS overlay: " + FormatFrameSummary(overlay.Cost().Summary()) + "\n";
+			OutputDebugStringA(overlayCost.c_str());
+		}
+		if (!latencySweep.Active() && latencyProbe.Samples() > 0) {
+			std::string latency = "CustomFPS latency: " + FormatLatencySummary(latencyProbe.Summary(g_presentPlan.targetFps)) + "\n";
+			OutputDebugStringA(latency.c_str());
 		}
-		CleanupD3D();
 	}
 
+	if (restartLatency.Count() > 0) {
+		const BackendCacheStats& cacheStats = g_backendCache.Stats();
+		char cache[256];
+		snprintf(cache, sizeof(cache), "CustomFPS backend cache: rebuilds=%llu swap-chain=%llu resizes=%llu reuses=%llu restart mean=%.2f ms max=%.2f ms\n",
+			static_cast<unsigned long long>(cacheStats.rebuilds), static_cast<unsigned long long>(cacheStats.swapChainResets),
+			static_cast<unsigned long long>(cacheStats.resizes), static_cast<unsigned long long>(cacheStats.reuses),
+			restartLatency.MeanMs(), restartLatency.Summary().maxMs);
+		OutputDebugStringA(cache);
+	}
+	CleanupRenderBackend();
+	if (g_hbrBackground) { DeleteObject(g_hbrBackground); g_hbrBackground = nullptr; }
+
 	if (g_pLogoBitmap) delete g_pLogoBitmap;
 	Gdiplus::GdiplusShutdown(g_gdiplusToken);
 	UnregisterClass(L"D3DRenderWindowClass", hInstance);
 	UnregisterClass(L"SageInputWindow", hInstance);
-	for (auto& adapter : g_vAdapters) {
-		adapter->Release();
+	g_displayTopology.Clear(ReleaseDisplayTopology);
+
+	return exitCode;
+}
+
+std::vector<std::string> GetCommandLineArgs() {
+	std::vector<std::string> args;
+	int argc = 0;
+	LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+	if (!argv) return args;
+	for (int i = 1; i < argc; ++i) {
+		int size = WideCharToMultiByte(CP_UTF8, 0, argv[i], -1, nullptr, 0, nullptr, nullptr);
+		std::string arg(size > 0 ? size - 1 : 0, '\0');
+		if (size > 1) WideCharToMultiByte(CP_UTF8, 0, argv[i], -1, &arg[0], size, nullptr, nullptr);
+		args.push_back(arg);
 	}
-	g_vAdapters.clear();
+	LocalFree(argv);
+	return args;
+}
+
+void LogRunMessage(const std::string& message) {
+	std::string line = "CustomFPS: " + message + "\n";
+	OutputDebugStringA(line.c_str());
+}
+
+void LogGpuTimings(const D3D11Backend& backend, const std::string& label) {
+	if (!backend.RenderTimeline()) return;
+	LogRunMessage(label + (backend.DisplayTimeline() ? " render " : " ") + FormatGpuTimings(*backend.RenderTimeline()));
+	if (backend.DisplayTimeline()) LogRunMessage(label + " display " + FormatGpuTimings(*backend.DisplayTimeline()));
+}
+
+// Zone totals of the capture, then the per-zone cost measured once the capture is over.
+void LogTraceCapture(const RunConfig& config) {
+	if (config.tracePath.empty()) return;
+	Tracer& tracer = Tracer::Instance();
+	LogRunMessage("trace " + config.tracePath + ": " + FormatTraceSummary(tracer.Summarize()) + " dropped=" + std::to_string(tracer.DroppedEvents()));
+	LogRunMessage("trace overhead " + FormatTraceOverhead(tracer.MeasureOverhead(100000)));
+}
+
+int RunUnattendedSuite(HINSTANCE hInstance, const RunConfig& config) {
+	std::vector<RunStepResult> results;
+	std::string error;
+	TimerResolutionScope timerResolution;
+	LogRunMessage(timerResolution.PeriodMs() ? "timer period raised to " + std::to_string(timerResolution.PeriodMs()) + " ms" : std::string("timer high-resolution waitable timer"));
+	int exitCode = RunBenchmarkSuite(config, [hInstance](const RunConfig& cellConfig, std::vector<RunStepResult>& cellResults, std::string& cellError) {
+		if (cellConfig.backend == RenderBackendType::Headless) return RunHeadlessCell(cellConfig, cellResults, cellError);
+		if (!cellConfig.outputs.empty()) return RunMultiOutputSession(hInstance, cellConfig, cellResults, cellError);
+		return RunUnattendedSession(hInstance, cellConfig, cellResults, cellError);
+	}, results, error);
+
+	for (const RunStepResult& result : results) LogRunMessage(FormatRunStep(result));
+	LogTraceCapture(config);
+	if (exitCode != kRunExitOk) LogRunMessage(error);
+	return exitCode;
+}
 
-	for (auto& pair : g_vOutputs) {
-		pair.pOutput->Release();
+int RunUnattendedSession(HINSTANCE hInstance, const RunConfig& config, std::vector<RunStepResult>& results, std::string& error) {
+	RefreshDisplayTopology();
+	const DisplayTopology& topology = g_displayTopology.Current();
+	if (static_cast<size_t>(config.adapterIndex) >= topology.adapters.size() || static_cast<size_t>(config.outputIndex) >= topology.outputs.size()) {
+		error = "adapter or output index out of range";
+		return kRunExitInitFailed;
 	}
-	g_vOutputs.clear();
 
-	timeEndPeriod(1);
+	g_pSelectedAdapter = topology.adapters[config.adapterIndex];
+	g_pDisplayAdapter = topology.outputs[config.outputIndex].pAdapter;
+	g_pSelectedOutput = topology.outputs[config.outputIndex].pOutput;
+	g_borderlessFullscreen = config.fullscreen;
+	if (!config.fullscreen && config.width > 0 && config.height > 0) {
+		g_currentWidth = config.width;
+		g_currentHeight = config.height;
+	}
+	g_targetFPS = config.targetFps.empty() ? g_targetFPS : config.targetFps.front();
+	g_presentMode = config.presentMode;
+	g_catchUpPolicy = config.catchUpPolicy;
+
+	InitRenderWindow(hInstance);
+	if (!InitRenderBackend()) {
+		error = "render backend init failed";
+		CleanupRenderBackend();
+		return kRunExitInitFailed;
+	}
+	LogRunMessage(std::string("backend ") + BackendReuseName(g_lastBackendReuse));
+	RunConfig sessionConfig = config;
+	sessionConfig.width = g_currentWidth;
+	sessionConfig.height = g_currentHeight;
+
+	SystemClock frameClock;
+	FrameLoop frameLoop(*g_pRenderBackend, frameClock, g_presentPlan.targetFps, g_catchUpPolicy);
+	FrameLogWriter frameLog;
+	if (!config.frameLogPath.empty()) {
+		if (frameLog.Open(config.frameLogPath, FrameLogFormatForPath(config.frameLogPath), frameClock.Frequency())) {
+			frameLoop.SetFrameLog(&frameLog);
+		}
+	}
 
-	return 0;
+	int refreshRate = GetOutputRefreshRate(g_pSelectedOutput);
+	bool tearingSupported = D3D11Backend::IsTearingSupported(g_pDisplayAdapter);
+	D3D11Backend* pBackend = static_cast<D3D11Backend*>(g_pRenderBackend);
+	if (config.gpuTiming && !pBackend->EnableGpuTimestamps(frameClock.Frequency())) LogRunMessage("gpu timestamps unavailable");
+	LoadGenerator loadGenerator(frameClock);
+	loadGenerator.Configure(config.load);
+	frameLoop.SetLoadGenerator(&loadGenerator);
+	PerfOverlay overlay(frameClock.Frequency());
+	if (config.overlay) frameLoop.SetOverlay(&overlay);
+	TestPattern testPattern(config.pattern);
+	if (config.pattern.Enabled()) frameLoop.SetTestPattern(&testPattern);
+
+	BenchmarkRun run(frameLoop, sessionConfig);
+	run.SetStepHandler([&](int targetFps) {
+		PresentPlan plan = PlanPresent(g_presentMode, targetFps, refreshRate, tearingSupported);
+		pBackend->SetPresentPlan(plan);
+		frameLoop.SetCpuLimiter(plan.useCpuLimiter);
+		return plan.targetFps;
+	});
+	run.Start();
+
+	ResizeCoalescer resizes(frameClock.Frequency());
+	resizes.SetCurrent(g_currentWidth, g_currentHeight);
+	auto onCommand = [&](const RenderCommand& command) {
+		if (command.type == RenderCommandType::Resize) resizes.Request(command.width, command.height, frameClock.Now());
+	};
+	auto onFrame = [&]() {
+		ApplyPendingResize(resizes, frameClock);
+		return run.Tick();
+	};
+	RenderThread renderThread;
+	g_pFrameClock = &frameClock;
+	g_pRenderThread = &renderThread;
+	renderThread.Start(config.renderThread, onCommand, onFrame, []() { PostMessage(g_hRenderWnd, WM_RENDER_STOPPED, 0, 0); });
+
+	MSG renderMsg = { 0 };
+	while (GetMessage(&renderMsg, nullptr, 0, 0))
+	{
+		TRACE_ZONE("dispatch message");
+		TranslateMessage(&renderMsg);
+		DispatchMessage(&renderMsg);
+	}
+	renderThread.RequestStop();
+	renderThread.Join();
+	g_pRenderThread = nullptr;
+	g_pFrameClock = nullptr;
+	LogRunMessage("resize " + FormatResizeStats(resizes));
+	LogRunMessage("timer " + FormatTimerCalibration(frameLoop.Pacer().Calibration(), frameClock.Frequency()));
+	LogGpuTimings(*pBackend, "gpu");
+	pBackend->DisableGpuTimestamps();
+	frameLog.Close();
+
+	for (const AdaptiveProbe& probe : run.Search().Probes()) LogRunMessage("find-max " + FormatAdaptiveProbe(probe));
+	results = run.Results();
+	if (!run.Finished()) {
+		error = "run aborted";
+		return kRunExitAborted;
+	}
+	return kRunExitOk;
 }
 
-void EnumerateAdapters()
-{
-	IDXGIFactory* pFactory = nullptr;
-	CreateDXGIFactory(__uuidof(IDXGIFactory), (void**)&pFactory);
-	if (!pFactory) return;
+// One window, device and render thread per entry in config.outputs. Each output renders
+// on the adapter that drives it, so no frame crosses adapters, and is planned against
+// its own refresh rate.
+int RunMultiOutputSession(HINSTANCE hInstance, const RunConfig& config, std::vector<RunStepResult>& results, std::string& error) {
+	RefreshDisplayTopology();
+	const DisplayTopology& topology = g_displayTopology.Current();
+	for (int outputIndex : config.outputs) {
+		if (static_cast<size_t>(outputIndex) >= topology.outputs.size()) {
+			error = "output index " + std::to_string(outputIndex) + " out of range";
+			return kRunExitInitFailed;
+		}
+	}
+	// A cached single-output window may cover one of these outputs.
+	CleanupRenderBackend();
+	RegisterRenderWindowClass(hInstance);
+
+	struct OutputWindow {
+		HWND hWnd = nullptr;
+		std::unique_ptr<D3D11Backend> backend;
+		std::unique_ptr<SystemClock> clock;
+		int refreshRate = 0;
+		bool tearingSupported = false;
+	};
+	std::vector<OutputWindow> windows(config.outputs.size());
+	MultiOutputRun run(config);
+	bool initOk = true;
+	for (size_t i = 0; i < windows.size() && initOk; ++i) {
+		const AdapterOutputPair& pair = topology.outputs[config.outputs[i]];
+		RunConfig outputConfig = OutputRunConfig(config, i);
+		OutputWindow& window = windows[i];
+		DXGI_OUTPUT_DESC outputDesc;
+		pair.pOutput->GetDesc(&outputDesc);
+		const RECT& desktop = outputDesc.DesktopCoordinates;
+		int x = desktop.left, y = desktop.top;
+		int width = desktop.right - desktop.left, height = desktop.bottom - desktop.top;
+		if (!config.fullscreen) {
+			x += 100;
+			y += 100;
+			width = config.width > 0 ? config.width : 800;
+			height = config.height > 0 ? config.height : 600;
+		}
+
+		window.hWnd = CreateWindow(L"D3DRenderWindowClass", config.fullscreen ? L"" : L"CustomFPS", config.fullscreen ? WS_POPUP | WS_CLIPCHILDREN : WS_OVERLAPPEDWINDOW,
+			x, y, width, height, nullptr, nullptr, hInstance, nullptr);
+		// Every output is part of the measurement, so one that cannot get a window aborts
+		// the run like a failed backend does.
+		if (!window.hWnd) {
+			error = "cannot create the render window for output " + std::to_string(config.outputs[i]);
+			initOk = false;
+			break;
+		}
+		window.refreshRate = GetOutputRefreshRate(pair.pOutput);
+		window.tearingSupported = D3D11Backend::IsTearingSupported(pair.pAdapter);
+		PresentPlan plan = PlanPresent(config.presentMode, outputConfig.targetFps.front(), window.refreshRate, window.tearingSupported);
+		window.backend = std::make_unique<D3D11Backend>(window.hWnd, pair.pAdapter, pair.pAdapter, plan, config.fullscreen);
+		window.clock = std::make_unique<SystemClock>();
+		ShowWindow(window.hWnd, SW_SHOWDEFAULT);
+		UpdateWindow(window.hWnd);
+		if (!window.backend->Init(width, height)) {
+			error = "render backend init failed for output " + std::to_string(config.outputs[i]);
+			initOk = false;
+			break;
+		}
+		if (config.gpuTiming) window.backend->EnableGpuTimestamps(window.clock->Frequency(), "GPU output " + std::to_string(config.outputs[i]));
+
+		run.AddOutput(*window.backend, *window.clock);
+		D3D11Backend* pBackend = window.backend.get();
+		FrameLoop* pLoop = &run.Loop(i);
+		int refreshRate = window.refreshRate;
+		bool tearingSupported = window.tearingSupported;
+		run.Run(i).SetStepHandler([&config, pBackend, pLoop, refreshRate, tearingSupported](int targetFps) {
+			PresentPlan stepPlan = PlanPresent(config.presentMode, targetFps, refreshRate, tearingSupported);
+			pBackend->SetPresentPlan(stepPlan);
+			pLoop->SetCpuLimiter(stepPlan.useCpuLimiter);
+			return stepPlan.targetFps;
+		});
+	}
+
+	int exitCode = kRunExitOk;
+	if (initOk) {
+		HWND hFirstWnd = windows.front().hWnd;
+		g_pMultiOutputRun = &run;
+		if (!run.Start([hFirstWnd]() { PostMessage(hFirstWnd, WM_RENDER_STOPPED, 0, 0); })) {
+			run.RequestStop();
+		}
+
+		MSG renderMsg = { 0 };
+		while (GetMessage(&renderMsg, nullptr, 0, 0))
+		{
+			TRACE_ZONE("dispatch message");
+			TranslateMessage(&renderMsg);
+			DispatchMessage(&renderMsg);
+		}
+		run.RequestStop();
+		run.Join();
+		g_pMultiOutputRun = nullptr;
+
+		results = run.Results();
+		if (!run.Finished()) {
+			error = "run aborted";
+			exitCode = kRunExitAborted;
+		}
+		for (size_t i = 0; i < windows.size(); ++i) LogGpuTimings(*windows[i].backend, "gpu output " + std::to_string(config.outputs[i]));
+	}
+	else {
+		exitCode = kRunExitInitFailed;
+	}
+
+	for (OutputWindow& window : windows) {
+		if (window.backend) window.backend->Cleanup();
+		if (window.hWnd) DestroyWindow(window.hWnd);
+	}
+	return exitCode;
+}
+
+void RefreshDisplayTopology() {
+	// A factory stops being current when adapters come or go; output and mode changes
+	// arrive as WM_DISPLAYCHANGE.
+	const DisplayTopology& topology = g_displayTopology.Current();
+	if (!g_displayTopology.Stale() && (!topology.pFactory || !topology.pFactory->IsCurrent())) {
+		g_displayTopology.Invalidate();
+	}
+	g_displayTopology.Refresh(EnumerateDisplayTopology, ReleaseDisplayTopology);
+}
+
+void EnumerateDisplayTopology(DisplayTopology& topology) {
+	if (FAILED(CreateDXGIFactory1(__uuidof(IDXGIFactory1), (void**)&topology.pFactory))) {
+		topology.pFactory = nullptr;
+		return;
+	}
 
 	IDXGIAdapter* pAdapter;
-	for (UINT i = 0; pFactory->EnumAdapters(i, &pAdapter) != DXGI_ERROR_NOT_FOUND; ++i)
-	{
-		g_vAdapters.push_back(pAdapter);
+	for (UINT i = 0; topology.pFactory->EnumAdapters(i, &pAdapter) != DXGI_ERROR_NOT_FOUND; ++i) {
+		topology.adapters.push_back(pAdapter);
+		IDXGIOutput* pOutput;
+		for (UINT j = 0; pAdapter->EnumOutputs(j, &pOutput) != DXGI_ERROR_NOT_FOUND; ++j) {
+			topology.outputs.push_back({ pAdapter, pOutput });
+		}
 	}
+}
+
+void ReleaseDisplayTopology(DisplayTopology& topology) {
+	// The cached backend and render window are keyed on these pointers; drop them
+	// before the addresses can be handed out again.
+	g_backendCache.Reset();
+	g_pRenderBackend = nullptr;
+	g_pRenderWindowOutput = nullptr;
+	g_pSelectedAdapter = nullptr;
+	g_pDisplayAdapter = nullptr;
+	g_pSelectedOutput = nullptr;
 
-	pFactory->Release();
+	for (AdapterOutputPair& pair : topology.outputs) pair.pOutput->Release();
+	for (IDXGIAdapter* pAdapter : topology.adapters) pAdapter->Release();
+	if (topology.pFactory) topology.pFactory->Release();
 }
 
 void UpdateResolutionFields(HWND hWidthEdit, HWND hHeightEdit, int outputIndex) {
-	if (g_borderlessFullscreen && outputIndex >= 0 && static_cast<size_t>(outputIndex) < g_vOutputs.size()) {
-		IDXGIOutput* pOutput = g_vOutputs[outputIndex].pOutput;
+	const std::vector<AdapterOutputPair>& outputs = g_displayTopology.Current().outputs;
+	if (g_borderlessFullscreen && outputIndex >= 0 && static_cast<size_t>(outputIndex) < outputs.size()) {
+		IDXGIOutput* pOutput = outputs[outputIndex].pOutput;
 		DXGI_OUTPUT_DESC outputDesc;
 		pOutput->GetDesc(&outputDesc);
 		int width = outputDesc.DesktopCoordinates.right - outputDesc.DesktopCoordinates.left;
@@ -210,27 +748,17 @@ void UpdateResolutionFields(HWND hWidthEdit, HWND hHeightEdit, int outputIndex)
 	}
 }
 
-void EnumerateOutputs(HWND hWidthEdit, HWND hHeightEdit) {
-	for (auto& pair : g_vOutputs) {
-		pair.pOutput->Release();
-	}
-	g_vOutputs.clear();
+void PopulateOutputCombo(HWND hWidthEdit, HWND hHeightEdit) {
+	const std::vector<AdapterOutputPair>& outputs = g_displayTopology.Current().outputs;
 	SendMessage(g_hOutputCombo, CB_RESETCONTENT, 0, 0);
-
-	for (IDXGIAdapter* pAdapter : g_vAdapters) {
-		DXGI_ADAPTER_DESC adapterDesc;
-		pAdapter->GetDesc(&adapterDesc);
-		IDXGIOutput* pOutput;
-		for (UINT i = 0; pAdapter->EnumOutputs(i, &pOutput) != DXGI_ERROR_NOT_FOUND; ++i) {
-			g_vOutputs.push_back({ pAdapter, pOutput });
-			DXGI_OUTPUT_DESC outputDesc;
-			pOutput->GetDesc(&outputDesc);
-			std::wstring displayText = L"Display: ";
-			displayText += outputDesc.DeviceName;
-			SendMessage(g_hOutputCombo, CB_ADDSTRING, 0, (LPARAM)displayText.c_str());
-		}
+	for (const AdapterOutputPair& pair : outputs) {
+		DXGI_OUTPUT_DESC outputDesc;
+		pair.pOutput->GetDesc(&outputDesc);
+		std::wstring displayText = L"Display: ";
+		displayText += outputDesc.DeviceName;
+		SendMessage(g_hOutputCombo, CB_ADDSTRING, 0, (LPARAM)displayText.c_str());
 	}
-	if (!g_vOutputs.empty()) {
+	if (!outputs.empty()) {
 		SendMessage(g_hOutputCombo, CB_SETCURSEL, (WPARAM)0, (LPARAM)0);
 		UpdateResolutionFields(hWidthEdit, hHeightEdit, 0);
 	}
@@ -246,7 +774,7 @@ void InitInputWindow(HINSTANCE hInstance) {
 	WNDCLASSEX wc = { sizeof(WNDCLASSEX), CS_HREDRAW | CS_VREDRAW, InputWndProc, 0, 0, hInstance, nullptr, LoadCursor(nullptr, IDC_ARROW), nullptr, nullptr, L"SageInputWindow", nullptr };
 	RegisterClassEx(&wc);
 
-	const int windowHeight = 700;
+	const int windowHeight = 830;
 	HWND hInputWnd = CreateWindowEx(
 		WS_EX_LAYERED,
 		wc.lpszClassName, L"Settings", WS_POPUP | WS_VISIBLE,
@@ -265,7 +793,9 @@ void InitInputWindow(HINSTANCE hInstance) {
 LRESULT CALLBACK InputWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam) {
 	static HFONT hTitleFont, hLabelFont, hButtonFont, hCheckFont, hAuthorFont, hEscFont;
 	static HWND hWidthEdit_Input, hHeightEdit_Input, hFpsEdit_Input, hResLabel;
-	static HWND hFullscreenCheck;
+	static HWND hLoadEdit_Input, hPassesEdit_Input;
+	static HWND hFullscreenCheck, hFrameLogCheck;
+	static UiResourceCache uiResources;
 
 	using namespace Gdiplus;
 
@@ -280,6 +810,9 @@ LRESULT CALLBACK InputWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 
 		g_hbrGlow = CreateSolidBrush(RGB(240, 248, 255));
 		g_hbrWhite = CreateSolidBrush(RGB(255, 255, 255));
+		RECT client;
+		GetClientRect(hWnd, &client);
+		uiResources.Create(client.right, client.bottom);
 
 		HINSTANCE hInstance = (HINSTANCE)GetWindowLongPtr(hWnd, GWLP_HINSTANCE);
 
@@ -287,12 +820,13 @@ LRESULT CALLBACK InputWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 
 		g_hGpuCombo = CreateWindowA("COMBOBOX", "", CBS_DROPDOWNLIST | CBS_HASSTRINGS | WS_CHILD | WS_VISIBLE | CBS_OWNERDRAWFIXED, 50, 150, 300, 300, hWnd, (HMENU)IDC_GPU_COMBO, hInstance, nullptr);
 		SendMessage(g_hGpuCombo, CB_SETITEMHEIGHT, (WPARAM)-1, (LPARAM)28);
-		for (const auto& adapter : g_vAdapters) {
+		RefreshDisplayTopology();
+		for (const auto& adapter : g_displayTopology.Current().adapters) {
 			DXGI_ADAPTER_DESC desc;
 			adapter->GetDesc(&desc);
 			SendMessage(g_hGpuCombo, (UINT)CB_ADDSTRING, (WPARAM)0, (LPARAM)desc.Description);
 		}
-		if (!g_vAdapters.empty()) {
+		if (!g_displayTopology.Current().adapters.empty()) {
 			SendMessage(g_hGpuCombo, CB_SETCURSEL, (WPARAM)0, (LPARAM)0);
 		}
 
@@ -306,47 +840,76 @@ LRESULT CALLBACK InputWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 		hWidthEdit_Input = CreateWindowA("EDIT", "800", WS_CHILD | WS_VISIBLE | WS_BORDER | ES_CENTER | ES_NUMBER, 100, 360, 80, 40, hWnd, (HMENU)1, hInstance, nullptr);
 		hHeightEdit_Input = CreateWindowA("EDIT", "600", WS_CHILD | WS_VISIBLE | WS_BORDER | ES_CENTER | ES_NUMBER, 220, 360, 80, 40, hWnd, (HMENU)2, hInstance, nullptr);
 
-		CreateWindowA("STATIC", "Target FPS", WS_CHILD | WS_VISIBLE | SS_CENTER, 75, 410, 250, 35, hWnd, (HMENU)IDC_FPS_LABEL, hInstance, nullptr);
-		hFpsEdit_Input = CreateWindowA("EDIT", "60", WS_CHILD | WS_VISIBLE | WS_BORDER | ES_NUMBER | ES_CENTER, 150, 450, 100, 40, hWnd, (HMENU)3, hInstance, nullptr);
+		CreateWindowA("STATIC", "Target FPS", WS_CHILD | WS_VISIBLE | SS_CENTER, 40, 410, 140, 35, hWnd, (HMENU)IDC_FPS_LABEL, hInstance, nullptr);
+		hFpsEdit_Input = CreateWindowA("EDIT", "60", WS_CHILD | WS_VISIBLE | WS_BORDER | ES_NUMBER | ES_CENTER, 60, 450, 100, 40, hWnd, (HMENU)3, hInstance, nullptr);
+
+		CreateWindowA("STATIC", "Present Mode", WS_CHILD | WS_VISIBLE | SS_CENTER, 190, 410, 170, 35, hWnd, (HMENU)IDC_PRESENT_LABEL, hInstance, nullptr);
+		g_hPresentCombo = CreateWindowA("COMBOBOX", "", CBS_DROPDOWNLIST | CBS_HASSTRINGS | WS_CHILD | WS_VISIBLE | CBS_OWNERDRAWFIXED, 195, 455, 160, 200, hWnd, (HMENU)IDC_PRESENT_COMBO, hInstance, nullptr);
+		SendMessage(g_hPresentCombo, CB_SETITEMHEIGHT, (WPARAM)-1, (LPARAM)28);
+		SendMessage(g_hPresentCombo, CB_ADDSTRING, 0, (LPARAM)L"VSync");
+		SendMessage(g_hPresentCombo, CB_ADDSTRING, 0, (LPARAM)L"Immediate (tearing)");
+		SendMessage(g_hPresentCombo, CB_ADDSTRING, 0, (LPARAM)L"VRR");
+		SendMessage(g_hPresentCombo, CB_SETCURSEL, (WPARAM)g_presentMode, 0);
+
+		// Synthetic load: busy CPU time and extra render passes per frame, 0 for none.
+		CreateWindowA("STATIC", "CPU Load (us)", WS_CHILD | WS_VISIBLE | SS_CENTER, 30, 500, 160, 35, hWnd, (HMENU)IDC_LOAD_LABEL, hInstance, nullptr);
+		hLoadEdit_Input = CreateWindowA("EDIT", std::to_string(g_loadConfig.cpuMicroseconds).c_str(), WS_CHILD | WS_VISIBLE | WS_BORDER | ES_NUMBER | ES_CENTER, 60, 540, 100, 40, hWnd, (HMENU)4, hInstance, nullptr);
+		CreateWindowA("STATIC", "Render Passes", WS_CHILD | WS_VISIBLE | SS_CENTER, 190, 500, 170, 35, hWnd, (HMENU)IDC_PASSES_LABEL, hInstance, nullptr);
+		hPassesEdit_Input = CreateWindowA("EDIT", std::to_string(g_loadConfig.renderPasses).c_str(), WS_CHILD | WS_VISIBLE | WS_BORDER | ES_NUMBER | ES_CENTER, 225, 540, 100, 40, hWnd, (HMENU)5, hInstance, nullptr);
+
+		hFrameLogCheck = CreateWindowA("BUTTON", "Log Frames to File", WS_CHILD | WS_VISIBLE | BS_AUTOCHECKBOX, 90, 595, 220, 30, hWnd, (HMENU)IDC_FRAMELOG_CHECKBOX, hInstance, nullptr);
+		SendMessage(hFrameLogCheck, BM_SETCHECK, g_frameLogPath.empty() ? BST_UNCHECKED : BST_CHECKED, 0);
 
-		HWND hStartButton = CreateWindowA("BUTTON", "Start Render", WS_CHILD | WS_VISIBLE | BS_OWNERDRAW, 100, 520, 200, 60, hWnd, (HMENU)IDC_START_BUTTON, hInstance, nullptr);
-		HWND hEscText = CreateWindowA("STATIC", "Press 'Esc' to come back to this screen", WS_CHILD | WS_VISIBLE | SS_CENTER, 50, 585, 300, 20, hWnd, (HMENU)IDC_STATIC, hInstance, nullptr);
-		HWND hCloseSettingsButton = CreateWindowA("BUTTON", "Close", WS_CHILD | WS_VISIBLE | BS_OWNERDRAW, 125, 610, 150, 50, hWnd, (HMENU)IDC_CLOSE_SETTINGS_BUTTON, hInstance, nullptr);
-		HWND hSageText = CreateWindowA("STATIC", "- by Sage", WS_CHILD | WS_VISIBLE | SS_CENTER, 150, 665, 100, 25, hWnd, (HMENU)IDC_SAGE_TEXT, hInstance, nullptr);
+		HWND hStartButton = CreateWindowA("BUTTON", "Start Render", WS_CHILD | WS_VISIBLE | BS_OWNERDRAW, 100, 650, 200, 60, hWnd, (HMENU)IDC_START_BUTTON, hInstance, nullptr);
+		HWND hEscText = CreateWindowA("STATIC", "Press 'Esc' to come back to this screen", WS_CHILD | WS_VISIBLE | SS_CENTER, 50, 715, 300, 20, hWnd, (HMENU)IDC_STATIC, hInstance, nullptr);
+		HWND hCloseSettingsButton = CreateWindowA("BUTTON", "Close", WS_CHILD | WS_VISIBLE | BS_OWNERDRAW, 125, 740, 150, 50, hWnd, (HMENU)IDC_CLOSE_SETTINGS_BUTTON, hInstance, nullptr);
+		HWND hSageText = CreateWindowA("STATIC", "- by Sage", WS_CHILD | WS_VISIBLE | SS_CENTER, 150, 795, 100, 25, hWnd, (HMENU)IDC_SAGE_TEXT, hInstance, nullptr);
 
 		SendMessage(g_hGpuCombo, WM_SETFONT, (WPARAM)hCheckFont, TRUE);
 		SendMessage(g_hOutputCombo, WM_SETFONT, (WPARAM)hCheckFont, TRUE);
+		SendMessage(g_hPresentCombo, WM_SETFONT, (WPARAM)hCheckFont, TRUE);
 		SendMessage(hWidthEdit_Input, WM_SETFONT, (WPARAM)hCheckFont, TRUE);
 		SendMessage(hHeightEdit_Input, WM_SETFONT, (WPARAM)hCheckFont, TRUE);
 		SendMessage(hFpsEdit_Input, WM_SETFONT, (WPARAM)hCheckFont, TRUE);
+		SendMessage(hLoadEdit_Input, WM_SETFONT, (WPARAM)hCheckFont, TRUE);
+		SendMessage(hPassesEdit_Input, WM_SETFONT, (WPARAM)hCheckFont, TRUE);
 		SendMessage(hResLabel, WM_SETFONT, (WPARAM)hLabelFont, TRUE);
 		SendMessage(GetDlgItem(hWnd, IDC_FPS_LABEL), WM_SETFONT, (WPARAM)hLabelFont, TRUE);
+		SendMessage(GetDlgItem(hWnd, IDC_PRESENT_LABEL), WM_SETFONT, (WPARAM)hLabelFont, TRUE);
+		SendMessage(GetDlgItem(hWnd, IDC_LOAD_LABEL), WM_SETFONT, (WPARAM)hLabelFont, TRUE);
+		SendMessage(GetDlgItem(hWnd, IDC_PASSES_LABEL), WM_SETFONT, (WPARAM)hLabelFont, TRUE);
 		SendMessage(hStartButton, WM_SETFONT, (WPARAM)hTitleFont, TRUE);
 		SendMessage(hCloseSettingsButton, WM_SETFONT, (WPARAM)hButtonFont, TRUE);
 		SendMessage(hFullscreenCheck, WM_SETFONT, (WPARAM)hCheckFont, TRUE);
+		SendMessage(hFrameLogCheck, WM_SETFONT, (WPARAM)hCheckFont, TRUE);
 		SendMessage(hSageText, WM_SETFONT, (WPARAM)hAuthorFont, TRUE);
 		SendMessage(hEscText, WM_SETFONT, (WPARAM)hEscFont, TRUE);
 
 		g_pOriginalEditProc = (WNDPROC)SetWindowLongPtr(hFpsEdit_Input, GWLP_WNDPROC, (LONG_PTR)EditProc);
 		SetWindowLongPtr(hWidthEdit_Input, GWLP_WNDPROC, (LONG_PTR)EditProc);
 		SetWindowLongPtr(hHeightEdit_Input, GWLP_WNDPROC, (LONG_PTR)EditProc);
+		SetWindowLongPtr(hLoadEdit_Input, GWLP_WNDPROC, (LONG_PTR)EditProc);
+		SetWindowLongPtr(hPassesEdit_Input, GWLP_WNDPROC, (LONG_PTR)EditProc);
 
-		EnumerateOutputs(hWidthEdit_Input, hHeightEdit_Input);
+		PopulateOutputCombo(hWidthEdit_Input, hHeightEdit_Input);
 		ToggleResolutionControls(hWnd, !g_borderlessFullscreen);
 		EnableWindow(hWidthEdit_Input, !g_borderlessFullscreen);
 		EnableWindow(hHeightEdit_Input, !g_borderlessFullscreen);
 
 		break;
 	}
+	case WM_DISPLAYCHANGE:
+		// The open lists keep working; the next settings window re-enumerates.
+		g_displayTopology.Invalidate();
+		break;
 	case WM_PAINT: {
+		int64_t paintStart = uiResources.PaintStart();
 		PAINTSTRUCT ps;
 		HDC hdc = BeginPaint(hWnd, &ps);
 		Graphics graphics(hdc);
-		graphics.SetSmoothingMode(SmoothingModeAntiAlias);
-		Rect rc(0, 0, 400, 700);
-		LinearGradientBrush linGrBrush(rc, Color(255, 33, 150, 243), Color(255, 13, 71, 161), LinearGradientModeVertical);
-		graphics.FillRectangle(&linGrBrush, rc);
+		uiResources.DrawBackground(graphics);
 		EndPaint(hWnd, &ps);
+		uiResources.PaintEnd(paintStart, true);
 		return 1;
 	}
 	case WM_NCHITTEST: {
@@ -356,12 +919,13 @@ LRESULT CALLBACK InputWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 	}
 	case WM_MEASUREITEM: {
 		LPMEASUREITEMSTRUCT lpmis = (LPMEASUREITEMSTRUCT)lParam;
-		if (lpmis->CtlID == IDC_GPU_COMBO || lpmis->CtlID == IDC_OUTPUT_COMBO) {
+		if (lpmis->CtlID == IDC_GPU_COMBO || lpmis->CtlID == IDC_OUTPUT_COMBO || lpmis->CtlID == IDC_PRESENT_COMBO) {
 			lpmis->itemHeight = 30;
 		}
 		return TRUE;
 	}
 	case WM_DRAWITEM: {
+		int64_t paintStart = uiResources.PaintStart();
 		LPDRAWITEMSTRUCT pdis = (LPDRAWITEMSTRUCT)lParam;
 		if (pdis->CtlID == IDC_LOGO_STATIC && g_pLogoBitmap) {
 			Graphics graphics(pdis->hDC);
@@ -375,40 +939,22 @@ LRESULT CALLBACK InputWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 			graphics.SetSmoothingMode(SmoothingModeAntiAlias);
 
 			RectF rect(REAL(pdis->rcItem.left), REAL(pdis->rcItem.top), REAL(pdis->rcItem.right - pdis->rcItem.left), REAL(pdis->rcItem.bottom - pdis->rcItem.top));
-			GraphicsPath path;
-			REAL radius = 15.0f;
-			path.AddArc(rect.X, rect.Y, radius * 2, radius * 2, 180, 90);
-			path.AddArc(rect.GetRight() - (radius * 2), rect.Y, radius * 2, radius * 2, 270, 90);
-			path.AddArc(rect.GetRight() - (radius * 2), rect.GetBottom() - (radius * 2), radius * 2, radius * 2, 0, 90);
-			path.AddArc(rect.X, rect.GetBottom() - (radius * 2), radius * 2, radius * 2, 90, 90);
-			path.CloseFigure();
-
-			Color btnColor = (pdis->itemState & ODS_SELECTED) ? Color(40, 0, 0, 0) : Color(20, 0, 0, 0);
-			SolidBrush fillBrush(btnColor);
-			graphics.FillPath(&fillBrush, &path);
-
-			HFONT hFont = (HFONT)SendMessage(pdis->hwndItem, WM_GETFONT, 0, 0);
-			LOGFONTW lf;
-			GetObjectW(hFont, sizeof(LOGFONTW), &lf);
-			Font gdiplusFont(pdis->hDC, &lf);
-
-			SolidBrush shadowBrush(Color(60, 0, 0, 0));
-			SolidBrush textBrush(Color(255, 255, 255, 255));
-			StringFormat stringFormat;
-			stringFormat.SetAlignment(StringAlignmentCenter);
-			stringFormat.SetLineAlignment(StringAlignmentCenter);
+			const GraphicsPath* pPath = uiResources.ButtonPath(pdis->rcItem.right - pdis->rcItem.left, pdis->rcItem.bottom - pdis->rcItem.top);
+			graphics.TranslateTransform(rect.X, rect.Y);
+			graphics.FillPath(uiResources.ButtonBrush((pdis->itemState & ODS_SELECTED) != 0), pPath);
+			graphics.ResetTransform();
 
+			Font* pFont = uiResources.FontFor(pdis->hDC, (HFONT)SendMessage(pdis->hwndItem, WM_GETFONT, 0, 0));
 			WCHAR buttonText[256];
 			GetWindowTextW(pdis->hwndItem, buttonText, 256);
 
 			RectF shadowRect = rect;
 			shadowRect.X += 1.0f;
 			shadowRect.Y += 1.0f;
-			graphics.DrawString(buttonText, -1, &gdiplusFont, shadowRect, &stringFormat, &shadowBrush);
-			graphics.DrawString(buttonText, -1, &gdiplusFont, rect, &stringFormat, &textBrush);
-
+			graphics.DrawString(buttonText, -1, pFont, shadowRect, uiResources.CenteredFormat(), uiResources.ShadowBrush());
+			graphics.DrawString(buttonText, -1, pFont, rect, uiResources.CenteredFormat(), uiResources.WhiteBrush());
 		}
-		else if (pdis->CtlID == IDC_GPU_COMBO || pdis->CtlID == IDC_OUTPUT_COMBO) {
+		else if (pdis->CtlID == IDC_GPU_COMBO || pdis->CtlID == IDC_OUTPUT_COMBO || pdis->CtlID == IDC_PRESENT_COMBO) {
 			Graphics graphics(pdis->hDC);
 			graphics.SetTextRenderingHint(TextRenderingHintAntiAlias);
 			graphics.SetSmoothingMode(SmoothingModeAntiAlias);
@@ -416,17 +962,14 @@ LRESULT CALLBACK InputWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 			RectF rect(REAL(pdis->rcItem.left), REAL(pdis->rcItem.top), REAL(pdis->rcItem.right - pdis->rcItem.left), REAL(pdis->rcItem.bottom - pdis->rcItem.top));
 
 			if ((pdis->itemState & ODS_SELECTED) && (pdis->itemAction & (ODA_SELECT | ODA_DRAWENTIRE))) {
-				SolidBrush selectedBrush(Color(220, 235, 255));
-				graphics.FillRectangle(&selectedBrush, rect);
+				graphics.FillRectangle(uiResources.SelectedBrush(), rect);
 			}
 			else {
-				SolidBrush backgroundBrush(Color(255, 255, 255, 255));
-				graphics.FillRectangle(&backgroundBrush, rect);
+				graphics.FillRectangle(uiResources.WhiteBrush(), rect);
 			}
 
 			if (pdis->itemState & ODS_FOCUS) {
-				Pen focusPen(Color(100, 33, 150, 243), 2.0f);
-				graphics.DrawRectangle(&focusPen, rect.X, rect.Y, rect.Width - 1, rect.Height - 1);
+				graphics.DrawRectangle(uiResources.FocusPen(), rect.X, rect.Y, rect.Width - 1, rect.Height - 1);
 			}
 
 			WCHAR itemText[256] = L"";
@@ -434,14 +977,10 @@ LRESULT CALLBACK InputWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 				SendMessageW(pdis->hwndItem, CB_GETLBTEXT, pdis->itemID, (LPARAM)itemText);
 			}
 
-			Font font(L"Segoe UI", 16, FontStyleRegular, UnitPixel);
-			SolidBrush textBrush(Color(255, 0, 0, 0));
-			StringFormat stringFormat;
-			stringFormat.SetAlignment(StringAlignmentNear);
-			stringFormat.SetLineAlignment(StringAlignmentCenter);
 			rect.X += 8;
-			graphics.DrawString(itemText, -1, &font, rect, &stringFormat, &textBrush);
+			graphics.DrawString(itemText, -1, uiResources.ComboFont(), rect, uiResources.LeftFormat(), uiResources.BlackBrush());
 		}
+		uiResources.PaintEnd(paintStart, false);
 		return TRUE;
 	}
 	case WM_CTLCOLORSTATIC:
@@ -474,10 +1013,12 @@ LRESULT CALLBACK InputWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 		}
 
 		if (LOWORD(wParam) == IDC_START_BUTTON) {
-			char widthBuf[32], heightBuf[32], fpsBuf[32];
+			char widthBuf[32], heightBuf[32], fpsBuf[32], loadBuf[32], passesBuf[32];
 			GetWindowTextA(hWidthEdit_Input, widthBuf, sizeof(widthBuf));
 			GetWindowTextA(hHeightEdit_Input, heightBuf, sizeof(heightBuf));
 			GetWindowTextA(hFpsEdit_Input, fpsBuf, sizeof(fpsBuf));
+			GetWindowTextA(hLoadEdit_Input, loadBuf, sizeof(loadBuf));
+			GetWindowTextA(hPassesEdit_Input, passesBuf, sizeof(passesBuf));
 			int selectedGpuIndex = SendMessage(g_hGpuCombo, CB_GETCURSEL, 0, 0);
 			int selectedOutputIndex = SendMessage(g_hOutputCombo, CB_GETCURSEL, 0, 0);
 
@@ -486,16 +1027,10 @@ LRESULT CALLBACK InputWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 				break;
 			}
 
-			g_pSelectedAdapter = g_vAdapters[selectedGpuIndex];
-			g_pDisplayAdapter = g_vOutputs[selectedOutputIndex].pAdapter;
-			g_pSelectedOutput = g_vOutputs[selectedOutputIndex].pOutput;
-
-			if (g_vAdapters.size() > 1) {
-				g_isMultiGpu = (g_pSelectedAdapter != g_pDisplayAdapter);
-			}
-			else {
-				g_isMultiGpu = false;
-			}
+			const DisplayTopology& topology = g_displayTopology.Current();
+			g_pSelectedAdapter = topology.adapters[selectedGpuIndex];
+			g_pDisplayAdapter = topology.outputs[selectedOutputIndex].pAdapter;
+			g_pSelectedOutput = topology.outputs[selectedOutputIndex].pOutput;
 
 			if (!g_pSelectedAdapter || !g_pSelectedOutput) {
 				MessageBox(hWnd, L"Please select a valid GPU and Monitor.", L"Error", MB_OK | MB_ICONERROR);
@@ -508,6 +1043,12 @@ LRESULT CALLBACK InputWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 					g_currentHeight = std::stoi(heightBuf);
 				}
 				g_targetFPS = std::stoi(fpsBuf);
+				int selectedPresentMode = SendMessage(g_hPresentCombo, CB_GETCURSEL, 0, 0);
+				g_presentMode = selectedPresentMode == CB_ERR ? PresentMode::VSync : static_cast<PresentMode>(selectedPresentMode);
+				g_frameLogPath = SendMessage(hFrameLogCheck, BM_GETCHECK, 0, 0) == BST_CHECKED ? kInteractiveFrameLogPath : "";
+				g_loadConfig.cpuMicroseconds = std::stoi(loadBuf);
+				g_loadConfig.cpuKernel = g_loadConfig.cpuMicroseconds > 0 ? CpuLoadKernel::Busy : CpuLoadKernel::None;
+				g_loadConfig.renderPasses = std::stoi(passesBuf);
 				g_settingsConfirmed = true;
 				DestroyWindow(hWnd);
 			}
@@ -521,6 +1062,13 @@ LRESULT CALLBACK InputWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 		break;
 	}
 	case WM_DESTROY: {
+		if (uiResources.BackgroundCost().Count() > 0) {
+			LogRunMessage("settings paint: background " + FormatDurationSummary(uiResources.BackgroundCost().Summary()));
+		}
+		if (uiResources.ItemCost().Count() > 0) {
+			LogRunMessage("settings paint: items " + FormatDurationSummary(uiResources.ItemCost().Summary()));
+		}
+		uiResources.Destroy();
 		DeleteObject(hTitleFont);
 		DeleteObject(hLabelFont);
 		DeleteObject(hButtonFont);
@@ -536,6 +1084,16 @@ LRESULT CALLBACK InputWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam)
 	return DefWindowProc(hWnd, msg, wParam, lParam);
 }
 
+void RegisterRenderWindowClass(HINSTANCE hInstance) {
+	if (g_hbrBackground) return;
+	g_hbrBackground = CreateSolidBrush(RGB(13, 71, 161));
+	WNDCLASSEX wc = { sizeof(WNDCLASSEX), CS_CLASSDC, RenderWndProc, 0L, 0L, hInstance, LoadIcon(hInstance, MAKEINTRESOURCE(IDI_APPICON)), nullptr, g_hbrBackground, nullptr, L"D3DRenderWindowClass", LoadIcon(hInstance, MAKEINTRESOURCE(IDI_APPICON)) };
+	RegisterClassEx(&wc);
+}
+
+// The render window is kept between sessions while its output and style stay the
+// same, so the cached swap chain stays valid; otherwise that swap chain is released
+// before the old window is destroyed.
 void InitRenderWindow(HINSTANCE hInstance) {
 	if (!g_pSelectedOutput) return;
 
@@ -557,12 +1115,22 @@ void InitRenderWindow(HINSTANCE hInstance) {
 		title = L"CustomFPS";
 	}
 
-	g_hbrBackground = CreateSolidBrush(RGB(13, 71, 161));
-
-	WNDCLASSEX wc = { sizeof(WNDCLASSEX), CS_CLASSDC, RenderWndProc, 0L, 0L, hInstance, LoadIcon(hInstance, MAKEINTRESOURCE(IDI_APPICON)), nullptr, g_hbrBackground, nullptr, L"D3DRenderWindowClass", LoadIcon(hInstance, MAKEINTRESOURCE(IDI_APPICON)) };
-	RegisterClassEx(&wc);
+	if (g_hRenderWnd && g_pRenderWindowOutput == g_pSelectedOutput && g_renderWindowBorderless == g_borderlessFullscreen) {
+		SetWindowPos(g_hRenderWnd, HWND_TOP, x, y, g_currentWidth, g_currentHeight, g_borderlessFullscreen ? 0 : SWP_NOMOVE);
+		ShowWindow(g_hRenderWnd, SW_SHOW);
+		UpdateWindow(g_hRenderWnd);
+		return;
+	}
+	if (g_hRenderWnd) {
+		g_backendCache.ReleaseSurface();
+		DestroyWindow(g_hRenderWnd);
+		g_hRenderWnd = nullptr;
+	}
 
-	g_hRenderWnd = CreateWindow(wc.lpszClassName, title, style, x, y, g_currentWidth, g_currentHeight, nullptr, nullptr, wc.hInstance, nullptr);
+	RegisterRenderWindowClass(hInstance);
+	g_hRenderWnd = CreateWindow(L"D3DRenderWindowClass", title, style, x, y, g_currentWidth, g_currentHeight, nullptr, nullptr, hInstance, nullptr);
+	g_pRenderWindowOutput = g_pSelectedOutput;
+	g_renderWindowBorderless = g_borderlessFullscreen;
 
 	ShowWindow(g_hRenderWnd, SW_SHOWDEFAULT);
 	UpdateWindow(g_hRenderWnd);
@@ -572,23 +1140,54 @@ LRESULT CALLBACK RenderWndProc(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam
 	switch (msg) {
 	case WM_KEYDOWN:
 		if (wParam == VK_ESCAPE) {
-			DestroyWindow(hWnd);
+			if (g_pRenderThread) g_pRenderThread->RequestStop();
+			if (g_pMultiOutputRun) g_pMultiOutputRun->RequestStop();
+		}
+		else if (wParam == VK_F2) {
+			PostRenderCommand(RenderCommandType::ToggleOverlay);
+		}
+		else if (wParam == VK_F5) {
+			PostRenderCommand(RenderCommandType::StartLatencySweep);
+		}
+		else if (wParam == VK_F6) {
+			PostRenderCommand(RenderCommandType::StartMaxFpsSearch);
 		}
+		else if (wParam == VK_F7) {
+			PostRenderCommand(RenderCommandType::ToggleTestPattern);
+		}
+		else if (!(lParam & (1 << 30))) {
+			PostRenderCommand(RenderCommandType::Input);
+		}
+		break;
+	case WM_LBUTTONDOWN:
+	case WM_RBUTTONDOWN:
+		PostRenderCommand(RenderCommandType::Input);
+		break;
+	case WM_CLOSE:
+		// The render thread still owns the swap chain; the window is hidden once it has stopped.
+		if (g_pRenderThread) g_pRenderThread->RequestStop();
+		if (g_pMultiOutputRun) g_pMultiOutputRun->RequestStop();
+		return 0;
+	case WM_DISPLAYCHANGE:
+		g_displayTopology.Invalidate();
 		break;
+	case WM_RENDER_STOPPED:
+		// The window and its swap chain stay cached for the next session.
+		ShowWindow(hWnd, SW_HIDE);
+		PostQuitMessage(0);
+		return 0;
 	case WM_NCHITTEST: {
 		LRESULT hit = DefWindowProc(hWnd, msg, wParam, lParam);
 		if (hit == HTCLIENT && !g_borderlessFullscreen) return HTCAPTION;
 		return hit;
 	}
-	case WM_DESTROY:
-		if (g_hbrBackground) { DeleteObject(g_hbrBackground); g_hbrBackground = nullptr; }
-		PostQuitMessage(0);
-		return 0;
 	case WM_SIZE:
-		if (g_pSwapChain && wParam != SIZE_MINIMIZED) {
-			g_currentWidth = LOWORD(lParam);
-			g_currentHeight = HIWORD(lParam);
-			g_resizeRequested = true;
+		if (g_pRenderBackend && wParam != SIZE_MINIMIZED) {
+			int width = LOWORD(lParam);
+			int height = HIWORD(lParam);
+			g_currentWidth = width;
+			g_currentHeight = height;
+			PostRenderCommand(RenderCommandType::Resize, width, height);
 		}
 		return 0;
 	}
@@ -626,194 +1225,128 @@ bool LoadLogoImage() {
 	if (!hGlobal) return false;
 	LPVOID pSource = LockResource(hGlobal);
 	if (!pSource) return false;
-	HGLOBAL hBuffer = GlobalAlloc(GMEM_MOVEABLE, imageSize);
-	if (hBuffer) {
-		void* pBuffer = GlobalLock(hBuffer);
-		if (pBuffer) {
-			CopyMemory(pBuffer, pSource, imageSize);
-			IStream* pStream = nullptr;
-			if (CreateStreamOnHGlobal(hBuffer, TRUE, &pStream) == S_OK) {
-				g_pLogoBitmap = Gdiplus::Bitmap::FromStream(pStream);
-				pStream->Release();
-			}
-		}
-		GlobalUnlock(hBuffer);
+
+	// Resource memory stays mapped for the life of the module, so decode it in place.
+	IStream* pStream = MemoryStream::Create(pSource, imageSize);
+	if (!pStream) return false;
+	Gdiplus::Bitmap* pDecoded = Gdiplus::Bitmap::FromStream(pStream);
+	// FromStream decodes lazily; converting to premultiplied ARGB forces the decode here,
+	// off the UI thread, into the format DrawImage blends fastest.
+	if (pDecoded && pDecoded->GetLastStatus() == Gdiplus::Ok) {
+		g_pLogoBitmap = pDecoded->Clone(0, 0, pDecoded->GetWidth(), pDecoded->GetHeight(), PixelFormat32bppPARGB);
 	}
+	delete pDecoded;
+	pStream->Release();
 	return g_pLogoBitmap && g_pLogoBitmap->GetLastStatus() == Gdiplus::Ok;
 }
 
-void InitD3D() {
-	DXGI_SWAP_CHAIN_DESC sd = {};
-	sd.BufferCount = 2;
-	sd.BufferDesc.Width = g_currentWidth;
-	sd.BufferDesc.Height = g_currentHeight;
-	sd.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-	sd.BufferDesc.RefreshRate.Numerator = g_targetFPS;
-	sd.BufferDesc.RefreshRate.Denominator = 1;
-	sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-	sd.OutputWindow = g_hRenderWnd;
-	sd.SampleDesc.Count = 1;
-	sd.SampleDesc.Quality = 0;
-	sd.Windowed = TRUE;
-	sd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-
-	const D3D_FEATURE_LEVEL featureLevelArray[1] = { D3D_FEATURE_LEVEL_11_0 };
-
-	if (!g_isMultiGpu) {
-		D3D11CreateDeviceAndSwapChain(g_pSelectedAdapter, D3D_DRIVER_TYPE_UNKNOWN, nullptr, 0, featureLevelArray, 1, D3D11_SDK_VERSION, &sd, &g_pSwapChain, &g_pDevice, nullptr, &g_pDeviceContext);
+bool InitRenderBackend() {
+	BackendCacheKey key;
+	key.type = g_renderBackendType;
+	if (g_renderBackendType == RenderBackendType::Headless) {
+		g_presentPlan = PlanPresent(PresentMode::Immediate, g_targetFPS, 0, false);
 	}
 	else {
-		D3D11CreateDevice(g_pSelectedAdapter, D3D_DRIVER_TYPE_UNKNOWN, nullptr, 0, featureLevelArray, 1, D3D11_SDK_VERSION, &g_pProcessingDevice, nullptr, &g_pProcessingDeviceContext);
-		D3D11CreateDevice(g_pDisplayAdapter, D3D_DRIVER_TYPE_UNKNOWN, nullptr, 0, featureLevelArray, 1, D3D11_SDK_VERSION, &g_pDevice, nullptr, &g_pDeviceContext);
-
-		CreateSharedResources(g_currentWidth, g_currentHeight);
-
-		IDXGIFactory* pFactory;
-		HRESULT hr = g_pDisplayAdapter->GetParent(__uuidof(IDXGIFactory), (void**)&pFactory);
-		if (SUCCEEDED(hr)) {
-			pFactory->CreateSwapChain(g_pDevice, &sd, &g_pSwapChain);
-			pFactory->Release();
-		}
+		g_presentPlan = PlanPresent(g_presentMode, g_targetFPS, GetOutputRefreshRate(g_pSelectedOutput), D3D11Backend::IsTearingSupported(g_pDisplayAdapter));
+		key.renderAdapter = g_pSelectedAdapter;
+		key.displayAdapter = g_pDisplayAdapter;
+		key.window = g_hRenderWnd;
+		key.allowTearing = g_presentPlan.allowTearing;
+		key.waitOnSwapChain = g_presentPlan.waitOnSwapChain;
+		key.maxFrameLatency = g_presentPlan.maxFrameLatency;
 	}
+	key.width = g_currentWidth;
+	key.height = g_currentHeight;
 
-	if (g_borderlessFullscreen && g_pSwapChain) {
-		IDXGIFactory* pFactory;
-		if (SUCCEEDED(g_pSwapChain->GetParent(__uuidof(IDXGIFactory), (void**)&pFactory))) {
-			pFactory->MakeWindowAssociation(g_hRenderWnd, DXGI_MWA_NO_ALT_ENTER);
-			pFactory->Release();
-		}
+	g_pRenderBackend = g_backendCache.Acquire(key, g_lastBackendReuse);
+	if (!g_pRenderBackend) return false;
+	if (g_renderBackendType == RenderBackendType::D3D11) {
+		static_cast<D3D11Backend*>(g_pRenderBackend)->SetPresentPlan(g_presentPlan);
 	}
-
-	CreateRenderTarget();
+	return true;
 }
 
-void CreateRenderTarget() {
-	ID3D11Texture2D* pBackBuffer;
-	if (g_pSwapChain && SUCCEEDED(g_pSwapChain->GetBuffer(0, IID_PPV_ARGS(&pBackBuffer)))) {
-		g_pDevice->CreateRenderTargetView(pBackBuffer, nullptr, &g_pRenderTargetView);
-		pBackBuffer->Release();
-	}
-}
-
-void CleanupRenderTarget() {
-	if (g_pRenderTargetView) { g_pRenderTargetView->Release(); g_pRenderTargetView = nullptr; }
+// Creation hooks for g_backendCache. They read the same globals InitRenderBackend
+// builds the key from.
+BackendCacheHooks MakeBackendCacheHooks() {
+	BackendCacheHooks hooks;
+	hooks.create = [](const BackendCacheKey& key) -> std::unique_ptr<RenderBackend> {
+		std::unique_ptr<RenderBackend> pBackend;
+		if (key.type == RenderBackendType::Headless) pBackend = std::make_unique<HeadlessBackend>();
+		else pBackend = std::make_unique<D3D11Backend>(g_hRenderWnd, g_pSelectedAdapter, g_pDisplayAdapter, g_presentPlan, g_borderlessFullscreen);
+		if (!pBackend->Init(key.width, key.height)) {
+			pBackend->Cleanup();
+			pBackend.reset();
+		}
+		return pBackend;
+	};
+	hooks.resetSurface = [](RenderBackend& backend, const BackendCacheKey& key) {
+		if (key.type == RenderBackendType::Headless) {
+			backend.Resize(key.width, key.height);
+			return true;
+		}
+		return static_cast<D3D11Backend&>(backend).ResetSwapChain(g_hRenderWnd, g_presentPlan, g_borderlessFullscreen, key.width, key.height);
+	};
+	hooks.releaseSurface = [](RenderBackend& backend) {
+		if (g_backendCache.Key().type == RenderBackendType::D3D11) static_cast<D3D11Backend&>(backend).ReleaseSwapChain();
+	};
+	return hooks;
 }
 
-void CleanupSharedResources() {
-	if (g_pSharedRTV) { g_pSharedRTV->Release(); g_pSharedRTV = nullptr; }
-	if (g_pSharedTexture) { g_pSharedTexture->Release(); g_pSharedTexture = nullptr; }
+int GetOutputRefreshRate(IDXGIOutput* pOutput) {
+	if (!pOutput) return 0;
+	DXGI_OUTPUT_DESC outputDesc;
+	if (FAILED(pOutput->GetDesc(&outputDesc))) return 0;
+	DEVMODEW devMode = {};
+	devMode.dmSize = sizeof(devMode);
+	if (!EnumDisplaySettingsW(outputDesc.DeviceName, ENUM_CURRENT_SETTINGS, &devMode)) return 0;
+	return static_cast<int>(devMode.dmDisplayFrequency);
 }
 
-bool CreateSharedResources(int width, int height) {
-	if (!g_pProcessingDevice || !g_pDevice) return false;
-
-	D3D11_TEXTURE2D_DESC texDesc = {};
-	texDesc.Width = width;
-	texDesc.Height = height;
-	texDesc.MipLevels = 1;
-	texDesc.ArraySize = 1;
-	texDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-	texDesc.SampleDesc.Count = 1;
-	texDesc.Usage = D3D11_USAGE_DEFAULT;
-	texDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
-	texDesc.MiscFlags = D3D11_RESOURCE_MISC_SHARED;
-
-	ID3D11Texture2D* pProcessingTexture = nullptr;
-	HRESULT hr = g_pProcessingDevice->CreateTexture2D(&texDesc, nullptr, &pProcessingTexture);
-	if (FAILED(hr)) return false;
-
-	hr = g_pProcessingDevice->CreateRenderTargetView(pProcessingTexture, nullptr, &g_pSharedRTV);
-	if (FAILED(hr)) {
-		pProcessingTexture->Release();
-		return false;
+// Final teardown; between sessions the backend and its window stay cached.
+void CleanupRenderBackend() {
+	g_backendCache.Reset();
+	g_pRenderBackend = nullptr;
+	if (g_hRenderWnd) {
+		DestroyWindow(g_hRenderWnd);
+		g_hRenderWnd = nullptr;
 	}
-
-	IDXGIResource* pDXGIResource = nullptr;
-	hr = pProcessingTexture->QueryInterface(__uuidof(IDXGIResource), (void**)&pDXGIResource);
-	if (FAILED(hr)) {
-		pProcessingTexture->Release();
-		return false;
-	}
-
-	HANDLE hSharedHandle = nullptr;
-	pDXGIResource->GetSharedHandle(&hSharedHandle);
-	pDXGIResource->Release();
-
-	if (hSharedHandle == nullptr) {
-		pProcessingTexture->Release();
-		return false;
-	}
-
-	hr = g_pDevice->OpenSharedResource(hSharedHandle, __uuidof(ID3D11Texture2D), (void**)&g_pSharedTexture);
-	pProcessingTexture->Release();
-
-	return SUCCEEDED(hr);
+	g_pRenderWindowOutput = nullptr;
 }
 
-void CleanupD3D() {
-	CleanupRenderTarget();
-	if (g_pSwapChain) {
-		g_pSwapChain->SetFullscreenState(FALSE, NULL);
-		g_pSwapChain->Release();
-		g_pSwapChain = nullptr;
-	}
-
-	if (g_isMultiGpu) {
-		CleanupSharedResources();
-		if (g_pProcessingDeviceContext) { g_pProcessingDeviceContext->Release(); g_pProcessingDeviceContext = nullptr; }
-		if (g_pProcessingDevice) { g_pProcessingDevice->Release(); g_pProcessingDevice = nullptr; }
-	}
-
-	if (g_pDeviceContext) { g_pDeviceContext->Release(); g_pDeviceContext = nullptr; }
-	if (g_pDevice) { g_pDevice->Release(); g_pDevice = nullptr; }
-	g_isMultiGpu = false;
-	g_pSelectedAdapter = nullptr;
-	g_pDisplayAdapter = nullptr;
+void PostRenderCommand(RenderCommandType type, int width, int height) {
+	if (!g_pRenderThread) return;
+	RenderCommand command;
+	command.type = type;
+	command.width = width;
+	command.height = height;
+	command.timestamp = g_pFrameClock ? g_pFrameClock->Now() : 0;
+	g_pRenderThread->Post(command);
 }
 
-void UpdateWindowSize(int width, int height) {
-	CleanupRenderTarget();
-	if (g_pSwapChain) {
-		if (g_isMultiGpu) {
-			CleanupSharedResources();
-		}
-		g_pSwapChain->ResizeBuffers(0, width, height, DXGI_FORMAT_UNKNOWN, 0);
-		if (g_isMultiGpu) {
-			CreateSharedResources(width, height);
-		}
-	}
-	CreateRenderTarget();
-	if (!g_borderlessFullscreen) {
-		RECT wr = { 0, 0, width, height };
-		AdjustWindowRect(&wr, WS_OVERLAPPEDWINDOW, FALSE);
-		SetWindowPos(g_hRenderWnd, nullptr, 0, 0, wr.right - wr.left, wr.bottom - wr.top, SWP_NOMOVE | SWP_NOZORDER);
-	}
+// Render thread. The size comes from WM_SIZE, so the window already has it; only the
+// swap chain follows. Window placement stays with the UI thread that owns the window.
+void ApplyPendingResize(ResizeCoalescer& resizes, FrameClock& clock) {
+	int width = 0;
+	int height = 0;
+	int64_t start = clock.Now();
+	if (!resizes.Poll(start, width, height)) return;
+	TRACE_ZONE("resize backend");
+	if (g_pRenderBackend) g_pRenderBackend->Resize(width, height);
+	resizes.OnApplied(clock.Now() - start);
 }
 
-void RenderFrame() {
-	const float clearColor[4] = { 13.0f / 255.0f, 71.0f / 255.0f, 161.0f / 255.0f, 1.0f };
-
-	if (!g_isMultiGpu) {
-		if (g_pDeviceContext && g_pRenderTargetView) {
-			g_pDeviceContext->OMSetRenderTargets(1, &g_pRenderTargetView, nullptr);
-			g_pDeviceContext->ClearRenderTargetView(g_pRenderTargetView, clearColor);
-		}
+std::string FormatResizeStats(const ResizeCoalescer& resizes) {
+	const ResizeStats& stats = resizes.Stats();
+	std::string text = "requests=" + std::to_string(stats.requests) + " applied=" + std::to_string(stats.applied) + " coalesced=" + std::to_string(stats.coalesced);
+	if (stats.applied > 0) {
+		char cost[96];
+		snprintf(cost, sizeof(cost), " cost mean=%.3f ms max=%.3f ms", resizes.Cost().MeanMs(), resizes.Cost().Summary().maxMs);
+		text += cost;
 	}
-	else {
-		if (g_pProcessingDeviceContext && g_pSharedRTV && g_pDeviceContext && g_pSharedTexture) {
-			g_pProcessingDeviceContext->OMSetRenderTargets(1, &g_pSharedRTV, nullptr);
-			g_pProcessingDeviceContext->ClearRenderTargetView(g_pSharedRTV, clearColor);
-			g_pProcessingDeviceContext->Flush();
-
-			ID3D11Texture2D* pBackBuffer = nullptr;
-			if (g_pSwapChain && SUCCEEDED(g_pSwapChain->GetBuffer(0, IID_PPV_ARGS(&pBackBuffer)))) {
-				g_pDeviceContext->CopyResource(pBackBuffer, g_pSharedTexture);
-				pBackBuffer->Release();
-			}
-		}
+	if (g_renderBackendType == RenderBackendType::D3D11 && g_pRenderBackend) {
+		const SizeBucketPoolStats& shared = static_cast<D3D11Backend*>(g_pRenderBackend)->SharedTextureStats();
+		text += " shared textures allocated=" + std::to_string(shared.allocations) + " reused=" + std::to_string(shared.reuses) + " evicted=" + std::to_string(shared.evictions);
 	}
-
-	if (g_pSwapChain) {
-		g_pSwapChain->Present(1, 0);
-	}
-}
\ No newline at end of file
+	return text;
+}
@@ -0,0 +1,518 @@
+#include "D3D11Backend.h"
+
+#include "PerfOverlay.h"
+#include "TestPattern.h"
+#include "Tracer.h"
+
+D3D11Backend::D3D11Backend(HWND hWnd, IDXGIAdapter* pRenderAdapter, IDXGIAdapter* pDisplayAdapter, const PresentPlan& presentPlan, bool borderlessFullscreen, int sharedTextureCount)
+	: m_hWnd(hWnd), m_pRenderAdapter(pRenderAdapter), m_pDisplayAdapter(pDisplayAdapter), m_presentPlan(presentPlan),
+	m_borderlessFullscreen(borderlessFullscreen), m_isMultiGpu(pDisplayAdapter && pRenderAdapter != pDisplayAdapter),
+	m_sharedRing(sharedTextureCount), m_overlayFill(0) {
+}
+
+D3D11Backend::~D3D11Backend() {
+	Cleanup();
+}
+
+bool D3D11Backend::IsTearingSupported(IDXGIAdapter* pAdapter) {
+	BOOL allowTearing = FALSE;
+	IDXGIFactory5* pFactory5 = nullptr;
+	if (pAdapter && SUCCEEDED(pAdapter->GetParent(__uuidof(IDXGIFactory5), (void**)&pFactory5))) {
+		if (FAILED(pFactory5->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING, &allowTearing, sizeof(allowTearing)))) {
+			allowTearing = FALSE;
+		}
+		pFactory5->Release();
+	}
+	return allowTearing == TRUE;
+}
+
+bool D3D11Backend::Init(int width, int height) {
+	return CreateDevices() && CreateSwapChain(width, height);
+}
+
+bool D3D11Backend::CreateDevices() {
+	const D3D_FEATURE_LEVEL featureLevelArray[1] = { D3D_FEATURE_LEVEL_11_0 };
+	if (m_isMultiGpu) {
+		D3D11CreateDevice(m_pRenderAdapter, D3D_DRIVER_TYPE_UNKNOWN, nullptr, 0, featureLevelArray, 1, D3D11_SDK_VERSION, &m_pProcessingDevice, nullptr, &m_pProcessingDeviceContext);
+		D3D11CreateDevice(m_pDisplayAdapter, D3D_DRIVER_TYPE_UNKNOWN, nullptr, 0, featureLevelArray, 1, D3D11_SDK_VERSION, &m_pDevice, nullptr, &m_pDeviceContext);
+		return m_pProcessingDevice && m_pDevice;
+	}
+	D3D11CreateDevice(m_pRenderAdapter, m_pRenderAdapter ? D3D_DRIVER_TYPE_UNKNOWN : D3D_DRIVER_TYPE_HARDWARE, nullptr, 0, featureLevelArray, 1, D3D11_SDK_VERSION, &m_pDevice, nullptr, &m_pDeviceContext);
+	return m_pDevice != nullptr;
+}
+
+// The swap chain lives on the device that drives the output; the factory comes from
+// that device's adapter so it also works when the caller passed no adapter.
+bool D3D11Backend::CreateSwapChain(int width, int height) {
+	m_width = width;
+	m_height = height;
+	if (!m_pDevice) return false;
+
+	DXGI_SWAP_CHAIN_DESC sd = {};
+	sd.BufferCount = 2;
+	sd.BufferDesc.Width = width;
+	sd.BufferDesc.Height = height;
+	sd.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	sd.BufferDesc.RefreshRate.Numerator = m_presentPlan.targetFps;
+	sd.BufferDesc.RefreshRate.Denominator = 1;
+	sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+	sd.OutputWindow = m_hWnd;
+	sd.SampleDesc.Count = 1;
+	sd.SampleDesc.Quality = 0;
+	sd.Windowed = TRUE;
+	sd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+
+	m_swapChainFlags = 0;
+	if (m_presentPlan.waitOnSwapChain) m_swapChainFlags |= DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+	if (m_presentPlan.allowTearing) m_swapChainFlags |= DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+	sd.Flags = m_swapChainFlags;
+
+	if (m_isMultiGpu) {
+		AcquireSharedResources(width, height);
+	}
+
+	IDXGIDevice* pDXGIDevice = nullptr;
+	IDXGIAdapter* pAdapter = nullptr;
+	IDXGIFactory* pFactory = nullptr;
+	if (SUCCEEDED(m_pDevice->QueryInterface(__uuidof(IDXGIDevice), (void**)&pDXGIDevice))) {
+		if (SUCCEEDED(pDXGIDevice->GetAdapter(&pAdapter))) {
+			pAdapter->GetParent(__uuidof(IDXGIFactory), (void**)&pFactory);
+			pAdapter->Release();
+		}
+		pDXGIDevice->Release();
+	}
+	if (pFactory) {
+		pFactory->CreateSwapChain(m_pDevice, &sd, &m_pSwapChain);
+		if (m_borderlessFullscreen && m_pSwapChain) {
+			pFactory->MakeWindowAssociation(m_hWnd, DXGI_MWA_NO_ALT_ENTER);
+		}
+		pFactory->Release();
+	}
+
+	if (m_pSwapChain && (m_swapChainFlags & DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT)) {
+		IDXGISwapChain2* pSwapChain2 = nullptr;
+		if (SUCCEEDED(m_pSwapChain->QueryInterface(__uuidof(IDXGISwapChain2), (void**)&pSwapChain2))) {
+			pSwapChain2->SetMaximumFrameLatency(m_presentPlan.maxFrameLatency);
+			m_hFrameLatencyWaitable = pSwapChain2->GetFrameLatencyWaitableObject();
+			pSwapChain2->Release();
+		}
+	}
+
+	CreateRenderTarget();
+	return m_pSwapChain != nullptr;
+}
+
+// Everything tied to the window and buffer size goes; the devices stay. A flip-model
+// swap chain for the same window can only be created once the old buffers are really
+// gone, hence ClearState + Flush.
+void D3D11Backend::ReleaseSwapChain() {
+	if (m_hFrameLatencyWaitable) { CloseHandle(m_hFrameLatencyWaitable); m_hFrameLatencyWaitable = nullptr; }
+	CleanupWorkloadResources();
+	CleanupRenderTarget();
+	if (m_isMultiGpu) {
+		ReleaseSharedResources();
+	}
+	if (m_pSwapChain) {
+		m_pSwapChain->SetFullscreenState(FALSE, NULL);
+		m_pSwapChain->Release();
+		m_pSwapChain = nullptr;
+	}
+	if (m_pDeviceContext) {
+		m_pDeviceContext->ClearState();
+		m_pDeviceContext->Flush();
+	}
+}
+
+bool D3D11Backend::ResetSwapChain(HWND hWnd, const PresentPlan& presentPlan, bool borderlessFullscreen, int width, int height) {
+	ReleaseSwapChain();
+	m_hWnd = hWnd;
+	m_presentPlan = presentPlan;
+	m_borderlessFullscreen = borderlessFullscreen;
+	return CreateSwapChain(width, height);
+}
+
+// With flip-model swap chains D3D11 always exposes the current back buffer as
+// buffer 0, so one cached texture/RTV pair stays valid until the next resize.
+void D3D11Backend::CreateRenderTarget() {
+	if (!m_pSwapChain) return;
+	m_backBuffers.Rebuild(1, [this](int index, BackBufferEntry& entry, int& comCalls) {
+		comCalls++;
+		if (FAILED(m_pSwapChain->GetBuffer(index, IID_PPV_ARGS(&entry.pTexture)))) return false;
+		if (m_isMultiGpu) return true;
+		comCalls++;
+		return SUCCEEDED(m_pDevice->CreateRenderTargetView(entry.pTexture, nullptr, &entry.pRTV));
+	});
+}
+
+void D3D11Backend::CleanupRenderTarget() {
+	m_backBuffers.Clear([](BackBufferEntry& entry) {
+		int comCalls = 0;
+		if (entry.pRTV) { entry.pRTV->Release(); entry.pRTV = nullptr; comCalls++; }
+		if (entry.pTexture) { entry.pTexture->Release(); entry.pTexture = nullptr; comCalls++; }
+		return comCalls;
+	});
+}
+
+void D3D11Backend::DestroySharedSet(SharedTextureSet& set) {
+	for (SharedSlot& slot : set.slots) {
+		if (slot.pRenderTexture) { slot.pRenderTexture->Release(); slot.pRenderTexture = nullptr; }
+		if (slot.pRenderRTV) { slot.pRenderRTV->Release(); slot.pRenderRTV = nullptr; }
+		if (slot.pRenderMutex) { slot.pRenderMutex->Release(); slot.pRenderMutex = nullptr; }
+		if (slot.pDisplayTexture) { slot.pDisplayTexture->Release(); slot.pDisplayTexture = nullptr; }
+		if (slot.pDisplayMutex) { slot.pDisplayMutex->Release(); slot.pDisplayMutex = nullptr; }
+	}
+}
+
+// Hands the active set back to the pool; every slot is back on key 0 once the ring
+// has been drained, so a reused set starts from the same state as a new one.
+void D3D11Backend::ReleaseSharedResources() {
+	CloseSharedFrame();
+	if (m_sharedReady) {
+		while (CopyReadySharedTexture()) {
+		}
+		m_sharedPool.Release(m_sharedSet, m_sharedWidth, m_sharedHeight);
+		m_sharedSet = SharedTextureSet();
+	}
+	m_sharedRing.Reset(m_sharedRing.SlotCount());
+	m_sharedReady = false;
+}
+
+void D3D11Backend::CleanupSharedResources() {
+	CloseSharedFrame();
+	DestroySharedSet(m_sharedSet);
+	m_sharedPool.Clear(DestroySharedSet);
+	m_sharedRing.Reset(m_sharedRing.SlotCount());
+	m_sharedReady = false;
+}
+
+bool D3D11Backend::AcquireSharedResources(int width, int height) {
+	if (!m_pProcessingDevice || !m_pDevice) return false;
+	m_sharedReady = m_sharedPool.Acquire(width, height, m_sharedSet, m_sharedWidth, m_sharedHeight,
+		[this](int bucketWidth, int bucketHeight, SharedTextureSet& set) { return CreateSharedSet(bucketWidth, bucketHeight, set); }, DestroySharedSet);
+	return m_sharedReady;
+}
+
+bool D3D11Backend::CreateSharedSet(int width, int height, SharedTextureSet& set) {
+	D3D11_TEXTURE2D_DESC texDesc = {};
+	texDesc.Width = width;
+	texDesc.Height = height;
+	texDesc.MipLevels = 1;
+	texDesc.ArraySize = 1;
+	texDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	texDesc.SampleDesc.Count = 1;
+	texDesc.Usage = D3D11_USAGE_DEFAULT;
+	texDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+	texDesc.MiscFlags = D3D11_RESOURCE_MISC_SHARED_KEYEDMUTEX;
+
+	for (int i = 0; i < m_sharedRing.SlotCount(); ++i) {
+		SharedSlot& slot = set.slots[i];
+
+		HRESULT hr = m_pProcessingDevice->CreateTexture2D(&texDesc, nullptr, &slot.pRenderTexture);
+		if (FAILED(hr)) {
+			DestroySharedSet(set);
+			return false;
+		}
+		ID3D11Texture2D* pProcessingTexture = slot.pRenderTexture;
+
+		hr = m_pProcessingDevice->CreateRenderTargetView(pProcessingTexture, nullptr, &slot.pRenderRTV);
+		if (SUCCEEDED(hr)) {
+			hr = pProcessingTexture->QueryInterface(__uuidof(IDXGIKeyedMutex), (void**)&slot.pRenderMutex);
+		}
+
+		HANDLE hSharedHandle = nullptr;
+		if (SUCCEEDED(hr)) {
+			IDXGIResource* pDXGIResource = nullptr;
+			hr = pProcessingTexture->QueryInterface(__uuidof(IDXGIResource), (void**)&pDXGIResource);
+			if (SUCCEEDED(hr)) {
+				pDXGIResource->GetSharedHandle(&hSharedHandle);
+				pDXGIResource->Release();
+			}
+		}
+
+		if (SUCCEEDED(hr) && hSharedHandle) {
+			hr = m_pDevice->OpenSharedResource(hSharedHandle, __uuidof(ID3D11Texture2D), (void**)&slot.pDisplayTexture);
+		}
+		if (SUCCEEDED(hr) && slot.pDisplayTexture) {
+			hr = slot.pDisplayTexture->QueryInterface(__uuidof(IDXGIKeyedMutex), (void**)&slot.pDisplayMutex);
+		}
+
+		if (FAILED(hr) || !hSharedHandle || !slot.pDisplayMutex) {
+			DestroySharedSet(set);
+			return false;
+		}
+	}
+	return true;
+}
+
+bool D3D11Backend::CreateWorkloadResources() {
+	ID3D11Device* pDevice = m_isMultiGpu ? m_pProcessingDevice : m_pDevice;
+	if (!pDevice) return false;
+
+	D3D11_TEXTURE2D_DESC texDesc = {};
+	texDesc.Width = m_width;
+	texDesc.Height = m_height;
+	texDesc.MipLevels = 1;
+	texDesc.ArraySize = 1;
+	texDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	texDesc.SampleDesc.Count = 1;
+	texDesc.Usage = D3D11_USAGE_DEFAULT;
+	texDesc.BindFlags = D3D11_BIND_RENDER_TARGET;
+
+	for (ID3D11Texture2D*& pTexture : m_pWorkloadTextures) {
+		if (FAILED(pDevice->CreateTexture2D(&texDesc, nullptr, &pTexture))) {
+			CleanupWorkloadResources();
+			return false;
+		}
+	}
+	if (FAILED(pDevice->CreateRenderTargetView(m_pWorkloadTextures[0], nullptr, &m_pWorkloadRTV))) {
+		CleanupWorkloadResources();
+		return false;
+	}
+	return true;
+}
+
+void D3D11Backend::CleanupWorkloadResources() {
+	if (m_pWorkloadRTV) { m_pWorkloadRTV->Release(); m_pWorkloadRTV = nullptr; }
+	for (ID3D11Texture2D*& pTexture : m_pWorkloadTextures) {
+		if (pTexture) { pTexture->Release(); pTexture = nullptr; }
+	}
+}
+
+void D3D11Backend::Cleanup() {
+	DisableGpuTimestamps();
+	ReleaseSwapChain();
+	CleanupSharedResources();
+	if (m_pProcessingDeviceContext) { m_pProcessingDeviceContext->Release(); m_pProcessingDeviceContext = nullptr; }
+	if (m_pProcessingDevice) { m_pProcessingDevice->Release(); m_pProcessingDevice = nullptr; }
+
+	if (m_pDeviceContext) { m_pDeviceContext->Release(); m_pDeviceContext = nullptr; }
+	if (m_pDevice) { m_pDevice->Release(); m_pDevice = nullptr; }
+}
+
+void D3D11Backend::Resize(int width, int height) {
+	m_width = width;
+	m_height = height;
+	CleanupWorkloadResources();
+	CleanupRenderTarget();
+	if (m_pSwapChain) {
+		if (m_isMultiGpu) {
+			ReleaseSharedResources();
+		}
+		{
+			TRACE_ZONE("ResizeBuffers");
+			m_pSwapChain->ResizeBuffers(0, width, height, DXGI_FORMAT_UNKNOWN, m_swapChainFlags);
+		}
+		if (m_isMultiGpu) {
+			AcquireSharedResources(width, height);
+		}
+	}
+	CreateRenderTarget();
+}
+
+// Blocks until the swap chain can queue another frame, so the loop waits on the
+// compositor rather than building up latency behind Present().
+void D3D11Backend::WaitForPresentSlot() {
+	if (m_hFrameLatencyWaitable) {
+		WaitForSingleObjectEx(m_hFrameLatencyWaitable, 1000, TRUE);
+	}
+}
+
+bool D3D11Backend::EnableGpuTimestamps(int64_t cpuFrequency, const std::string& traceName) {
+	DisableGpuTimestamps();
+	if (!m_pDevice || (m_isMultiGpu && !m_pProcessingDevice)) return false;
+
+	m_renderTrackName = m_isMultiGpu ? traceName + " render" : traceName;
+	m_renderQueries.SetDevice(m_isMultiGpu ? m_pProcessingDevice : m_pDevice, m_isMultiGpu ? m_pProcessingDeviceContext : m_pDeviceContext);
+	m_renderTimeline = std::make_unique<GpuTimestampRing>(m_renderQueries, cpuFrequency);
+	m_renderTimeline->SetTraceTrack(m_renderTrackName.c_str());
+	bool ok = m_renderTimeline->Create();
+	if (m_isMultiGpu) {
+		m_displayTrackName = traceName + " display";
+		m_displayQueries.SetDevice(m_pDevice, m_pDeviceContext);
+		m_displayTimeline = std::make_unique<GpuTimestampRing>(m_displayQueries, cpuFrequency);
+		m_displayTimeline->SetTraceTrack(m_displayTrackName.c_str());
+		ok = m_displayTimeline->Create() && ok;
+	}
+	if (!ok) DisableGpuTimestamps();
+	return ok;
+}
+
+void D3D11Backend::DisableGpuTimestamps() {
+	m_renderTimeline.reset();
+	m_displayTimeline.reset();
+}
+
+void D3D11Backend::BeginFrame(uint64_t frameIndex, int64_t now) {
+	if (m_renderTimeline) m_renderTimeline->BeginFrame(frameIndex, now);
+	if (m_displayTimeline) m_displayTimeline->BeginFrame(frameIndex, now);
+}
+
+// Bandwidth-bound GPU load without a shader pipeline: ping-pong full-size copies
+// between two scratch targets on the rendering device.
+void D3D11Backend::RenderWorkload(int passes) {
+	if (passes <= 0) return;
+	ID3D11DeviceContext* pContext = m_isMultiGpu ? m_pProcessingDeviceContext : m_pDeviceContext;
+	if (!pContext || (!m_pWorkloadRTV && !CreateWorkloadResources())) return;
+
+	const float workloadColor[4] = { 0.5f, 0.5f, 0.5f, 1.0f };
+	pContext->ClearRenderTargetView(m_pWorkloadRTV, workloadColor);
+	for (int i = 0; i < passes; ++i) {
+		pContext->CopyResource(m_pWorkloadTextures[(i + 1) & 1], m_pWorkloadTextures[i & 1]);
+	}
+	if (m_renderTimeline) m_renderTimeline->Mark(kGpuMarkWorkload);
+}
+
+void D3D11Backend::Clear(const float color[4]) {
+	if (!m_isMultiGpu) {
+		BackBufferEntry* pBackBuffer = m_backBuffers.Get(0);
+		if (m_pDeviceContext && pBackBuffer && pBackBuffer->pRTV) {
+			TRACE_ZONE("ClearRenderTargetView");
+			m_pDeviceContext->OMSetRenderTargets(1, &pBackBuffer->pRTV, nullptr);
+			m_pDeviceContext->ClearRenderTargetView(pBackBuffer->pRTV, color);
+		}
+		if (m_renderTimeline) m_renderTimeline->Mark(kGpuMarkClear);
+	}
+	else if (m_sharedReady && m_pProcessingDeviceContext && m_pDeviceContext) {
+		// A second Clear before Present starts the frame over in a fresh slot.
+		CloseSharedFrame();
+		int slotIndex = m_sharedRing.BeginRender();
+		if (slotIndex < 0) {
+			CopyReadySharedTexture();
+			slotIndex = m_sharedRing.BeginRender();
+			if (slotIndex < 0) return;
+		}
+
+		// Key 0: owned by the render adapter, key 1: owned by the display adapter. The
+		// slot stays on key 0 until Present, so the pattern and overlay land in it too.
+		SharedSlot& slot = m_sharedSet.slots[slotIndex];
+		m_openSlot = slotIndex;
+		m_openSlotAcquired = slot.pRenderMutex->AcquireSync(0, kKeyedMutexTimeoutMs) == S_OK;
+		if (m_openSlotAcquired) {
+			TRACE_ZONE("ClearRenderTargetView");
+			m_pProcessingDeviceContext->OMSetRenderTargets(1, &slot.pRenderRTV, nullptr);
+			m_pProcessingDeviceContext->ClearRenderTargetView(slot.pRenderRTV, color);
+		}
+		if (m_renderTimeline) m_renderTimeline->Mark(kGpuMarkClear);
+	}
+}
+
+// A timed-out slot keeps its previous contents but still advances, so the ring stays in order.
+void D3D11Backend::CloseSharedFrame() {
+	if (m_openSlot < 0) return;
+	if (m_openSlotAcquired) m_sharedSet.slots[m_openSlot].pRenderMutex->ReleaseSync(1);
+	m_sharedRing.EndRender(m_openSlot);
+	m_openSlot = -1;
+	m_openSlotAcquired = false;
+}
+
+// The render device's frame ends here, so the Flush submits its queries too. The display
+// device then copies out the previous frame while this one is still rendering; the very
+// first frame has nothing older, so it is copied directly.
+void D3D11Backend::SubmitSharedFrame() {
+	if (m_openSlot >= 0) {
+		bool acquired = m_openSlotAcquired;
+		CloseSharedFrame();
+		if (m_renderTimeline) m_renderTimeline->Mark(kGpuMarkDraw);
+		if (acquired) {
+			if (m_renderTimeline) m_renderTimeline->EndFrame();
+			TRACE_ZONE("multi-GPU Flush");
+			m_pProcessingDeviceContext->Flush();
+		}
+	}
+
+	for (int due = m_sharedRing.CopiesDue(); due > 0; --due) {
+		if (!CopyReadySharedTexture()) break;
+	}
+	if (m_displayTimeline) m_displayTimeline->Mark(kGpuMarkCopy);
+}
+
+bool D3D11Backend::DrawTarget(ID3D11DeviceContext*& pContext, ID3D11Texture2D*& pTexture) {
+	if (m_isMultiGpu) {
+		if (m_openSlot < 0 || !m_openSlotAcquired) return false;
+		pContext = m_pProcessingDeviceContext;
+		pTexture = m_sharedSet.slots[m_openSlot].pRenderTexture;
+		return true;
+	}
+	BackBufferEntry* pBackBuffer = m_backBuffers.Get(0);
+	if (!m_pDeviceContext || !pBackBuffer || !pBackBuffer->pTexture) return false;
+	pContext = m_pDeviceContext;
+	pTexture = pBackBuffer->pTexture;
+	return true;
+}
+
+// The panel is composed on the CPU and uploaded into this frame's target with a single
+// boxed UpdateSubresource, so it needs no shaders. Each pattern element is composed on
+// the CPU and uploaded as its own small box, like the overlay.
+void D3D11Backend::DrawTestPattern(const TestPattern& pattern) {
+	ID3D11DeviceContext* pContext = nullptr;
+	ID3D11Texture2D* pTexture = nullptr;
+	if (!DrawTarget(pContext, pTexture)) return;
+
+	PatternRegion regions[2];
+	bool present[2] = { pattern.BarcodeRegion(m_width, m_height, regions[0]), pattern.BarRegion(m_width, m_height, regions[1]) };
+	for (int i = 0; i < 2; ++i) {
+		if (!present[i]) continue;
+		const PatternRegion& region = regions[i];
+		m_patternPixels.resize(static_cast<size_t>(region.width) * region.height);
+		if (i == 0) pattern.ComposeBarcode(m_overlayFill, m_patternPixels.data(), region.width, region);
+		else pattern.ComposeBar(m_overlayFill, m_patternPixels.data(), region.width, region);
+
+		D3D11_BOX box = { static_cast<UINT>(region.x), static_cast<UINT>(region.y), 0,
+			static_cast<UINT>(region.x + region.width), static_cast<UINT>(region.y + region.height), 1 };
+		pContext->UpdateSubresource(pTexture, 0, &box, m_patternPixels.data(), region.width * sizeof(uint32_t), 0);
+	}
+}
+
+void D3D11Backend::DrawOverlay(const PerfOverlay& overlay) {
+	const int margin = 16;
+	int width = overlay.Width();
+	int height = overlay.Height();
+	ID3D11DeviceContext* pContext = nullptr;
+	ID3D11Texture2D* pTexture = nullptr;
+	if (width + margin > m_width || height + margin > m_height || !DrawTarget(pContext, pTexture)) return;
+
+	m_overlayPixels.resize(static_cast<size_t>(width) * height);
+	overlay.Compose(m_overlayFill, m_overlayPixels.data(), width, 0, 0);
+
+	D3D11_BOX box = { static_cast<UINT>(margin), static_cast<UINT>(margin), 0, static_cast<UINT>(margin + width), static_cast<UINT>(margin + height), 1 };
+	pContext->UpdateSubresource(pTexture, 0, &box, m_overlayPixels.data(), width * sizeof(uint32_t), 0);
+}
+
+bool D3D11Backend::CopyReadySharedTexture() {
+	int slotIndex = m_sharedRing.BeginCopy();
+	if (slotIndex < 0) return false;
+
+	TRACE_ZONE("multi-GPU CopyResource");
+	SharedSlot& slot = m_sharedSet.slots[slotIndex];
+	if (slot.pDisplayMutex->AcquireSync(1, kKeyedMutexTimeoutMs) == S_OK) {
+		// Pooled textures are bucket-sized; only the top-left back-buffer region is live.
+		BackBufferEntry* pBackBuffer = m_backBuffers.Get(0);
+		if (pBackBuffer && pBackBuffer->pTexture) {
+			D3D11_BOX box = { 0, 0, 0, static_cast<UINT>(m_width), static_cast<UINT>(m_height), 1 };
+			m_pDeviceContext->CopySubresourceRegion(pBackBuffer->pTexture, 0, 0, 0, 0, slot.pDisplayTexture, 0, &box);
+		}
+		slot.pDisplayMutex->ReleaseSync(0);
+	}
+	m_sharedRing.EndCopy(slotIndex);
+	return true;
+}
+
+void D3D11Backend::Present() {
+	if (m_isMultiGpu) SubmitSharedFrame();
+	else if (m_renderTimeline) m_renderTimeline->Mark(kGpuMarkDraw);
+	// Also closes a render-device frame left open by a multi-GPU clear that was skipped.
+	if (m_renderTimeline) m_renderTimeline->EndFrame();
+	if (m_displayTimeline) m_displayTimeline->EndFrame();
+	if (m_pSwapChain) {
+		TRACE_ZONE("IDXGISwapChain::Present");
+		m_pSwapChain->Present(m_presentPlan.syncInterval, m_presentPlan.allowTearing ? DXGI_PRESENT_ALLOW_TEARING : 0);
+	}
+}
+
+void D3D11Backend::SetPresentPlan(const PresentPlan& presentPlan) {
+	PresentPlan plan = presentPlan;
+	plan.allowTearing = plan.allowTearing && (m_swapChainFlags & DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING) != 0;
+	plan.waitOnSwapChain = m_presentPlan.waitOnSwapChain;
+	plan.maxFrameLatency = m_presentPlan.maxFrameLatency;
+	m_presentPlan = plan;
+}
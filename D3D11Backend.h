@@ -0,0 +1,149 @@
+#pragma once
+
+#include <Windows.h>
+#include <d3d11.h>
+#include <dxgi.h>
+#include <dxgi1_5.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BackBufferCache.h"
+#include "D3D11TimestampQueries.h"
+#include "GpuTimestamps.h"
+#include "PresentPolicy.h"
+#include "RenderBackend.h"
+#include "SharedTextureRing.h"
+#include "SizeBucketPool.h"
+#include "SoftwareFill.h"
+#include "TestPattern.h"
+
+// Swap-chain backend for one window. When the render adapter differs from the
+// adapter driving the output, frames are rendered on the render adapter into a
+// ring of keyed-mutex shared textures and copied to the display adapter's back
+// buffer one frame behind, so the two adapters work in parallel. The test pattern
+// and overlay go into the shared texture too, so each presented image is one whole
+// frame; it is just shown one Present late. The shared textures
+// come from a size-bucketed pool, so resizing back to a recent size reuses them.
+// Optional GPU timestamps run on each device's own timeline: the render device
+// times workload, clear and draws, the display device the copy.
+class D3D11Backend : public RenderBackend {
+public:
+	static const DWORD kKeyedMutexTimeoutMs = 100;
+
+	D3D11Backend(HWND hWnd, IDXGIAdapter* pRenderAdapter, IDXGIAdapter* pDisplayAdapter, const PresentPlan& presentPlan, bool borderlessFullscreen, int sharedTextureCount = 3);
+
+	static bool IsTearingSupported(IDXGIAdapter* pAdapter);
+	~D3D11Backend() override;
+
+	bool Init(int width, int height) override;
+	void WaitForPresentSlot() override;
+	void BeginFrame(uint64_t frameIndex, int64_t now) override;
+	void RenderWorkload(int passes) override;
+	void Clear(const float color[4]) override;
+	void DrawTestPattern(const TestPattern& pattern) override;
+	void DrawOverlay(const PerfOverlay& overlay) override;
+	void Present() override;
+	// Multi-GPU copies run one frame behind.
+	int PresentDelayFrames() const override { return m_isMultiGpu ? 1 : 0; }
+	void Resize(int width, int height) override;
+	void Cleanup() override;
+
+	// Swaps sync interval and target between runs; the swap-chain flags stay as created.
+	void SetPresentPlan(const PresentPlan& presentPlan);
+	// New swap chain (window, flags, size) on the existing devices.
+	bool ResetSwapChain(HWND hWnd, const PresentPlan& presentPlan, bool borderlessFullscreen, int width, int height);
+	void ReleaseSwapChain();
+	const PresentPlan& Plan() const { return m_presentPlan; }
+	bool IsMultiGpu() const { return m_isMultiGpu; }
+	ID3D11Device* Device() const { return m_pDevice; }
+	ID3D11DeviceContext* DeviceContext() const { return m_pDeviceContext; }
+	IDXGISwapChain* SwapChain() const { return m_pSwapChain; }
+	const BackBufferCacheStats& BackBufferStats() const { return m_backBuffers.Stats(); }
+	const SizeBucketPoolStats& SharedTextureStats() const { return m_sharedPool.Stats(); }
+
+	// After Init. Restarts the timelines; traced frames go to "<traceName>" on one GPU,
+	// "<traceName> render" and "<traceName> display" across two.
+	bool EnableGpuTimestamps(int64_t cpuFrequency, const std::string& traceName = "GPU");
+	void DisableGpuTimestamps();
+	// Null while disabled; DisplayTimeline() is also null on a single GPU.
+	const GpuTimestampRing* RenderTimeline() const { return m_renderTimeline.get(); }
+	const GpuTimestampRing* DisplayTimeline() const { return m_displayTimeline.get(); }
+
+private:
+	bool CreateDevices();
+	bool CreateSwapChain(int width, int height);
+	void CreateRenderTarget();
+	void CleanupRenderTarget();
+	bool AcquireSharedResources(int width, int height);
+	void ReleaseSharedResources();
+	void CleanupSharedResources();
+	bool CopyReadySharedTexture();
+	// Hands the slot the current frame was drawn into to the display device.
+	void CloseSharedFrame();
+	void SubmitSharedFrame();
+	// Where this frame's pattern and overlay go: the back buffer, or the open shared slot.
+	bool DrawTarget(ID3D11DeviceContext*& pContext, ID3D11Texture2D*& pTexture);
+	bool CreateWorkloadResources();
+	void CleanupWorkloadResources();
+
+	HWND m_hWnd;
+	IDXGIAdapter* m_pRenderAdapter;
+	IDXGIAdapter* m_pDisplayAdapter;
+	PresentPlan m_presentPlan;
+	UINT m_swapChainFlags = 0;
+	HANDLE m_hFrameLatencyWaitable = nullptr;
+	bool m_borderlessFullscreen;
+	bool m_isMultiGpu;
+	int m_width = 0;
+	int m_height = 0;
+
+	ID3D11Device* m_pDevice = nullptr;
+	ID3D11DeviceContext* m_pDeviceContext = nullptr;
+	IDXGISwapChain* m_pSwapChain = nullptr;
+
+	struct BackBufferEntry {
+		ID3D11Texture2D* pTexture = nullptr;
+		ID3D11RenderTargetView* pRTV = nullptr;
+	};
+	BackBufferCache<BackBufferEntry> m_backBuffers;
+
+	ID3D11Device* m_pProcessingDevice = nullptr;
+	ID3D11DeviceContext* m_pProcessingDeviceContext = nullptr;
+	struct SharedSlot {
+		ID3D11Texture2D* pRenderTexture = nullptr;
+		ID3D11RenderTargetView* pRenderRTV = nullptr;
+		IDXGIKeyedMutex* pRenderMutex = nullptr;
+		ID3D11Texture2D* pDisplayTexture = nullptr;
+		IDXGIKeyedMutex* pDisplayMutex = nullptr;
+	};
+	struct SharedTextureSet {
+		SharedSlot slots[SharedTextureRing::kMaxSlots];
+	};
+	bool CreateSharedSet(int width, int height, SharedTextureSet& set);
+	static void DestroySharedSet(SharedTextureSet& set);
+
+	SharedTextureSet m_sharedSet;
+	SizeBucketPool<SharedTextureSet> m_sharedPool;
+	int m_sharedWidth = 0;
+	int m_sharedHeight = 0;
+	SharedTextureRing m_sharedRing;
+	bool m_sharedReady = false;
+	// Slot taken by this frame's Clear, released to the display device in Present.
+	int m_openSlot = -1;
+	bool m_openSlotAcquired = false;
+
+	ID3D11Texture2D* m_pWorkloadTextures[2] = {};
+	ID3D11RenderTargetView* m_pWorkloadRTV = nullptr;
+
+	// Rings after their sources: a ring releases its source's queries on destruction.
+	D3D11TimestampQueries m_renderQueries;
+	D3D11TimestampQueries m_displayQueries;
+	std::unique_ptr<GpuTimestampRing> m_renderTimeline;
+	std::unique_ptr<GpuTimestampRing> m_displayTimeline;
+	std::string m_renderTrackName;
+	std::string m_displayTrackName;
+
+	SoftwareFill m_overlayFill;
+	std::vector<uint32_t> m_overlayPixels;
+	std::vector<uint32_t> m_patternPixels;
+};
@@ -0,0 +1,69 @@
+#include "D3D11TimestampQueries.h"
+
+D3D11TimestampQueries::~D3D11TimestampQueries() {
+	Release();
+}
+
+void D3D11TimestampQueries::SetDevice(ID3D11Device* pDevice, ID3D11DeviceContext* pContext) {
+	m_pDevice = pDevice;
+	m_pContext = pContext;
+}
+
+bool D3D11TimestampQueries::Create(int slotCount) {
+	Release();
+	if (!m_pDevice || !m_pContext || slotCount <= 0 || slotCount > GpuTimestampRing::kMaxSlots) return false;
+
+	D3D11_QUERY_DESC disjointDesc = { D3D11_QUERY_TIMESTAMP_DISJOINT, 0 };
+	D3D11_QUERY_DESC stampDesc = { D3D11_QUERY_TIMESTAMP, 0 };
+	m_slotCount = slotCount;
+	for (int i = 0; i < slotCount; ++i) {
+		Slot& slot = m_slots[i];
+		bool ok = SUCCEEDED(m_pDevice->CreateQuery(&disjointDesc, &slot.pDisjoint));
+		for (int mark = 0; mark < kGpuMarkCount && ok; ++mark) {
+			ok = SUCCEEDED(m_pDevice->CreateQuery(&stampDesc, &slot.pStamps[mark]));
+		}
+		if (!ok) {
+			Release();
+			return false;
+		}
+	}
+	return true;
+}
+
+void D3D11TimestampQueries::Release() {
+	for (int i = 0; i < m_slotCount; ++i) {
+		Slot& slot = m_slots[i];
+		if (slot.pDisjoint) { slot.pDisjoint->Release(); slot.pDisjoint = nullptr; }
+		for (ID3D11Query*& pStamp : slot.pStamps) {
+			if (pStamp) { pStamp->Release(); pStamp = nullptr; }
+		}
+	}
+	m_slotCount = 0;
+}
+
+void D3D11TimestampQueries::Begin(int slot) {
+	m_pContext->Begin(m_slots[slot].pDisjoint);
+}
+
+// Timestamp queries have no Begin; End() writes the GPU clock once prior work completes.
+void D3D11TimestampQueries::Mark(int slot, int mark) {
+	m_pContext->End(m_slots[slot].pStamps[mark]);
+}
+
+void D3D11TimestampQueries::End(int slot) {
+	m_pContext->End(m_slots[slot].pDisjoint);
+}
+
+bool D3D11TimestampQueries::Read(int slot, uint32_t written, uint64_t ticks[kGpuMarkCount], uint64_t& frequency, bool& disjoint) {
+	D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjointData;
+	if (m_pContext->GetData(m_slots[slot].pDisjoint, &disjointData, sizeof(disjointData), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) return false;
+	for (int mark = 0; mark < kGpuMarkCount; ++mark) {
+		if (!(written & (1u << mark))) continue;
+		UINT64 stamp = 0;
+		if (m_pContext->GetData(m_slots[slot].pStamps[mark], &stamp, sizeof(stamp), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) return false;
+		ticks[mark] = stamp;
+	}
+	frequency = disjointData.Frequency;
+	disjoint = disjointData.Disjoint != FALSE;
+	return true;
+}
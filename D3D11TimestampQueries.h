@@ -0,0 +1,36 @@
+#pragma once
+
+#include <d3d11.h>
+#include "GpuTimestamps.h"
+
+// D3D11_QUERY_TIMESTAMP per mark inside a D3D11_QUERY_TIMESTAMP_DISJOINT per slot, all
+// on one device. Reads use D3D11_ASYNC_GETDATA_DONOTFLUSH, so polling never forces
+// a flush or waits on the GPU.
+class D3D11TimestampQueries : public GpuQuerySource {
+public:
+	D3D11TimestampQueries() = default;
+	~D3D11TimestampQueries() override;
+	D3D11TimestampQueries(const D3D11TimestampQueries&) = delete;
+	D3D11TimestampQueries& operator=(const D3D11TimestampQueries&) = delete;
+
+	// Takes effect on the next Create(); the device must outlive the queries.
+	void SetDevice(ID3D11Device* pDevice, ID3D11DeviceContext* pContext);
+
+	bool Create(int slotCount) override;
+	void Release() override;
+	void Begin(int slot) override;
+	void Mark(int slot, int mark) override;
+	void End(int slot) override;
+	bool Read(int slot, uint32_t written, uint64_t ticks[kGpuMarkCount], uint64_t& frequency, bool& disjoint) override;
+
+private:
+	struct Slot {
+		ID3D11Query* pDisjoint = nullptr;
+		ID3D11Query* pStamps[kGpuMarkCount] = {};
+	};
+
+	ID3D11Device* m_pDevice = nullptr;
+	ID3D11DeviceContext* m_pContext = nullptr;
+	Slot m_slots[GpuTimestampRing::kMaxSlots];
+	int m_slotCount = 0;
+};
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+struct EnumerationCacheStats {
+	uint64_t enumerations = 0;
+	uint64_t hits = 0;
+	uint64_t invalidations = 0;
+};
+
+// Keeps the result of an expensive enumeration (adapters, outputs) until something
+// marks it stale, e.g. a display topology change. Invalidate() may be called from
+// any thread; Refresh() and Current() belong to one thread at a time. An Invalidate()
+// that lands while Refresh() is enumerating leaves the new snapshot stale, so the
+// next Refresh() picks up the change.
+template <typename Snapshot>
+class EnumerationCache {
+public:
+	void Invalidate() {
+		m_generation.fetch_add(1, std::memory_order_acq_rel);
+		m_invalidations.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	bool Stale() const {
+		return !m_valid || m_generation.load(std::memory_order_acquire) != m_snapshotGeneration;
+	}
+
+	// Runs enumerate(snapshot) when stale, after release(oldSnapshot). Returns true
+	// when it enumerated.
+	template <typename Enumerate, typename Release>
+	bool Refresh(Enumerate enumerate, Release release) {
+		uint64_t generation = m_generation.load(std::memory_order_acquire);
+		if (m_valid && generation == m_snapshotGeneration) {
+			m_stats.hits++;
+			return false;
+		}
+		Clear(release);
+		enumerate(m_snapshot);
+		m_snapshotGeneration = generation;
+		m_valid = true;
+		m_stats.enumerations++;
+		return true;
+	}
+
+	template <typename Release>
+	void Clear(Release release) {
+		if (m_valid) release(m_snapshot);
+		m_snapshot = Snapshot();
+		m_valid = false;
+	}
+
+	bool Valid() const { return m_valid; }
+	const Snapshot& Current() const { return m_snapshot; }
+	EnumerationCacheStats Stats() const {
+		EnumerationCacheStats stats = m_stats;
+		stats.invalidations = m_invalidations.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+private:
+	Snapshot m_snapshot = Snapshot();
+	bool m_valid = false;
+	uint64_t m_snapshotGeneration = 0;
+	std::atomic<uint64_t> m_generation{ 0 };
+	std::atomic<uint64_t> m_invalidations{ 0 };
+	EnumerationCacheStats m_stats;
+};
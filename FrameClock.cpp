@@ -0,0 +1,94 @@
+#include "FrameClock.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <time.h>
+#include <errno.h>
+#endif
+
+#ifdef _WIN32
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+SystemClock::SystemClock() {
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	m_frequency = frequency.QuadPart;
+
+	m_hTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+	if (!m_hTimer) {
+		m_hTimer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+	}
+}
+
+SystemClock::~SystemClock() {
+	if (m_hTimer) CloseHandle(m_hTimer);
+}
+
+int64_t SystemClock::Now() {
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart;
+}
+
+void SystemClock::SleepUntil(int64_t deadline) {
+	int64_t remaining = deadline - Now();
+	if (remaining <= 0) return;
+
+	// Waitable timers take relative due times in 100ns units.
+	int64_t hundredNs = remaining / m_frequency * 10000000 + (remaining % m_frequency) * 10000000 / m_frequency;
+	if (m_hTimer) {
+		LARGE_INTEGER dueTime;
+		dueTime.QuadPart = -hundredNs;
+		if (SetWaitableTimer(m_hTimer, &dueTime, 0, nullptr, nullptr, FALSE)) {
+			WaitForSingleObject(m_hTimer, INFINITE);
+			return;
+		}
+	}
+	Sleep(static_cast<DWORD>(hundredNs / 10000));
+}
+
+double ProcessCpuSeconds() {
+	FILETIME creationTime, exitTime, kernelTime, userTime;
+	if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) return 0.0;
+	ULARGE_INTEGER kernel, user;
+	kernel.LowPart = kernelTime.dwLowDateTime;
+	kernel.HighPart = kernelTime.dwHighDateTime;
+	user.LowPart = userTime.dwLowDateTime;
+	user.HighPart = userTime.dwHighDateTime;
+	return static_cast<double>(kernel.QuadPart + user.QuadPart) / 10000000.0;
+}
+
+#else
+
+SystemClock::SystemClock() {
+	m_frequency = 1000000000;
+}
+
+SystemClock::~SystemClock() {
+}
+
+int64_t SystemClock::Now() {
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+void SystemClock::SleepUntil(int64_t deadline) {
+	timespec ts;
+	ts.tv_sec = static_cast<time_t>(deadline / 1000000000);
+	ts.tv_nsec = static_cast<long>(deadline % 1000000000);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+	}
+}
+
+double ProcessCpuSeconds() {
+	timespec ts;
+	if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0) return 0.0;
+	return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1e9;
+}
+
+#endif
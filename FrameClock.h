@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+inline void CpuRelax() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+	_mm_pause();
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+	__yield();
+#elif defined(__x86_64__) || defined(__i386__)
+	_mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+	__asm__ __volatile__("yield");
+#endif
+}
+
+// User + kernel CPU time consumed by the whole process, in seconds.
+double ProcessCpuSeconds();
+
+// Monotonic tick source plus the OS sleep primitive the pacer builds on.
+class FrameClock {
+public:
+	virtual ~FrameClock() = default;
+	virtual int64_t Now() = 0;
+	virtual int64_t Frequency() const = 0;
+	virtual void SleepUntil(int64_t deadline) = 0;
+	virtual void Relax() = 0;
+};
+
+// QueryPerformanceCounter + high-resolution waitable timer on Windows,
+// CLOCK_MONOTONIC + clock_nanosleep elsewhere.
+class SystemClock : public FrameClock {
+public:
+	SystemClock();
+	~SystemClock() override;
+	SystemClock(const SystemClock&) = delete;
+	SystemClock& operator=(const SystemClock&) = delete;
+
+	int64_t Now() override;
+	int64_t Frequency() const override { return m_frequency; }
+	void SleepUntil(int64_t deadline) override;
+	void Relax() override { CpuRelax(); }
+
+private:
+	int64_t m_frequency = 0;
+#ifdef _WIN32
+	void* m_hTimer = nullptr;
+#endif
+};
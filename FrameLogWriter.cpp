@@ -0,0 +1,110 @@
+#include "FrameLogWriter.h"
+#include <chrono>
+#include <cstring>
+#include <vector>
+#include "Tracer.h"
+
+std::string TaggedFrameLogPath(const std::string& path, const std::string& tag) {
+	size_t slash = path.find_last_of("/\\");
+	size_t dot = path.find_last_of('.');
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) dot = path.size();
+	return path.substr(0, dot) + "." + tag + path.substr(dot);
+}
+
+FrameLogFormat FrameLogFormatForPath(const std::string& path) {
+	const char* extension = ".csv";
+	if (path.size() < 4) return FrameLogFormat::Binary;
+	for (size_t i = 0; i < 4; ++i) {
+		char c = path[path.size() - 4 + i];
+		if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+		if (c != extension[i]) return FrameLogFormat::Binary;
+	}
+	return FrameLogFormat::Csv;
+}
+
+FrameLogWriter::~FrameLogWriter() {
+	Close();
+}
+
+bool FrameLogWriter::Open(const std::string& path, FrameLogFormat format, int64_t frequency) {
+	Close();
+	// A Push() that raced the last Close() can leave records behind; they belong to the
+	// previous log, so drop them before the writer can put them in this one.
+	std::vector<FrameRecord> stale(kBatchSize);
+	while (m_queue.PopBatch(stale.data(), kBatchSize)) {
+	}
+
+#ifdef _MSC_VER
+	if (fopen_s(&m_file, path.c_str(), format == FrameLogFormat::Binary ? "wb" : "w") != 0) m_file = nullptr;
+#else
+	m_file = fopen(path.c_str(), format == FrameLogFormat::Binary ? "wb" : "w");
+#endif
+	if (!m_file) return false;
+
+	m_format = format;
+	m_dropped.store(0, std::memory_order_relaxed);
+	m_written.store(0, std::memory_order_relaxed);
+
+	if (format == FrameLogFormat::Binary) {
+		FrameLogHeader header = {};
+		memcpy(header.magic, "CFPSLOG", 8);
+		header.version = 1;
+		header.recordSize = sizeof(FrameRecord);
+		header.frequency = frequency;
+		fwrite(&header, sizeof(header), 1, m_file);
+	}
+	else {
+		fprintf(m_file, "# frequency=%lld\n", static_cast<long long>(frequency));
+		fprintf(m_file, "frame,deadline,wake,submit,present,interval\n");
+	}
+
+	m_running.store(true, std::memory_order_release);
+	m_thread = std::thread(&FrameLogWriter::Run, this);
+	m_open.store(true, std::memory_order_release);
+	return true;
+}
+
+void FrameLogWriter::Close() {
+	if (!m_file) return;
+
+	m_open.store(false, std::memory_order_release);
+	m_running.store(false, std::memory_order_release);
+	if (m_thread.joinable()) m_thread.join();
+
+	std::vector<FrameRecord> batch(kBatchSize);
+	while (Drain(batch.data())) {
+	}
+	fclose(m_file);
+	m_file = nullptr;
+}
+
+void FrameLogWriter::Run() {
+	TRACE_THREAD_NAME("frame log");
+	std::vector<FrameRecord> batch(kBatchSize);
+	while (m_running.load(std::memory_order_acquire)) {
+		if (!Drain(batch.data())) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+	}
+}
+
+size_t FrameLogWriter::Drain(FrameRecord* batch) {
+	size_t count = m_queue.PopBatch(batch, kBatchSize);
+	if (count) WriteBatch(batch, count);
+	return count;
+}
+
+void FrameLogWriter::WriteBatch(const FrameRecord* batch, size_t count) {
+	if (m_format == FrameLogFormat::Binary) {
+		fwrite(batch, sizeof(FrameRecord), count, m_file);
+	}
+	else {
+		for (size_t i = 0; i < count; ++i) {
+			const FrameRecord& r = batch[i];
+			fprintf(m_file, "%llu,%lld,%lld,%lld,%lld,%lld\n", static_cast<unsigned long long>(r.frameIndex),
+				static_cast<long long>(r.deadline), static_cast<long long>(r.wake), static_cast<long long>(r.submit),
+				static_cast<long long>(r.present), static_cast<long long>(r.interval));
+		}
+	}
+	m_written.fetch_add(count, std::memory_order_relaxed);
+}
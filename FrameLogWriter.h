@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include "FrameTelemetry.h"
+#include "SpscQueue.h"
+
+enum class FrameLogFormat {
+	Binary,
+	Csv
+};
+
+// Binary log layout: FrameLogHeader followed by raw FrameRecord entries.
+struct FrameLogHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t recordSize;
+	int64_t frequency;
+};
+
+// "frames.csv" + "cell2" -> "frames.cell2.csv", for runs that log to several files.
+std::string TaggedFrameLogPath(const std::string& path, const std::string& tag);
+// Csv for a ".csv" path in any case, Binary for anything else.
+FrameLogFormat FrameLogFormatForPath(const std::string& path);
+
+// Streams frame records to disk from a background thread. Push() never blocks
+// or allocates; when the queue is full the record is counted as dropped.
+// Push() is the queue's single producer. Open() and Close() must not run while a
+// Push() can: call them before the producer thread starts and after it is joined.
+// A Push() that still races Close() sees the log closed and is ignored, but its
+// record may be left in the queue; the next Open() discards it.
+class FrameLogWriter {
+public:
+	static const size_t kQueueCapacity = 16384;
+	static const size_t kBatchSize = 1024;
+
+	FrameLogWriter() = default;
+	~FrameLogWriter();
+	FrameLogWriter(const FrameLogWriter&) = delete;
+	FrameLogWriter& operator=(const FrameLogWriter&) = delete;
+
+	bool Open(const std::string& path, FrameLogFormat format, int64_t frequency);
+	void Close();
+	bool IsOpen() const { return m_open.load(std::memory_order_acquire); }
+
+	void Push(const FrameRecord& record) {
+		if (!m_open.load(std::memory_order_acquire)) return;
+		if (!m_queue.TryPush(record)) m_dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	uint64_t Dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+	uint64_t Written() const { return m_written.load(std::memory_order_relaxed); }
+
+private:
+	void Run();
+	size_t Drain(FrameRecord* batch);
+	void WriteBatch(const FrameRecord* batch, size_t count);
+
+	SpscQueue<FrameRecord, kQueueCapacity> m_queue;
+	std::thread m_thread;
+	std::atomic<bool> m_running{ false };
+	// Push() reads this instead of m_file, which only Open(), Close() and the writer touch.
+	std::atomic<bool> m_open{ false };
+	std::atomic<uint64_t> m_dropped{ 0 };
+	std::atomic<uint64_t> m_written{ 0 };
+	FILE* m_file = nullptr;
+	FrameLogFormat m_format = FrameLogFormat::Binary;
+};
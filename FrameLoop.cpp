@@ -0,0 +1,94 @@
+#include "FrameLoop.h"
+
+#include "Tracer.h"
+
+FrameLoop::FrameLoop(RenderBackend& backend, FrameClock& clock, int targetFps, CatchUpPolicy policy)
+	: m_backend(backend), m_clock(clock), m_pacer(clock), m_scheduler(clock.Frequency(), targetFps, policy),
+	m_statistics(clock.Frequency()) {
+}
+
+// The wake granularity is measured once per loop, so the timer resolution a session
+// runs under must already be in place.
+void FrameLoop::Start() {
+	// SetCalibration resets the pacer itself.
+	if (!m_pacer.Calibrated()) m_pacer.SetCalibration(CalibrateWakeGranularity(m_clock));
+	else m_pacer.Reset();
+	m_statistics.Reset(m_clock.Frequency());
+	m_history.Clear();
+	m_lastPresent = 0;
+	m_flashPresentsLeft = -1;
+	m_patternFrame = 0;
+	m_scheduler.Start(m_clock.Now());
+}
+
+void FrameLoop::SetClearColor(const float color[4]) {
+	for (int i = 0; i < 4; ++i) m_clearColor[i] = color[i];
+}
+
+const FrameRecord& FrameLoop::RunFrame() {
+	TRACE_ZONE("frame");
+	FrameRecord record;
+	record.deadline = m_scheduler.NextDeadline(m_clock.Now());
+	record.frameIndex = m_scheduler.FrameIndex();
+	{
+		TRACE_ZONE("wait present slot");
+		m_backend.WaitForPresentSlot();
+	}
+	{
+		TRACE_ZONE("pace");
+		record.wake = m_cpuLimiter ? m_pacer.WaitUntil(record.deadline) : m_clock.Now();
+	}
+	m_backend.BeginFrame(record.frameIndex, record.wake);
+
+	if (m_pLoad && m_pLoad->IsActive()) {
+		TRACE_ZONE("synthetic load");
+		double scale = m_pLoad->ScaleForFrame(record.frameIndex);
+		m_pLoad->RunCpuLoad(scale);
+		m_backend.RenderWorkload(m_pLoad->RenderPasses(scale));
+	}
+	bool flash = m_pLatency && m_pLatency->BeginFrame(record.frameIndex, m_clock.Now());
+	const float* pClearColor = m_clearColor;
+	float patternColor[4];
+	if (m_pPattern) {
+		m_pPattern->SetFrame(m_patternFrame++);
+		if (m_pPattern->ClearColor(patternColor)) pClearColor = patternColor;
+	}
+	{
+		TRACE_ZONE("clear");
+		m_backend.Clear(flash ? m_flashColor : pClearColor);
+	}
+	if (m_pPattern) {
+		TRACE_ZONE("test pattern");
+		m_backend.DrawTestPattern(*m_pPattern);
+	}
+	if (m_pOverlay) {
+		TRACE_ZONE("overlay");
+		int64_t overlayStart = m_clock.Now();
+		m_pOverlay->Refresh(m_statistics, m_scheduler.TargetFps(), overlayStart);
+		m_backend.DrawOverlay(*m_pOverlay);
+		m_pOverlay->AddCost(m_clock.Now() - overlayStart);
+	}
+	record.submit = m_clock.Now();
+	if (flash) {
+		m_pLatency->OnSubmit(record.submit);
+		m_flashPresentsLeft = m_backend.PresentDelayFrames();
+	}
+	{
+		TRACE_ZONE("present");
+		m_backend.Present();
+	}
+	record.present = m_clock.Now();
+	// A backend that presents frames late only shows the flash some presents later.
+	if (m_flashPresentsLeft == 0 && m_pLatency) m_pLatency->OnPresent(record.present);
+	if (m_flashPresentsLeft >= 0) m_flashPresentsLeft--;
+
+	record.interval = m_lastPresent ? record.present - m_lastPresent : 0;
+	m_lastPresent = record.present;
+	if (record.interval > 0) m_statistics.Add(record.interval);
+	if (m_pOverlay) m_pOverlay->AddFrame(record.interval);
+	m_history.Push(record);
+	if (m_pFrameLog) m_pFrameLog->Push(record);
+
+	m_scheduler.Advance();
+	return m_history.Latest();
+}
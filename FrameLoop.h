@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include "FrameClock.h"
+#include "FrameLogWriter.h"
+#include "FramePacer.h"
+#include "FrameScheduler.h"
+#include "FrameStatistics.h"
+#include "FrameTelemetry.h"
+#include "LatencyProbe.h"
+#include "LoadGenerator.h"
+#include "PerfOverlay.h"
+#include "RenderBackend.h"
+#include "TestPattern.h"
+
+// One paced frame: wait for a present slot and the deadline, run any synthetic load,
+// clear (or flash for a pending latency input), stamp the test pattern, draw the
+// overlay, present, record timings. The pattern counter counts rendered frames since
+// Start(), independent of scheduler skips and retargets.
+// Drives any RenderBackend, so the Win32 loop and headless runs share it.
+class FrameLoop {
+public:
+	FrameLoop(RenderBackend& backend, FrameClock& clock, int targetFps, CatchUpPolicy policy = CatchUpPolicy::Skip);
+
+	void Start();
+	const FrameRecord& RunFrame();
+
+	void SetClearColor(const float color[4]);
+	void SetFrameLog(FrameLogWriter* pFrameLog) { m_pFrameLog = pFrameLog; }
+	void SetLoadGenerator(LoadGenerator* pLoad) { m_pLoad = pLoad; }
+	void SetLatencyProbe(LatencyProbe* pLatency) { m_pLatency = pLatency; }
+	void SetOverlay(PerfOverlay* pOverlay) { m_pOverlay = pOverlay; }
+	void SetTestPattern(TestPattern* pPattern) { m_pPattern = pPattern; }
+	TestPattern* Pattern() const { return m_pPattern; }
+	PerfOverlay* Overlay() const { return m_pOverlay; }
+	// Without the CPU limiter, vsync alone paces frames.
+	void SetCpuLimiter(bool enabled) { m_cpuLimiter = enabled; }
+	bool CpuLimiter() const { return m_cpuLimiter; }
+
+	RenderBackend& Backend() { return m_backend; }
+	FrameClock& Clock() { return m_clock; }
+	FramePacer& Pacer() { return m_pacer; }
+	FrameScheduler& Scheduler() { return m_scheduler; }
+	FrameStatistics& Statistics() { return m_statistics; }
+	const FrameRing<FrameRecord, 4096>& History() const { return m_history; }
+
+private:
+	RenderBackend& m_backend;
+	FrameClock& m_clock;
+	FramePacer m_pacer;
+	FrameScheduler m_scheduler;
+	FrameStatistics m_statistics;
+	FrameRing<FrameRecord, 4096> m_history;
+	FrameLogWriter* m_pFrameLog = nullptr;
+	LoadGenerator* m_pLoad = nullptr;
+	LatencyProbe* m_pLatency = nullptr;
+	PerfOverlay* m_pOverlay = nullptr;
+	TestPattern* m_pPattern = nullptr;
+	uint64_t m_patternFrame = 0;
+	float m_clearColor[4] = { 13.0f / 255.0f, 71.0f / 255.0f, 161.0f / 255.0f, 1.0f };
+	float m_flashColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	int64_t m_lastPresent = 0;
+	// Presents left until the flash frame's image is on the swap chain, -1 when none is.
+	int m_flashPresentsLeft = -1;
+	bool m_cpuLimiter = true;
+};
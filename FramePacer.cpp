@@ -0,0 +1,70 @@
+#include "FramePacer.h"
+
+namespace {
+	const double kOvershootGain = 1.0 / 8.0;
+	const double kDeviationGain = 1.0 / 4.0;
+}
+
+FramePacer::FramePacer(FrameClock& clock) : m_clock(clock) {
+	Reset();
+}
+
+void FramePacer::Reset() {
+	const int64_t frequency = m_clock.Frequency();
+	m_minMargin = frequency / 20000;
+	m_maxMargin = frequency / 250;
+	m_overshootMean = static_cast<double>(frequency / 1000);
+	m_overshootDev = static_cast<double>(frequency / 4000);
+	m_margin = frequency / 500;
+	m_stats = PacerStats();
+
+	if (Calibrated()) {
+		const TimerCalibration& calibration = m_calibration;
+		if (m_maxMargin < 2 * calibration.granularity) m_maxMargin = 2 * calibration.granularity;
+		m_overshootMean = static_cast<double>(calibration.medianOvershoot);
+		m_overshootDev = static_cast<double>(calibration.granularity - calibration.medianOvershoot) / 4.0;
+		m_margin = calibration.granularity;
+		if (m_margin < m_minMargin) m_margin = m_minMargin;
+		if (m_margin > m_maxMargin) m_margin = m_maxMargin;
+	}
+}
+
+void FramePacer::SetCalibration(const TimerCalibration& calibration) {
+	m_calibration = calibration;
+	Reset();
+}
+
+void FramePacer::LearnOvershoot(int64_t overshoot) {
+	double error = static_cast<double>(overshoot) - m_overshootMean;
+	m_overshootMean += kOvershootGain * error;
+	m_overshootDev += kDeviationGain * ((error < 0 ? -error : error) - m_overshootDev);
+
+	int64_t margin = static_cast<int64_t>(m_overshootMean + 4.0 * m_overshootDev);
+	if (margin < m_minMargin) margin = m_minMargin;
+	if (margin > m_maxMargin) margin = m_maxMargin;
+	m_margin = margin;
+}
+
+int64_t FramePacer::WaitUntil(int64_t deadline) {
+	m_stats.waits++;
+
+	int64_t now = m_clock.Now();
+	int64_t sleepTarget = deadline - m_margin;
+	if (now < sleepTarget) {
+		m_clock.SleepUntil(sleepTarget);
+		int64_t woke = m_clock.Now();
+		LearnOvershoot(woke - sleepTarget);
+		m_stats.sleeps++;
+		m_stats.sleepTicks += woke - now;
+		now = woke;
+	}
+
+	int64_t spinStart = now;
+	while (now < deadline) {
+		m_clock.Relax();
+		now = m_clock.Now();
+	}
+	m_stats.spinTicks += now - spinStart;
+	m_stats.lateTicks += now - deadline;
+	return now;
+}
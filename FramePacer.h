@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include "FrameClock.h"
+#include "TimerResolution.h"
+
+struct PacerStats {
+	uint64_t waits = 0;
+	uint64_t sleeps = 0;
+	int64_t sleepTicks = 0;
+	int64_t spinTicks = 0;
+	int64_t lateTicks = 0;
+};
+
+// Sleeps coarsely until a learned margin before the deadline, then spins the rest.
+// The margin tracks the OS wake-up overshoot (mean + 4 * mean deviation), between
+// 50 us and 4 ms. A calibration seeds it at the measured wake granularity and raises
+// the ceiling to max(4 ms, 2 * granularity), so coarse timers do not make the first
+// frames late.
+class FramePacer {
+public:
+	explicit FramePacer(FrameClock& clock);
+
+	int64_t WaitUntil(int64_t deadline);
+	void Reset();
+	// Kept across Reset().
+	void SetCalibration(const TimerCalibration& calibration);
+	bool Calibrated() const { return m_calibration.samples > 0; }
+	const TimerCalibration& Calibration() const { return m_calibration; }
+
+	int64_t SleepMargin() const { return m_margin; }
+	const PacerStats& Stats() const { return m_stats; }
+
+private:
+	void LearnOvershoot(int64_t overshoot);
+
+	FrameClock& m_clock;
+	int64_t m_minMargin;
+	int64_t m_maxMargin;
+	int64_t m_margin;
+	double m_overshootMean;
+	double m_overshootDev;
+	TimerCalibration m_calibration;
+	PacerStats m_stats;
+};
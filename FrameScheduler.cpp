@@ -0,0 +1,69 @@
+#include "FrameScheduler.h"
+
+FrameScheduler::FrameScheduler(int64_t frequency, int targetFps, CatchUpPolicy policy)
+	: m_frequency(frequency), m_targetFps(targetFps > 0 ? targetFps : 1), m_policy(policy) {
+}
+
+void FrameScheduler::Start(int64_t now) {
+	m_anchor = now;
+	m_frameIndex = 0;
+	m_bursting = false;
+}
+
+void FrameScheduler::SetTargetFps(int targetFps, int64_t now) {
+	m_targetFps = targetFps > 0 ? targetFps : 1;
+	Start(now);
+}
+
+int64_t FrameScheduler::Deadline(uint64_t frameIndex) const {
+	// Split the product so n * frequency cannot overflow on long soak runs.
+	uint64_t fps = static_cast<uint64_t>(m_targetFps);
+	uint64_t frequency = static_cast<uint64_t>(m_frequency);
+	uint64_t offset = (frameIndex / fps) * frequency + (frameIndex % fps) * frequency / fps;
+	return m_anchor + static_cast<int64_t>(offset);
+}
+
+uint64_t FrameScheduler::FirstFrameAtOrAfter(int64_t time) const {
+	if (time <= m_anchor) return 0;
+	uint64_t elapsed = static_cast<uint64_t>(time - m_anchor);
+	uint64_t fps = static_cast<uint64_t>(m_targetFps);
+	uint64_t frequency = static_cast<uint64_t>(m_frequency);
+	uint64_t frameIndex = (elapsed / frequency) * fps + (elapsed % frequency) * fps / frequency;
+	while (Deadline(frameIndex) < time) frameIndex++;
+	return frameIndex;
+}
+
+int64_t FrameScheduler::NextDeadline(int64_t now) {
+	int64_t deadline = Deadline(m_frameIndex);
+	int64_t lateness = now - deadline;
+	int64_t period = PeriodTicks();
+	if (lateness < period) {
+		m_bursting = false;
+		return deadline;
+	}
+
+	if (m_policy == CatchUpPolicy::Reanchor || lateness >= period * m_stallFrames) {
+		m_reanchors++;
+		Start(now);
+		return m_anchor;
+	}
+
+	if (m_policy == CatchUpPolicy::Burst) {
+		if (!m_bursting) {
+			m_bursting = true;
+			m_burstRemaining = m_maxBurst;
+		}
+		if (m_burstRemaining > 0) {
+			m_burstRemaining--;
+			m_burstFrames++;
+			return deadline;
+		}
+	}
+
+	// Drop every slot that has already passed and render into the most recent one.
+	uint64_t target = FirstFrameAtOrAfter(now);
+	if (Deadline(target) > now) target--;
+	m_skippedFrames += target - m_frameIndex;
+	m_frameIndex = target;
+	return Deadline(m_frameIndex);
+}
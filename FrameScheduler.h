@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+
+enum class CatchUpPolicy {
+	Skip,
+	Burst,
+	Reanchor
+};
+
+// Absolute deadline grid: deadline(n) = t0 + n * frequency / targetFps, in integer ticks,
+// so lateness on one frame never shifts the frames after it.
+class FrameScheduler {
+public:
+	FrameScheduler(int64_t frequency, int targetFps, CatchUpPolicy policy = CatchUpPolicy::Skip);
+
+	void Start(int64_t now);
+	int64_t NextDeadline(int64_t now);
+	void Advance() { m_frameIndex++; }
+
+	void SetTargetFps(int targetFps, int64_t now);
+	void SetPolicy(CatchUpPolicy policy) { m_policy = policy; }
+	void SetMaxBurst(int maxBurst) { m_maxBurst = maxBurst; }
+	void SetStallFrames(int stallFrames) { m_stallFrames = stallFrames; }
+
+	int64_t Deadline(uint64_t frameIndex) const;
+	int64_t PeriodTicks() const { return m_frequency / m_targetFps; }
+	int TargetFps() const { return m_targetFps; }
+	uint64_t FrameIndex() const { return m_frameIndex; }
+	uint64_t SkippedFrames() const { return m_skippedFrames; }
+	uint64_t BurstFrames() const { return m_burstFrames; }
+	uint64_t Reanchors() const { return m_reanchors; }
+
+private:
+	uint64_t FirstFrameAtOrAfter(int64_t time) const;
+
+	int64_t m_frequency;
+	int m_targetFps;
+	CatchUpPolicy m_policy;
+	int m_maxBurst = 4;
+	int m_stallFrames = 30;
+
+	int64_t m_anchor = 0;
+	uint64_t m_frameIndex = 0;
+	bool m_bursting = false;
+	int m_burstRemaining = 0;
+	uint64_t m_skippedFrames = 0;
+	uint64_t m_burstFrames = 0;
+	uint64_t m_reanchors = 0;
+};
@@ -0,0 +1,137 @@
+#include "FrameStatistics.h"
+#include <cmath>
+#include <cstdio>
+
+FrameStatistics::FrameStatistics(int64_t frequency) : m_frequency(frequency) {
+}
+
+void FrameStatistics::Reset() {
+	m_count = 0;
+	m_mean = 0.0;
+	m_m2 = 0.0;
+	m_min = 0;
+	m_max = 0;
+	m_buckets.fill(0);
+}
+
+void FrameStatistics::Reset(int64_t frequency) {
+	m_frequency = frequency;
+	Reset();
+}
+
+int FrameStatistics::BucketIndex(uint64_t nanoseconds) {
+	if (nanoseconds < static_cast<uint64_t>(kSubBucketCount)) return static_cast<int>(nanoseconds);
+
+	int exponent = 63;
+	while (!(nanoseconds >> exponent)) exponent--;
+	if (exponent > kMaxExponent) return kBucketCount - 1;
+
+	int shift = exponent - kSubBucketBits;
+	int subBucket = static_cast<int>((nanoseconds >> shift) & (kSubBucketCount - 1));
+	return kSubBucketCount + shift * kSubBucketCount + subBucket;
+}
+
+double FrameStatistics::BucketValue(int index) {
+	if (index < kSubBucketCount) return static_cast<double>(index);
+
+	int shift = (index - kSubBucketCount) / kSubBucketCount;
+	int subBucket = (index - kSubBucketCount) % kSubBucketCount;
+	double lower = std::ldexp(static_cast<double>(kSubBucketCount + subBucket), shift);
+	return lower + std::ldexp(0.5, shift);
+}
+
+void FrameStatistics::Add(int64_t intervalTicks) {
+	if (intervalTicks < 0) intervalTicks = 0;
+	uint64_t ticks = static_cast<uint64_t>(intervalTicks);
+	uint64_t frequency = static_cast<uint64_t>(m_frequency);
+	uint64_t nanoseconds = ticks / frequency * 1000000000 + ticks % frequency * 1000000000 / frequency;
+
+	m_count++;
+	double value = static_cast<double>(nanoseconds);
+	double delta = value - m_mean;
+	m_mean += delta / static_cast<double>(m_count);
+	m_m2 += delta * (value - m_mean);
+
+	if (m_count == 1 || nanoseconds < m_min) m_min = nanoseconds;
+	if (nanoseconds > m_max) m_max = nanoseconds;
+	m_buckets[BucketIndex(nanoseconds)]++;
+}
+
+double FrameStatistics::StddevMs() const {
+	if (m_count < 2) return 0.0;
+	return std::sqrt(m_m2 / static_cast<double>(m_count - 1)) / 1e6;
+}
+
+double FrameStatistics::QuantileMs(double quantile) const {
+	if (m_count == 0) return 0.0;
+	if (quantile <= 0.0) return m_min / 1e6;
+	if (quantile >= 1.0) return m_max / 1e6;
+
+	uint64_t rank = static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(m_count)));
+	uint64_t seen = 0;
+	for (int i = 0; i < kBucketCount; ++i) {
+		seen += m_buckets[i];
+		if (seen >= rank) {
+			double value = BucketValue(i);
+			if (value < static_cast<double>(m_min)) value = static_cast<double>(m_min);
+			if (value > static_cast<double>(m_max)) value = static_cast<double>(m_max);
+			return value / 1e6;
+		}
+	}
+	return m_max / 1e6;
+}
+
+// Average frame rate over the slowest `fraction` of frames ("1% low" for 0.01).
+double FrameStatistics::LowFps(double fraction) const {
+	if (m_count == 0) return 0.0;
+
+	uint64_t wanted = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(m_count)));
+	if (wanted == 0) wanted = 1;
+
+	uint64_t taken = 0;
+	double total = 0.0;
+	for (int i = kBucketCount - 1; i >= 0 && taken < wanted; --i) {
+		if (!m_buckets[i]) continue;
+		uint64_t n = m_buckets[i] < wanted - taken ? m_buckets[i] : wanted - taken;
+		double value = i == BucketIndex(m_max) ? static_cast<double>(m_max) : BucketValue(i);
+		total += value * static_cast<double>(n);
+		taken += n;
+	}
+	return total > 0.0 ? 1e9 * static_cast<double>(taken) / total : 0.0;
+}
+
+FrameSummary FrameStatistics::Summary() const {
+	FrameSummary summary;
+	summary.frames = m_count;
+	if (m_count == 0) return summary;
+
+	summary.meanMs = MeanMs();
+	summary.stddevMs = StddevMs();
+	summary.minMs = m_min / 1e6;
+	summary.maxMs = m_max / 1e6;
+	summary.p50Ms = QuantileMs(0.50);
+	summary.p95Ms = QuantileMs(0.95);
+	summary.p99Ms = QuantileMs(0.99);
+	summary.p999Ms = QuantileMs(0.999);
+	summary.averageFps = m_mean > 0.0 ? 1e9 / m_mean : 0.0;
+	summary.low1Fps = LowFps(0.01);
+	summary.low01Fps = LowFps(0.001);
+	return summary;
+}
+
+std::string FormatFrameSummary(const FrameSummary& summary) {
+	char buffer[512];
+	snprintf(buffer, sizeof(buffer),
+		"frames=%llu avg=%.2f fps mean=%.3f ms stddev=%.3f ms min=%.3f ms p50=%.3f ms p95=%.3f ms p99=%.3f ms p99.9=%.3f ms max=%.3f ms 1%%low=%.2f fps 0.1%%low=%.2f fps",
+		static_cast<unsigned long long>(summary.frames), summary.averageFps, summary.meanMs, summary.stddevMs,
+		summary.minMs, summary.p50Ms, summary.p95Ms, summary.p99Ms, summary.p999Ms, summary.maxMs,
+		summary.low1Fps, summary.low01Fps);
+	return buffer;
+}
+
+std::string FormatDurationSummary(const FrameSummary& summary) {
+	char buffer[192];
+	snprintf(buffer, sizeof(buffer), "count=%llu mean=%.3f ms p50=%.3f ms p99=%.3f ms max=%.3f ms",
+		static_cast<unsigned long long>(summary.frames), summary.meanMs, summary.p50Ms, summary.p99Ms, summary.maxMs);
+	return buffer;
+}
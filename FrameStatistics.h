@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+struct FrameSummary {
+	uint64_t frames = 0;
+	double meanMs = 0.0;
+	double stddevMs = 0.0;
+	double minMs = 0.0;
+	double maxMs = 0.0;
+	double p50Ms = 0.0;
+	double p95Ms = 0.0;
+	double p99Ms = 0.0;
+	double p999Ms = 0.0;
+	double averageFps = 0.0;
+	double low1Fps = 0.0;
+	double low01Fps = 0.0;
+};
+
+// Streaming frametime statistics. Quantiles come from a log-linear histogram
+// (64 sub-buckets per power of two, under 1% relative error), so memory stays
+// constant no matter how long the session runs.
+class FrameStatistics {
+public:
+	static const int kSubBucketBits = 6;
+	static const int kSubBucketCount = 1 << kSubBucketBits;
+	static const int kMaxExponent = 40;
+	static const int kBucketCount = kSubBucketCount + (kMaxExponent - kSubBucketBits + 1) * kSubBucketCount;
+
+	explicit FrameStatistics(int64_t frequency = 1000000000);
+
+	void Reset();
+	void Reset(int64_t frequency);
+	void Add(int64_t intervalTicks);
+
+	uint64_t Count() const { return m_count; }
+	double MeanMs() const { return m_mean / 1e6; }
+	double StddevMs() const;
+	double QuantileMs(double quantile) const;
+	double LowFps(double fraction) const;
+	FrameSummary Summary() const;
+
+private:
+	static int BucketIndex(uint64_t nanoseconds);
+	static double BucketValue(int index);
+
+	int64_t m_frequency;
+	uint64_t m_count = 0;
+	double m_mean = 0.0;
+	double m_m2 = 0.0;
+	uint64_t m_min = 0;
+	uint64_t m_max = 0;
+	std::array<uint64_t, kBucketCount> m_buckets{};
+};
+
+std::string FormatFrameSummary(const FrameSummary& summary);
+// For intervals that are costs rather than frametimes: no fps or low figures.
+std::string FormatDurationSummary(const FrameSummary& summary);
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Per-frame timestamps, all in FrameClock ticks.
+struct FrameRecord {
+	uint64_t frameIndex = 0;
+	int64_t deadline = 0;
+	int64_t wake = 0;
+	int64_t submit = 0;
+	int64_t present = 0;
+	int64_t interval = 0;
+};
+
+// Fixed-capacity history that overwrites the oldest entry; never allocates.
+template <typename T, size_t Capacity>
+class FrameRing {
+	static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "FrameRing capacity must be a power of two");
+
+public:
+	void Push(const T& value) {
+		m_items[m_head & (Capacity - 1)] = value;
+		m_head++;
+	}
+
+	void Clear() { m_head = 0; }
+	size_t Size() const { return m_head < Capacity ? static_cast<size_t>(m_head) : Capacity; }
+	bool Empty() const { return m_head == 0; }
+	static constexpr size_t MaxSize() { return Capacity; }
+	uint64_t TotalPushed() const { return m_head; }
+
+	// Oldest retained entry is index 0.
+	const T& operator[](size_t index) const { return m_items[(m_head - Size() + index) & (Capacity - 1)]; }
+	const T& Latest() const { return m_items[(m_head - 1) & (Capacity - 1)]; }
+
+private:
+	std::array<T, Capacity> m_items{};
+	uint64_t m_head = 0;
+};
@@ -0,0 +1,102 @@
+#include "GlyphAtlas.h"
+
+namespace {
+	struct GlyphBits {
+		char character;
+		uint8_t rows[GlyphAtlas::kGlyphHeight];
+	};
+
+	// One byte per row, bit 4 is the leftmost column.
+	const GlyphBits kFont[] = {
+		{ '0', { 0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E } },
+		{ '1', { 0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+		{ '2', { 0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F } },
+		{ '3', { 0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E } },
+		{ '4', { 0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02 } },
+		{ '5', { 0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E } },
+		{ '6', { 0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E } },
+		{ '7', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 } },
+		{ '8', { 0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E } },
+		{ '9', { 0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C } },
+		{ 'A', { 0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11 } },
+		{ 'B', { 0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E } },
+		{ 'C', { 0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E } },
+		{ 'D', { 0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C } },
+		{ 'E', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F } },
+		{ 'F', { 0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10 } },
+		{ 'G', { 0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F } },
+		{ 'H', { 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11 } },
+		{ 'I', { 0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E } },
+		{ 'J', { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C } },
+		{ 'K', { 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 } },
+		{ 'L', { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F } },
+		{ 'M', { 0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11 } },
+		{ 'N', { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 } },
+		{ 'O', { 0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+		{ 'P', { 0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10 } },
+		{ 'Q', { 0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D } },
+		{ 'R', { 0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11 } },
+		{ 'S', { 0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E } },
+		{ 'T', { 0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 } },
+		{ 'U', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E } },
+		{ 'V', { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04 } },
+		{ 'W', { 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A } },
+		{ 'X', { 0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11 } },
+		{ 'Y', { 0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04 } },
+		{ 'Z', { 0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F } },
+		{ '.', { 0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C } },
+		{ ':', { 0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00 } },
+		{ '%', { 0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03 } },
+		{ '/', { 0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00 } },
+		{ '-', { 0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00 } },
+		{ '(', { 0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02 } },
+		{ ')', { 0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08 } },
+	};
+
+	int GlyphIndex(char character) {
+		if (character >= 'a' && character <= 'z') character = static_cast<char>(character - 'a' + 'A');
+		unsigned char code = static_cast<unsigned char>(character);
+		if (code < 32 || code > 127) return 0;
+		return code - 32;
+	}
+}
+
+GlyphAtlas::GlyphAtlas(int scale) : m_scale(scale > 0 ? scale : 1) {
+	for (const GlyphBits& glyph : kFont) {
+		GlyphRange& range = m_glyphs[GlyphIndex(glyph.character)];
+		range.first = static_cast<uint16_t>(m_runs.size());
+		for (int row = 0; row < kGlyphHeight; ++row) {
+			int column = 0;
+			while (column < kGlyphWidth) {
+				if (!(glyph.rows[row] & (0x10 >> column))) {
+					column++;
+					continue;
+				}
+				int start = column;
+				while (column < kGlyphWidth && (glyph.rows[row] & (0x10 >> column))) column++;
+				GlyphRun run;
+				run.x = static_cast<uint8_t>(start);
+				run.y = static_cast<uint8_t>(row);
+				run.length = static_cast<uint8_t>(column - start);
+				m_runs.push_back(run);
+			}
+		}
+		range.count = static_cast<uint16_t>(m_runs.size() - range.first);
+	}
+}
+
+int GlyphAtlas::TextWidth(const char* text) const {
+	int count = 0;
+	while (text[count]) count++;
+	return count * Advance();
+}
+
+void GlyphAtlas::DrawText(SoftwareFill& fill, uint32_t* pPixels, int pitch, int x, int y, const char* text, uint32_t color) const {
+	for (; *text; ++text, x += Advance()) {
+		const GlyphRange& range = m_glyphs[GlyphIndex(*text)];
+		for (int i = 0; i < range.count; ++i) {
+			const GlyphRun& run = m_runs[range.first + i];
+			fill.FillRect(pPixels, pitch, x + run.x * m_scale, y + run.y * m_scale, run.length * m_scale, m_scale, color);
+		}
+	}
+}
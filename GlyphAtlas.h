@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "SoftwareFill.h"
+
+// 5x7 bitmap font baked once into horizontal runs at a fixed pixel scale, so a glyph
+// is drawn as a handful of rectangle fills with no per-pixel tests. Covers digits,
+// upper-case letters and " .:%/-()"; lower case maps to upper, anything else is blank.
+class GlyphAtlas {
+public:
+	static const int kGlyphWidth = 5;
+	static const int kGlyphHeight = 7;
+
+	explicit GlyphAtlas(int scale = 2);
+
+	int Scale() const { return m_scale; }
+	int Advance() const { return (kGlyphWidth + 1) * m_scale; }
+	int LineHeight() const { return (kGlyphHeight + 3) * m_scale; }
+	int TextWidth(const char* text) const;
+
+	void DrawText(SoftwareFill& fill, uint32_t* pPixels, int pitch, int x, int y, const char* text, uint32_t color) const;
+
+private:
+	struct GlyphRun {
+		uint8_t x;
+		uint8_t y;
+		uint8_t length;
+	};
+	struct GlyphRange {
+		uint16_t first = 0;
+		uint16_t count = 0;
+	};
+
+	int m_scale;
+	std::vector<GlyphRun> m_runs;
+	GlyphRange m_glyphs[96];
+};
@@ -0,0 +1,162 @@
+#include "GpuTimestamps.h"
+
+#include <cstdio>
+#include "Tracer.h"
+
+const char* GpuMarkName(int mark) {
+	switch (mark) {
+	case kGpuMarkBegin: return "frame";
+	case kGpuMarkWorkload: return "workload";
+	case kGpuMarkClear: return "clear";
+	case kGpuMarkCopy: return "copy";
+	case kGpuMarkDraw: return "draw";
+	}
+	return "unknown";
+}
+
+int64_t GpuFrameTiming::StageTicks(int mark) const {
+	if (!Has(mark)) return 0;
+	for (int previous = mark - 1; previous >= 0; --previous) {
+		if (Has(previous)) return marks[mark] - marks[previous];
+	}
+	return 0;
+}
+
+GpuTimestampRing::GpuTimestampRing(GpuQuerySource& source, int64_t cpuFrequency, int slotCount, int readDelay)
+	: m_source(source), m_cpuFrequency(cpuFrequency),
+	m_slotCount(slotCount < 2 ? 2 : (slotCount > kMaxSlots ? kMaxSlots : slotCount)),
+	m_readDelay(readDelay < 1 ? 1 : (readDelay >= m_slotCount ? m_slotCount - 1 : readDelay)) {
+	ResetStatistics();
+}
+
+GpuTimestampRing::~GpuTimestampRing() {
+	Release();
+}
+
+bool GpuTimestampRing::Create() {
+	Release();
+	m_created = m_source.Create(m_slotCount);
+	return m_created;
+}
+
+// In-flight frames are dropped; the queries they used go with the source.
+void GpuTimestampRing::Release() {
+	if (m_created) m_source.Release();
+	m_created = false;
+	for (Slot& slot : m_slots) slot = Slot();
+	m_next = 0;
+	m_oldest = 0;
+	m_open = -1;
+	m_begun = 0;
+	m_hasOffset = false;
+}
+
+void GpuTimestampRing::ResetStatistics() {
+	for (FrameStatistics& stage : m_stages) stage.Reset(m_cpuFrequency);
+	m_history.Clear();
+	m_skipped = 0;
+	m_disjoint = 0;
+}
+
+bool GpuTimestampRing::BeginFrame(uint64_t frameIndex, int64_t now) {
+	if (!m_created || m_open >= 0) return false;
+	Collect();
+
+	Slot& slot = m_slots[m_next];
+	if (slot.pending) {
+		m_skipped++;
+		return false;
+	}
+	slot.sequence = m_begun++;
+	slot.frameIndex = frameIndex;
+	slot.cpuIssue = now;
+	slot.written = 0;
+	m_open = m_next;
+	m_source.Begin(m_open);
+	Mark(kGpuMarkBegin);
+	return true;
+}
+
+void GpuTimestampRing::Mark(int mark) {
+	if (m_open < 0 || mark < 0 || mark >= kGpuMarkCount) return;
+	m_source.Mark(m_open, mark);
+	m_slots[m_open].written |= 1u << mark;
+}
+
+void GpuTimestampRing::EndFrame() {
+	if (m_open < 0) return;
+	m_source.End(m_open);
+	m_slots[m_open].pending = true;
+	m_next = (m_next + 1) % m_slotCount;
+	m_open = -1;
+}
+
+// Slots complete in submission order, so the first busy one ends the scan.
+void GpuTimestampRing::Collect() {
+	while (m_slots[m_oldest].pending && m_begun - m_slots[m_oldest].sequence >= static_cast<uint64_t>(m_readDelay)) {
+		Slot& slot = m_slots[m_oldest];
+		uint64_t ticks[kGpuMarkCount] = {};
+		uint64_t frequency = 0;
+		bool disjoint = false;
+		if (!m_source.Read(m_oldest, slot.written, ticks, frequency, disjoint)) break;
+
+		slot.pending = false;
+		if (disjoint || frequency == 0) m_disjoint++;
+		else Complete(slot, ticks, frequency);
+		m_oldest = (m_oldest + 1) % m_slotCount;
+	}
+}
+
+int64_t GpuTimestampRing::ToCpuTicks(uint64_t gpuTicks, uint64_t gpuFrequency) const {
+	uint64_t cpuFrequency = static_cast<uint64_t>(m_cpuFrequency);
+	return static_cast<int64_t>(gpuTicks / gpuFrequency * cpuFrequency + gpuTicks % gpuFrequency * cpuFrequency / gpuFrequency);
+}
+
+void GpuTimestampRing::Complete(const Slot& slot, const uint64_t ticks[kGpuMarkCount], uint64_t frequency) {
+	GpuFrameTiming timing;
+	timing.frameIndex = slot.frameIndex;
+	timing.cpuIssue = slot.cpuIssue;
+	timing.written = slot.written;
+	for (int mark = 0; mark < kGpuMarkCount; ++mark) {
+		if (timing.Has(mark)) timing.marks[mark] = ToCpuTicks(ticks[mark], frequency);
+	}
+
+	// The offset only grows, so early frames may sit a little early on the timeline.
+	int64_t offset = slot.cpuIssue - timing.marks[kGpuMarkBegin];
+	if (!m_hasOffset || offset > m_offset) m_offset = offset;
+	m_hasOffset = true;
+	int last = kGpuMarkBegin;
+	for (int mark = 0; mark < kGpuMarkCount; ++mark) {
+		if (!timing.Has(mark)) continue;
+		timing.marks[mark] += m_offset;
+		last = mark;
+	}
+	for (int mark = kGpuMarkBegin + 1; mark < kGpuMarkCount; ++mark) {
+		if (timing.Has(mark)) m_stages[mark].Add(timing.StageTicks(mark));
+	}
+	m_stages[kGpuMarkBegin].Add(timing.marks[last] - timing.marks[kGpuMarkBegin]);
+	m_history.Push(timing);
+
+	if (m_traceTrack && Tracer::Active()) {
+		TraceEvent events[kGpuMarkCount];
+		size_t count = 0;
+		events[count++] = { GpuMarkName(kGpuMarkBegin), timing.marks[kGpuMarkBegin], timing.marks[last] };
+		for (int mark = kGpuMarkBegin + 1; mark < kGpuMarkCount; ++mark) {
+			if (timing.Has(mark)) events[count++] = { GpuMarkName(mark), timing.marks[mark] - timing.StageTicks(mark), timing.marks[mark] };
+		}
+		Tracer::Instance().RecordOnTrack(m_traceTrack, events, count);
+	}
+}
+
+std::string FormatGpuTimings(const GpuTimestampRing& ring) {
+	std::string text = "frames=" + std::to_string(ring.Stage(kGpuMarkBegin).Count());
+	for (int mark = 0; mark < kGpuMarkCount; ++mark) {
+		const FrameStatistics& stage = ring.Stage(mark);
+		if (stage.Count() == 0) continue;
+		char buffer[96];
+		snprintf(buffer, sizeof(buffer), " %s mean=%.3f ms p99=%.3f ms", GpuMarkName(mark), stage.MeanMs(), stage.QuantileMs(0.99));
+		text += buffer;
+	}
+	text += " skipped=" + std::to_string(ring.SkippedFrames()) + " disjoint=" + std::to_string(ring.DisjointFrames());
+	return text;
+}
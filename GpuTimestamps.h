@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "FrameStatistics.h"
+#include "FrameTelemetry.h"
+
+// Timestamps one device writes per frame, in submission order. Each mark ends the stage
+// that started at the previous mark written that frame; kGpuMarkBegin opens the frame.
+enum GpuMark {
+	kGpuMarkBegin = 0,
+	kGpuMarkWorkload,
+	kGpuMarkClear,
+	kGpuMarkCopy,
+	// Pattern and overlay uploads, up to the Present call.
+	kGpuMarkDraw,
+	kGpuMarkCount
+};
+
+const char* GpuMarkName(int mark);
+
+// One device's frame in FrameClock ticks, so it lines up with the FrameRecord of the same
+// frameIndex. The GPU clock has no fixed relation to the CPU clock; the ring shifts it by
+// the smallest offset that never has the GPU start a frame before the CPU issued it.
+struct GpuFrameTiming {
+	uint64_t frameIndex = 0;
+	int64_t cpuIssue = 0;
+	uint32_t written = 0;
+	int64_t marks[kGpuMarkCount] = {};
+
+	bool Has(int mark) const { return (written & (1u << mark)) != 0; }
+	// Time from the previous written mark to `mark`; 0 when `mark` was not written.
+	int64_t StageTicks(int mark) const;
+};
+
+// A device's timestamp queries. Slots are independent frames' worth of queries: a
+// disjoint query around kGpuMarkCount timestamps.
+class GpuQuerySource {
+public:
+	virtual ~GpuQuerySource() = default;
+	virtual bool Create(int slotCount) = 0;
+	virtual void Release() = 0;
+	virtual void Begin(int slot) = 0;
+	virtual void Mark(int slot, int mark) = 0;
+	virtual void End(int slot) = 0;
+	// Never blocks: false until the GPU has finished the slot. `written` selects the marks
+	// to read into ticks[]; disjoint means the counter was unreliable for this slot.
+	virtual bool Read(int slot, uint32_t written, uint64_t ticks[kGpuMarkCount], uint64_t& frequency, bool& disjoint) = 0;
+};
+
+// Queries for the last `slotCount` frames in flight. A slot is read back only once it is
+// `readDelay` frames old, and never waited on: when the oldest slot is still busy at the
+// start of a frame, that frame goes untimed instead.
+class GpuTimestampRing {
+public:
+	static const int kMaxSlots = 16;
+
+	GpuTimestampRing(GpuQuerySource& source, int64_t cpuFrequency, int slotCount = 8, int readDelay = 3);
+	~GpuTimestampRing();
+
+	bool Create();
+	void Release();
+	// While a capture runs, completed frames also go to this Tracer track. Needs a
+	// FrameClock on the tracer's tick source, as SystemClock is.
+	void SetTraceTrack(const char* name) { m_traceTrack = name; }
+
+	bool BeginFrame(uint64_t frameIndex, int64_t now);
+	void Mark(int mark);
+	void EndFrame();
+	bool FrameOpen() const { return m_open >= 0; }
+	// Reads every finished slot that is old enough; called by BeginFrame.
+	void Collect();
+
+	const FrameRing<GpuFrameTiming, 1024>& History() const { return m_history; }
+	// Stage ending at `mark`; kGpuMarkBegin holds whole frames.
+	const FrameStatistics& Stage(int mark) const { return m_stages[mark]; }
+	uint64_t SkippedFrames() const { return m_skipped; }
+	uint64_t DisjointFrames() const { return m_disjoint; }
+	void ResetStatistics();
+
+private:
+	struct Slot {
+		bool pending = false;
+		// Count of frames begun before this one.
+		uint64_t sequence = 0;
+		uint64_t frameIndex = 0;
+		int64_t cpuIssue = 0;
+		uint32_t written = 0;
+	};
+
+	int64_t ToCpuTicks(uint64_t gpuTicks, uint64_t gpuFrequency) const;
+	void Complete(const Slot& slot, const uint64_t ticks[kGpuMarkCount], uint64_t frequency);
+
+	GpuQuerySource& m_source;
+	int64_t m_cpuFrequency;
+	int m_slotCount;
+	int m_readDelay;
+	bool m_created = false;
+	Slot m_slots[kMaxSlots];
+	int m_next = 0;
+	int m_oldest = 0;
+	int m_open = -1;
+	uint64_t m_begun = 0;
+	bool m_hasOffset = false;
+	int64_t m_offset = 0;
+	const char* m_traceTrack = nullptr;
+	FrameRing<GpuFrameTiming, 1024> m_history;
+	FrameStatistics m_stages[kGpuMarkCount];
+	uint64_t m_skipped = 0;
+	uint64_t m_disjoint = 0;
+};
+
+// "frames=600 workload mean=0.000 ms p99=0.000 ms clear mean=0.012 ms ... skipped=0 disjoint=0"
+std::string FormatGpuTimings(const GpuTimestampRing& ring);
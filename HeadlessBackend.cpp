@@ -0,0 +1,81 @@
+#include "HeadlessBackend.h"
+
+#include "PerfOverlay.h"
+#include "Tracer.h"
+
+HeadlessBackend::HeadlessBackend(int bufferCount, int fillWorkers)
+	: m_bufferCount(bufferCount > 0 ? bufferCount : 1), m_fill(fillWorkers) {
+}
+
+bool HeadlessBackend::Init(int width, int height) {
+	if (width <= 0 || height <= 0) return false;
+	m_presentCount = 0;
+	Resize(width, height);
+	return true;
+}
+
+void HeadlessBackend::Resize(int width, int height) {
+	m_width = width;
+	m_height = height;
+	m_backBuffer = 0;
+	m_buffers.assign(m_bufferCount, std::vector<uint32_t>(static_cast<size_t>(width) * height));
+	m_workload.clear();
+}
+
+void HeadlessBackend::Cleanup() {
+	m_buffers.clear();
+	m_workload.clear();
+	m_width = 0;
+	m_height = 0;
+}
+
+uint32_t HeadlessBackend::PackColor(const float color[4]) {
+	uint32_t packed = 0;
+	for (int i = 0; i < 4; ++i) {
+		float c = color[i] < 0.0f ? 0.0f : (color[i] > 1.0f ? 1.0f : color[i]);
+		packed |= static_cast<uint32_t>(c * 255.0f + 0.5f) << (8 * i);
+	}
+	return packed;
+}
+
+// CPU-tile workload: full-surface fills into a scratch target, one per pass.
+void HeadlessBackend::RenderWorkload(int passes) {
+	if (passes <= 0 || m_buffers.empty()) return;
+	if (m_workload.empty()) m_workload.resize(static_cast<size_t>(m_width) * m_height);
+	for (int i = 0; i < passes; ++i) {
+		m_fill.Fill(m_workload.data(), m_width, m_height, m_width, 0xFF000000u | static_cast<uint32_t>(i));
+	}
+}
+
+void HeadlessBackend::Clear(const float color[4]) {
+	if (m_buffers.empty()) return;
+	TRACE_ZONE("software fill");
+	m_fill.Fill(m_buffers[m_backBuffer].data(), m_width, m_height, m_width, PackColor(color));
+}
+
+void HeadlessBackend::DrawTestPattern(const TestPattern& pattern) {
+	if (m_buffers.empty()) return;
+	pattern.Compose(m_fill, m_buffers[m_backBuffer].data(), m_width, m_width, m_height);
+}
+
+// Composited straight into the back buffer by the same fill path as the clear.
+void HeadlessBackend::DrawOverlay(const PerfOverlay& overlay) {
+	const int margin = 16;
+	if (m_buffers.empty() || overlay.Width() + margin > m_width || overlay.Height() + margin > m_height) return;
+	overlay.Compose(m_fill, m_buffers[m_backBuffer].data(), m_width, margin, margin);
+}
+
+void HeadlessBackend::Present() {
+	if (m_buffers.empty()) return;
+	if (m_pPatternCheck) {
+		TRACE_ZONE("pattern check");
+		m_pPatternCheck->AddFrame(m_buffers[m_backBuffer].data(), m_width, m_height, m_width);
+	}
+	m_backBuffer = (m_backBuffer + 1) % m_bufferCount;
+	m_presentCount++;
+}
+
+const uint32_t* HeadlessBackend::FrontBuffer() const {
+	if (m_buffers.empty()) return nullptr;
+	return m_buffers[(m_backBuffer + m_bufferCount - 1) % m_bufferCount].data();
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "RenderBackend.h"
+#include "SoftwareFill.h"
+#include "TestPattern.h"
+
+// CPU-only backend: clears into in-memory RGBA8 buffers with the SIMD fill path
+// and "presents" by flipping them. An attached pattern check decodes every buffer as
+// it is presented, so the whole frame path can be verified without capture hardware.
+class HeadlessBackend : public RenderBackend {
+public:
+	explicit HeadlessBackend(int bufferCount = 2, int fillWorkers = -1);
+
+	bool Init(int width, int height) override;
+	void WaitForPresentSlot() override {}
+	void BeginFrame(uint64_t, int64_t) override {}
+	void RenderWorkload(int passes) override;
+	void Clear(const float color[4]) override;
+	void DrawTestPattern(const TestPattern& pattern) override;
+	void DrawOverlay(const PerfOverlay& overlay) override;
+	void Present() override;
+	int PresentDelayFrames() const override { return 0; }
+	void Resize(int width, int height) override;
+	void Cleanup() override;
+
+	int Width() const { return m_width; }
+	int Height() const { return m_height; }
+	uint64_t PresentCount() const { return m_presentCount; }
+	uint32_t* BackBuffer() { return m_buffers.empty() ? nullptr : m_buffers[m_backBuffer].data(); }
+	const uint32_t* FrontBuffer() const;
+
+	SoftwareFill& Fill() { return m_fill; }
+	void SetPatternCheck(TestPatternDecoder* pCheck) { m_pPatternCheck = pCheck; }
+
+	static uint32_t PackColor(const float color[4]);
+
+private:
+	int m_bufferCount;
+	int m_width = 0;
+	int m_height = 0;
+	int m_backBuffer = 0;
+	uint64_t m_presentCount = 0;
+	std::vector<std::vector<uint32_t>> m_buffers;
+	std::vector<uint32_t> m_workload;
+	SoftwareFill m_fill;
+	TestPatternDecoder* m_pPatternCheck = nullptr;
+};
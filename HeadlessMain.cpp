@@ -0,0 +1,61 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "BenchmarkSuite.h"
+#include "RunConfig.h"
+#include "TestPattern.h"
+#include "TimerResolution.h"
+#include "Tracer.h"
+
+namespace {
+	void LogRunMessage(const std::string& message) {
+		printf("customfps-headless: %s\n", message.c_str());
+		fflush(stdout);
+	}
+}
+
+// The unattended suite without a window or a GPU, for any platform the portable sources
+// build on. Takes CustomFPS's options; the backend defaults to headless and d3d11 cells
+// are a usage error.
+int main(int argc, char** argv) {
+	TRACE_THREAD_NAME("main");
+	RunConfig config;
+	config.backend = RenderBackendType::Headless;
+	std::string error;
+	if (!ParseRunArguments(std::vector<std::string>(argv + 1, argv + argc), config, error)) {
+		LogRunMessage(error);
+		return kRunExitUsage;
+	}
+	if (config.showHelp) {
+		fputs(RunUsage(), stdout);
+		return kRunExitOk;
+	}
+	if (!config.checkCapturePath.empty()) {
+		TestPatternConfig patternConfig = config.pattern;
+		if (!patternConfig.Enabled()) patternConfig.barcode = true;
+		TestPatternDecoder decoder(patternConfig);
+		bool ok = CheckPatternCapture(config.checkCapturePath, config.width, config.height, decoder, error);
+		LogRunMessage("capture " + FormatPatternCheck(decoder.Stats()));
+		if (!ok) LogRunMessage(error);
+		if (!ok) return kRunExitInitFailed;
+		return PatternCheckPassed(decoder.Stats()) ? kRunExitOk : kRunExitPatternFailed;
+	}
+	if (SuiteUsesBackend(config, RenderBackendType::D3D11)) {
+		LogRunMessage("the d3d11 backend needs CustomFPS.exe");
+		return kRunExitUsage;
+	}
+
+	std::vector<RunStepResult> results;
+	int exitCode = kRunExitOk;
+	{
+		TimerResolutionScope timerResolution;
+		exitCode = RunBenchmarkSuite(config, RunHeadlessCell, results, error);
+	}
+	for (const RunStepResult& result : results) LogRunMessage(FormatRunStep(result));
+	if (!config.tracePath.empty()) {
+		Tracer& tracer = Tracer::Instance();
+		LogRunMessage("trace " + config.tracePath + ": " + FormatTraceSummary(tracer.Summarize()) + " dropped=" + std::to_string(tracer.DroppedEvents()));
+	}
+	if (exitCode != kRunExitOk) LogRunMessage(error);
+	return exitCode;
+}
@@ -0,0 +1,113 @@
+#include "LatencyProbe.h"
+
+#include <cstdio>
+
+LatencyProbe::LatencyProbe(FrameClock& clock)
+	: m_clock(clock), m_inputToSubmit(clock.Frequency()), m_inputToPresent(clock.Frequency()) {
+}
+
+void LatencyProbe::Reset() {
+	m_inputToSubmit.Reset(m_clock.Frequency());
+	m_inputToPresent.Reset(m_clock.Frequency());
+	m_lastSample = LatencySample();
+	m_inputPending = false;
+	m_flashInFlight = false;
+	m_coalescedInputs = 0;
+	m_nextAutoInput = 0;
+}
+
+void LatencyProbe::OnInput(int64_t timestamp) {
+	// Several inputs before the next flash frame share it; the earliest one is measured.
+	if (m_inputPending) {
+		m_coalescedInputs++;
+		return;
+	}
+	m_pendingInput = timestamp;
+	m_inputPending = true;
+}
+
+void LatencyProbe::SetAutoTrigger(int64_t intervalTicks) {
+	m_autoInterval = intervalTicks > 0 ? intervalTicks : 0;
+	m_nextAutoInput = 0;
+}
+
+uint32_t LatencyProbe::NextRandom() {
+	m_randomState ^= m_randomState << 13;
+	m_randomState ^= m_randomState >> 17;
+	m_randomState ^= m_randomState << 5;
+	return m_randomState;
+}
+
+bool LatencyProbe::BeginFrame(uint64_t frameIndex, int64_t now) {
+	if (m_autoInterval > 0) {
+		if (m_nextAutoInput == 0) m_nextAutoInput = now + m_autoInterval;
+		if (!m_inputPending && now >= m_nextAutoInput) {
+			OnInput(m_nextAutoInput);
+			// Jitter keeps the synthetic inputs from phase-locking to the frame period.
+			double jitter = NextRandom() / 4294967296.0;
+			m_nextAutoInput = now + m_autoInterval / 2 + static_cast<int64_t>(jitter * m_autoInterval);
+		}
+	}
+	// An input arriving while the last flash is still on its way waits for the next frame.
+	if (!m_inputPending || m_flashInFlight) return false;
+
+	m_current = LatencySample();
+	m_current.frameIndex = frameIndex;
+	m_current.input = m_pendingInput;
+	m_inputPending = false;
+	m_flashInFlight = true;
+	return true;
+}
+
+void LatencyProbe::OnSubmit(int64_t timestamp) {
+	if (m_flashInFlight) m_current.submit = timestamp;
+}
+
+void LatencyProbe::OnPresent(int64_t timestamp) {
+	if (!m_flashInFlight) return;
+	m_current.present = timestamp;
+	m_inputToSubmit.Add(m_current.submit - m_current.input);
+	m_inputToPresent.Add(m_current.present - m_current.input);
+	m_lastSample = m_current;
+	m_flashInFlight = false;
+}
+
+LatencySummary LatencyProbe::Summary(int targetFps) const {
+	LatencySummary summary;
+	summary.targetFps = targetFps;
+	summary.coalescedInputs = m_coalescedInputs;
+	summary.inputToSubmit = m_inputToSubmit.Summary();
+	summary.inputToPresent = m_inputToPresent.Summary();
+	return summary;
+}
+
+void LatencySweep::Start(const std::vector<int>& targetFps, uint64_t samplesPerStep) {
+	m_targetFps = targetFps;
+	m_step = 0;
+	m_samplesPerStep = samplesPerStep > 0 ? samplesPerStep : 1;
+	m_results.clear();
+}
+
+void LatencySweep::Stop() {
+	m_step = m_targetFps.size();
+}
+
+bool LatencySweep::Update(LatencyProbe& probe) {
+	if (!Active() || probe.Samples() < m_samplesPerStep) return false;
+	m_results.push_back(probe.Summary(CurrentFps()));
+	probe.Reset();
+	m_step++;
+	return true;
+}
+
+std::string FormatLatencySummary(const LatencySummary& summary) {
+	const FrameSummary& submit = summary.inputToSubmit;
+	const FrameSummary& present = summary.inputToPresent;
+	char buffer[512];
+	snprintf(buffer, sizeof(buffer),
+		"target=%d fps samples=%llu coalesced=%llu input->submit mean=%.3f p50=%.3f p95=%.3f p99=%.3f max=%.3f ms input->present mean=%.3f p50=%.3f p95=%.3f p99=%.3f max=%.3f ms",
+		summary.targetFps, static_cast<unsigned long long>(present.frames), static_cast<unsigned long long>(summary.coalescedInputs),
+		submit.meanMs, submit.p50Ms, submit.p95Ms, submit.p99Ms, submit.maxMs,
+		present.meanMs, present.p50Ms, present.p95Ms, present.p99Ms, present.maxMs);
+	return buffer;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "FrameClock.h"
+#include "FrameStatistics.h"
+
+struct LatencySample {
+	uint64_t frameIndex = 0;
+	int64_t input = 0;
+	int64_t submit = 0;
+	int64_t present = 0;
+};
+
+struct LatencySummary {
+	int targetFps = 0;
+	uint64_t coalescedInputs = 0;
+	FrameSummary inputToSubmit;
+	FrameSummary inputToPresent;
+};
+
+// Software-visible input-to-photon latency. An input arms a flash; the next frame
+// clears to the flash colour and the probe records input -> submit and input -> return of
+// the Present that hands it to the swap chain, which is a later one when the backend
+// presents frames late. Scan-out and panel response happen after Present and are not seen here.
+class LatencyProbe {
+public:
+	explicit LatencyProbe(FrameClock& clock);
+
+	void Reset();
+	void OnInput() { OnInput(m_clock.Now()); }
+	void OnInput(int64_t timestamp);
+	// Injects synthetic inputs at a jittered interval (0 disables) so sweeps run unattended.
+	void SetAutoTrigger(int64_t intervalTicks);
+
+	bool BeginFrame(uint64_t frameIndex, int64_t now);
+	void OnSubmit(int64_t timestamp);
+	void OnPresent(int64_t timestamp);
+
+	bool InputPending() const { return m_inputPending; }
+	uint64_t Samples() const { return m_inputToPresent.Count(); }
+	uint64_t CoalescedInputs() const { return m_coalescedInputs; }
+	const LatencySample& LastSample() const { return m_lastSample; }
+	LatencySummary Summary(int targetFps) const;
+
+private:
+	uint32_t NextRandom();
+
+	FrameClock& m_clock;
+	FrameStatistics m_inputToSubmit;
+	FrameStatistics m_inputToPresent;
+	LatencySample m_current;
+	LatencySample m_lastSample;
+	int64_t m_pendingInput = 0;
+	bool m_inputPending = false;
+	bool m_flashInFlight = false;
+	uint64_t m_coalescedInputs = 0;
+	int64_t m_autoInterval = 0;
+	int64_t m_nextAutoInput = 0;
+	uint32_t m_randomState = 0x2545F491u;
+};
+
+// Steps the target FPS through a list, collecting a fixed number of samples at each.
+class LatencySweep {
+public:
+	void Start(const std::vector<int>& targetFps, uint64_t samplesPerStep);
+	void Stop();
+
+	bool Active() const { return m_step < m_targetFps.size(); }
+	int CurrentFps() const { return Active() ? m_targetFps[m_step] : 0; }
+	// Returns true when the current step completed; the caller retargets the loop.
+	bool Update(LatencyProbe& probe);
+	const std::vector<LatencySummary>& Results() const { return m_results; }
+
+private:
+	std::vector<int> m_targetFps;
+	size_t m_step = 0;
+	uint64_t m_samplesPerStep = 0;
+	std::vector<LatencySummary> m_results;
+};
+
+std::string FormatLatencySummary(const LatencySummary& summary);
@@ -0,0 +1,73 @@
+#include "LoadGenerator.h"
+
+LoadGenerator::LoadGenerator(FrameClock& clock) : m_clock(clock) {
+}
+
+void LoadGenerator::Configure(const LoadConfig& config) {
+	m_config = config;
+	if (m_config.patternPeriod < 1) m_config.patternPeriod = 1;
+
+	size_t words = m_config.cpuKernel == CpuLoadKernel::Memory ? m_config.workingSetBytes / sizeof(uint64_t) : 0;
+	m_workingSet.assign(words, 1);
+}
+
+bool LoadGenerator::IsActive() const {
+	return m_config.cpuKernel != CpuLoadKernel::None || m_config.renderPasses > 0;
+}
+
+uint32_t LoadGenerator::NextRandom() {
+	m_randomState ^= m_randomState << 13;
+	m_randomState ^= m_randomState >> 17;
+	m_randomState ^= m_randomState << 5;
+	return m_randomState;
+}
+
+double LoadGenerator::ScaleForFrame(uint64_t frameIndex) {
+	switch (m_config.pattern) {
+	case LoadPattern::Sawtooth:
+		return static_cast<double>(frameIndex % m_config.patternPeriod + 1) / m_config.patternPeriod;
+	case LoadPattern::RandomSpike:
+		return NextRandom() / 4294967296.0 < m_config.spikeProbability ? m_config.spikeScale : 1.0;
+	default:
+		return 1.0;
+	}
+}
+
+void LoadGenerator::RunCpuLoad(double scale) {
+	if (m_config.cpuKernel == CpuLoadKernel::Busy) {
+		double ticks = m_config.cpuMicroseconds * scale * static_cast<double>(m_clock.Frequency()) / 1e6;
+		RunBusyKernel(static_cast<int64_t>(ticks));
+	}
+	else if (m_config.cpuKernel == CpuLoadKernel::Memory) {
+		RunMemoryKernel(static_cast<int>(m_config.memoryPasses * scale + 0.5));
+	}
+}
+
+int LoadGenerator::RenderPasses(double scale) const {
+	return static_cast<int>(m_config.renderPasses * scale + 0.5);
+}
+
+void LoadGenerator::RunBusyKernel(int64_t ticks) {
+	if (ticks <= 0) return;
+	int64_t end = m_clock.Now() + ticks;
+	uint64_t x = m_sink | 1;
+	do {
+		for (int i = 0; i < 256; ++i) x = x * 6364136223846793005ull + 1442695040888963407ull;
+	} while (m_clock.Now() < end);
+	m_sink = x;
+}
+
+// Read-modify-write one word per cache line so the cost tracks memory bandwidth.
+void LoadGenerator::RunMemoryKernel(int passes) {
+	if (m_workingSet.empty()) return;
+	uint64_t* pWords = m_workingSet.data();
+	size_t count = m_workingSet.size();
+	uint64_t sum = 0;
+	for (int pass = 0; pass < passes; ++pass) {
+		for (size_t i = 0; i < count; i += 8) {
+			sum += pWords[i];
+			pWords[i] = sum;
+		}
+	}
+	m_sink = sum;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "FrameClock.h"
+
+enum class LoadPattern {
+	Constant,
+	Sawtooth,
+	RandomSpike
+};
+
+enum class CpuLoadKernel {
+	None,
+	Busy,
+	Memory
+};
+
+struct LoadConfig {
+	CpuLoadKernel cpuKernel = CpuLoadKernel::None;
+	int cpuMicroseconds = 0;
+	size_t workingSetBytes = 0;
+	int memoryPasses = 1;
+	int renderPasses = 0;
+	LoadPattern pattern = LoadPattern::Constant;
+	int patternPeriod = 240;
+	double spikeProbability = 0.01;
+	double spikeScale = 4.0;
+};
+
+// Synthetic per-frame work so pacing can be observed under load. The pattern yields a
+// per-frame scale that multiplies the CPU kernel duration/passes and the render passes.
+class LoadGenerator {
+public:
+	explicit LoadGenerator(FrameClock& clock);
+
+	void Configure(const LoadConfig& config);
+	const LoadConfig& Config() const { return m_config; }
+	bool IsActive() const;
+
+	double ScaleForFrame(uint64_t frameIndex);
+	void RunCpuLoad(double scale);
+	int RenderPasses(double scale) const;
+
+private:
+	void RunBusyKernel(int64_t ticks);
+	void RunMemoryKernel(int passes);
+	uint32_t NextRandom();
+
+	FrameClock& m_clock;
+	LoadConfig m_config;
+	std::vector<uint64_t> m_workingSet;
+	uint32_t m_randomState = 0x9E3779B9u;
+	volatile uint64_t m_sink = 0;
+};
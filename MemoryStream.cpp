@@ -0,0 +1,110 @@
+#include "MemoryStream.h"
+
+#include <cstring>
+#include <new>
+
+IStream* MemoryStream::Create(const void* pData, ULONG size) {
+	if (!pData && size > 0) return nullptr;
+	return new (std::nothrow) MemoryStream(static_cast<const BYTE*>(pData), size);
+}
+
+HRESULT STDMETHODCALLTYPE MemoryStream::QueryInterface(REFIID riid, void** ppObject) {
+	if (!ppObject) return E_POINTER;
+	if (riid == __uuidof(IUnknown) || riid == __uuidof(ISequentialStream) || riid == __uuidof(IStream)) {
+		*ppObject = static_cast<IStream*>(this);
+		AddRef();
+		return S_OK;
+	}
+	*ppObject = nullptr;
+	return E_NOINTERFACE;
+}
+
+ULONG STDMETHODCALLTYPE MemoryStream::AddRef() {
+	return static_cast<ULONG>(InterlockedIncrement(&m_refCount));
+}
+
+ULONG STDMETHODCALLTYPE MemoryStream::Release() {
+	LONG refCount = InterlockedDecrement(&m_refCount);
+	if (refCount == 0) delete this;
+	return static_cast<ULONG>(refCount);
+}
+
+HRESULT STDMETHODCALLTYPE MemoryStream::Read(void* pBuffer, ULONG size, ULONG* pRead) {
+	if (!pBuffer) return STG_E_INVALIDPOINTER;
+	ULONG available = m_size - m_position;
+	ULONG count = size < available ? size : available;
+	memcpy(pBuffer, m_pData + m_position, count);
+	m_position += count;
+	if (pRead) *pRead = count;
+	return count == size ? S_OK : S_FALSE;
+}
+
+HRESULT STDMETHODCALLTYPE MemoryStream::Write(const void*, ULONG, ULONG* pWritten) {
+	if (pWritten) *pWritten = 0;
+	return STG_E_ACCESSDENIED;
+}
+
+HRESULT STDMETHODCALLTYPE MemoryStream::Seek(LARGE_INTEGER move, DWORD origin, ULARGE_INTEGER* pPosition) {
+	LONGLONG base = 0;
+	switch (origin) {
+	case STREAM_SEEK_SET: base = 0; break;
+	case STREAM_SEEK_CUR: base = m_position; break;
+	case STREAM_SEEK_END: base = m_size; break;
+	default: return STG_E_INVALIDFUNCTION;
+	}
+	LONGLONG position = base + move.QuadPart;
+	if (position < 0 || position > static_cast<LONGLONG>(m_size)) return STG_E_INVALIDFUNCTION;
+	m_position = static_cast<ULONG>(position);
+	if (pPosition) pPosition->QuadPart = m_position;
+	return S_OK;
+}
+
+HRESULT STDMETHODCALLTYPE MemoryStream::SetSize(ULARGE_INTEGER) {
+	return STG_E_ACCESSDENIED;
+}
+
+HRESULT STDMETHODCALLTYPE MemoryStream::CopyTo(IStream* pTarget, ULARGE_INTEGER size, ULARGE_INTEGER* pRead, ULARGE_INTEGER* pWritten) {
+	if (!pTarget) return STG_E_INVALIDPOINTER;
+	ULONG available = m_size - m_position;
+	ULONG count = size.QuadPart < available ? static_cast<ULONG>(size.QuadPart) : available;
+	ULONG written = 0;
+	HRESULT hr = pTarget->Write(m_pData + m_position, count, &written);
+	m_position += count;
+	if (pRead) pRead->QuadPart = count;
+	if (pWritten) pWritten->QuadPart = written;
+	return hr;
+}
+
+HRESULT STDMETHODCALLTYPE MemoryStream::Commit(DWORD) {
+	return S_OK;
+}
+
+HRESULT STDMETHODCALLTYPE MemoryStream::Revert() {
+	return S_OK;
+}
+
+HRESULT STDMETHODCALLTYPE MemoryStream::LockRegion(ULARGE_INTEGER, ULARGE_INTEGER, DWORD) {
+	return STG_E_INVALIDFUNCTION;
+}
+
+HRESULT STDMETHODCALLTYPE MemoryStream::UnlockRegion(ULARGE_INTEGER, ULARGE_INTEGER, DWORD) {
+	return STG_E_INVALIDFUNCTION;
+}
+
+HRESULT STDMETHODCALLTYPE MemoryStream::Stat(STATSTG* pStat, DWORD) {
+	if (!pStat) return STG_E_INVALIDPOINTER;
+	ZeroMemory(pStat, sizeof(*pStat));
+	pStat->type = STGTY_STREAM;
+	pStat->cbSize.QuadPart = m_size;
+	pStat->grfMode = STGM_READ;
+	return S_OK;
+}
+
+HRESULT STDMETHODCALLTYPE MemoryStream::Clone(IStream** ppStream) {
+	if (!ppStream) return STG_E_INVALIDPOINTER;
+	MemoryStream* pClone = new (std::nothrow) MemoryStream(m_pData, m_size);
+	if (!pClone) return E_OUTOFMEMORY;
+	pClone->m_position = m_position;
+	*ppStream = pClone;
+	return S_OK;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Windows.h>
+#include <objidl.h>
+
+// Read-only IStream over memory it does not own, e.g. a locked resource. Lets GDI+
+// and WIC decode straight from the module image without first copying into an
+// HGLOBAL. The memory must outlive the stream and every clone of it.
+class MemoryStream : public IStream {
+public:
+	// Returns a stream with one reference, or nullptr.
+	static IStream* Create(const void* pData, ULONG size);
+
+	// IUnknown
+	HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppObject) override;
+	ULONG STDMETHODCALLTYPE AddRef() override;
+	ULONG STDMETHODCALLTYPE Release() override;
+
+	// ISequentialStream
+	HRESULT STDMETHODCALLTYPE Read(void* pBuffer, ULONG size, ULONG* pRead) override;
+	HRESULT STDMETHODCALLTYPE Write(const void* pBuffer, ULONG size, ULONG* pWritten) override;
+
+	// IStream
+	HRESULT STDMETHODCALLTYPE Seek(LARGE_INTEGER move, DWORD origin, ULARGE_INTEGER* pPosition) override;
+	HRESULT STDMETHODCALLTYPE SetSize(ULARGE_INTEGER size) override;
+	HRESULT STDMETHODCALLTYPE CopyTo(IStream* pTarget, ULARGE_INTEGER size, ULARGE_INTEGER* pRead, ULARGE_INTEGER* pWritten) override;
+	HRESULT STDMETHODCALLTYPE Commit(DWORD flags) override;
+	HRESULT STDMETHODCALLTYPE Revert() override;
+	HRESULT STDMETHODCALLTYPE LockRegion(ULARGE_INTEGER offset, ULARGE_INTEGER size, DWORD type) override;
+	HRESULT STDMETHODCALLTYPE UnlockRegion(ULARGE_INTEGER offset, ULARGE_INTEGER size, DWORD type) override;
+	HRESULT STDMETHODCALLTYPE Stat(STATSTG* pStat, DWORD flags) override;
+	HRESULT STDMETHODCALLTYPE Clone(IStream** ppStream) override;
+
+private:
+	MemoryStream(const BYTE* pData, ULONG size) : m_pData(pData), m_size(size) {}
+	virtual ~MemoryStream() = default;
+
+	const BYTE* m_pData;
+	ULONG m_size;
+	ULONG m_position = 0;
+	LONG m_refCount = 1;
+};
@@ -0,0 +1,146 @@
+#include "MultiOutputRun.h"
+
+#include "HeadlessBackend.h"
+
+RunConfig OutputRunConfig(const RunConfig& config, size_t position) {
+	RunConfig outputConfig = config;
+	if (position < config.outputs.size()) outputConfig.outputIndex = config.outputs[position];
+	if (!config.outputFps.empty()) {
+		outputConfig.targetFps.assign(1, config.outputFps[position < config.outputFps.size() ? position : config.outputFps.size() - 1]);
+	}
+	return outputConfig;
+}
+
+std::string OutputFrameLogPath(const std::string& path, int outputIndex) {
+	return TaggedFrameLogPath(path, "output" + std::to_string(outputIndex));
+}
+
+MultiOutputRun::MultiOutputRun(const RunConfig& config)
+	: m_config(config) {
+}
+
+MultiOutputRun::~MultiOutputRun() {
+	RequestStop();
+	Join();
+}
+
+int MultiOutputRun::AddOutput(RenderBackend& backend, FrameClock& clock) {
+	if (m_outputs.size() >= m_config.outputs.size()) return -1;
+
+	std::unique_ptr<Output> output = std::make_unique<Output>();
+	output->config = OutputRunConfig(m_config, m_outputs.size());
+	const RunConfig& config = output->config;
+	output->loop = std::make_unique<FrameLoop>(backend, clock, config.targetFps.empty() ? 60 : config.targetFps.front(), config.catchUpPolicy);
+	if (!config.frameLogPath.empty()) {
+		if (output->frameLog.Open(OutputFrameLogPath(config.frameLogPath, config.outputIndex), FrameLogFormatForPath(config.frameLogPath), clock.Frequency())) {
+			output->loop->SetFrameLog(&output->frameLog);
+		}
+	}
+	output->load = std::make_unique<LoadGenerator>(clock);
+	output->load->Configure(config.load);
+	output->loop->SetLoadGenerator(output->load.get());
+	if (config.overlay) {
+		output->overlay = std::make_unique<PerfOverlay>(clock.Frequency());
+		output->loop->SetOverlay(output->overlay.get());
+	}
+	if (config.pattern.Enabled()) {
+		output->pattern = std::make_unique<TestPattern>(config.pattern);
+		output->loop->SetTestPattern(output->pattern.get());
+	}
+	output->run = std::make_unique<BenchmarkRun>(*output->loop, config);
+	m_outputs.push_back(std::move(output));
+	return static_cast<int>(m_outputs.size() - 1);
+}
+
+bool MultiOutputRun::Start(const std::function<void()>& onAllStopped) {
+	m_onAllStopped = onAllStopped;
+	m_running.store(m_outputs.size(), std::memory_order_release);
+	auto onExit = [this]() {
+		if (m_running.fetch_sub(1, std::memory_order_acq_rel) == 1 && m_onAllStopped) m_onAllStopped();
+	};
+
+	bool ok = true;
+	for (std::unique_ptr<Output>& output : m_outputs) {
+		Output* pOutput = output.get();
+		pOutput->run->Start();
+		if (!pOutput->thread.Start(m_config.renderThread, nullptr, [pOutput]() { return pOutput->run->Tick(); }, onExit)) {
+			ok = false;
+			onExit();
+		}
+	}
+	return ok;
+}
+
+void MultiOutputRun::RequestStop() {
+	for (std::unique_ptr<Output>& output : m_outputs) output->thread.RequestStop();
+}
+
+void MultiOutputRun::Join() {
+	for (std::unique_ptr<Output>& output : m_outputs) {
+		output->thread.Join();
+		output->frameLog.Close();
+	}
+}
+
+bool MultiOutputRun::Finished() const {
+	for (const std::unique_ptr<Output>& output : m_outputs) {
+		if (!output->run->Finished()) return false;
+	}
+	return !m_outputs.empty();
+}
+
+std::vector<RunStepResult> MultiOutputRun::Results() const {
+	std::vector<RunStepResult> results;
+	for (const std::unique_ptr<Output>& output : m_outputs) {
+		const std::vector<RunStepResult>& outputResults = output->run->Results();
+		results.insert(results.end(), outputResults.begin(), outputResults.end());
+	}
+	return results;
+}
+
+int RunHeadlessMultiOutput(const RunConfig& config, std::vector<RunStepResult>& results, std::string& error) {
+	RunConfig runConfig = config;
+	if (runConfig.width <= 0 || runConfig.height <= 0) {
+		runConfig.width = 1920;
+		runConfig.height = 1080;
+	}
+
+	const size_t count = runConfig.outputs.size();
+	std::vector<std::unique_ptr<HeadlessBackend>> backends;
+	std::vector<std::unique_ptr<SystemClock>> clocks;
+	std::vector<std::unique_ptr<TestPatternDecoder>> patternChecks;
+	for (size_t i = 0; i < count; ++i) {
+		backends.push_back(std::make_unique<HeadlessBackend>());
+		clocks.push_back(std::make_unique<SystemClock>());
+		if (!backends.back()->Init(runConfig.width, runConfig.height)) {
+			error = "headless backend init failed for output " + std::to_string(runConfig.outputs[i]);
+			for (std::unique_ptr<HeadlessBackend>& backend : backends) backend->Cleanup();
+			return kRunExitInitFailed;
+		}
+	}
+
+	int exitCode = kRunExitOk;
+	{
+		MultiOutputRun run(runConfig);
+		for (size_t i = 0; i < count; ++i) {
+			run.AddOutput(*backends[i], *clocks[i]);
+			if (runConfig.pattern.Enabled()) {
+				patternChecks.push_back(std::make_unique<TestPatternDecoder>(runConfig.pattern));
+				backends[i]->SetPatternCheck(patternChecks.back().get());
+				run.Run(i).SetPatternCheck(patternChecks.back().get());
+			}
+		}
+		if (!run.Start()) {
+			error = "render thread start failed";
+			exitCode = kRunExitInitFailed;
+		}
+		run.Join();
+		results = run.Results();
+		if (exitCode == kRunExitOk && !run.Finished()) {
+			error = "run aborted";
+			exitCode = kRunExitAborted;
+		}
+	}
+	for (std::unique_ptr<HeadlessBackend>& backend : backends) backend->Cleanup();
+	return exitCode;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BenchmarkRun.h"
+#include "FrameClock.h"
+#include "FrameLogWriter.h"
+#include "FrameLoop.h"
+#include "LoadGenerator.h"
+#include "PerfOverlay.h"
+#include "RenderBackend.h"
+#include "RenderThread.h"
+#include "RunConfig.h"
+#include "TestPattern.h"
+
+// Config for the output at a position in config.outputs: its display index, and its
+// own --output-fps entry (the last one repeats) in place of the --fps list.
+RunConfig OutputRunConfig(const RunConfig& config, size_t position);
+// "frames.csv" -> "frames.output1.csv", so every output logs to its own file.
+std::string OutputFrameLogPath(const std::string& path, int outputIndex);
+
+// Renders to several outputs at once. Every output gets its own FrameLoop, deadline
+// grid and BenchmarkRun, driven by its own render thread with its own clock, so a
+// blocking vsync Present or a slow frame on one display never delays another. Results
+// are per output; CPU figures are process-wide, so they cover all outputs.
+class MultiOutputRun {
+public:
+	explicit MultiOutputRun(const RunConfig& config);
+	~MultiOutputRun();
+	MultiOutputRun(const MultiOutputRun&) = delete;
+	MultiOutputRun& operator=(const MultiOutputRun&) = delete;
+
+	// Adds the output at the next position in config.outputs; returns that position or
+	// -1 when every output has been added. The clock must not be shared with another output.
+	int AddOutput(RenderBackend& backend, FrameClock& clock);
+	size_t Count() const { return m_outputs.size(); }
+	const RunConfig& OutputConfig(size_t position) const { return m_outputs[position]->config; }
+	FrameLoop& Loop(size_t position) { return *m_outputs[position]->loop; }
+	BenchmarkRun& Run(size_t position) { return *m_outputs[position]->run; }
+
+	// onAllStopped runs on the render thread that finishes last.
+	bool Start(const std::function<void()>& onAllStopped = nullptr);
+	void RequestStop();
+	void Join();
+	bool Finished() const;
+	// Every step of every output, in output order.
+	std::vector<RunStepResult> Results() const;
+
+private:
+	struct Output {
+		RunConfig config;
+		std::unique_ptr<FrameLoop> loop;
+		std::unique_ptr<BenchmarkRun> run;
+		std::unique_ptr<LoadGenerator> load;
+		std::unique_ptr<PerfOverlay> overlay;
+		std::unique_ptr<TestPattern> pattern;
+		FrameLogWriter frameLog;
+		RenderThread thread;
+	};
+
+	RunConfig m_config;
+	std::vector<std::unique_ptr<Output>> m_outputs;
+	std::function<void()> m_onAllStopped;
+	std::atomic<size_t> m_running{ 0 };
+};
+
+// Runs a multi-output config against one headless backend per output; returns a RunExitCode.
+int RunHeadlessMultiOutput(const RunConfig& config, std::vector<RunStepResult>& results, std::string& error);
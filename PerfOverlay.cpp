@@ -0,0 +1,74 @@
+#include "PerfOverlay.h"
+
+#include <cstdio>
+
+namespace {
+	const int kPadding = 8;
+	const int kBarWidth = 2;
+}
+
+PerfOverlay::PerfOverlay(int64_t frequency, int scale)
+	: m_atlas(scale), m_frequency(frequency), m_refreshTicks(frequency / 4), m_cost(frequency) {
+}
+
+void PerfOverlay::AddFrame(int64_t intervalTicks) {
+	if (intervalTicks <= 0) return;
+	m_graph.Push(intervalTicks);
+	m_framesSinceRefresh++;
+}
+
+void PerfOverlay::Refresh(const FrameStatistics& statistics, int targetFps, int64_t now) {
+	m_targetFps = targetFps > 0 ? targetFps : 1;
+	if (m_lastRefresh == 0) m_lastRefresh = now;
+	if (now - m_lastRefresh < m_refreshTicks) return;
+
+	double elapsed = static_cast<double>(now - m_lastRefresh) / static_cast<double>(m_frequency);
+	double currentFps = static_cast<double>(m_framesSinceRefresh) / elapsed;
+	m_lastRefresh = now;
+	m_framesSinceRefresh = 0;
+
+	FrameSummary summary = statistics.Summary();
+	snprintf(m_lines[0], sizeof(m_lines[0]), "FPS %.1f AVG %.1f", currentFps, summary.averageFps);
+	snprintf(m_lines[1], sizeof(m_lines[1]), "P50 %.2f P99 %.2f MS", summary.p50Ms, summary.p99Ms);
+	snprintf(m_lines[2], sizeof(m_lines[2]), "1%% LOW %.1f FPS", summary.low1Fps);
+	snprintf(m_lines[3], sizeof(m_lines[3]), "OVERLAY %.3f MS", m_cost.MeanMs());
+}
+
+int PerfOverlay::Width() const {
+	int textWidth = kLineChars * m_atlas.Advance();
+	int graphWidth = kGraphSamples * kBarWidth;
+	return kPadding * 2 + (textWidth > graphWidth ? textWidth : graphWidth);
+}
+
+int PerfOverlay::Height() const {
+	return kPadding * 3 + kLineCount * m_atlas.LineHeight() + kGraphHeight;
+}
+
+void PerfOverlay::Compose(SoftwareFill& fill, uint32_t* pPixels, int pitch, int x, int y) const {
+	const uint32_t background = PackRgba(24, 24, 24);
+	const uint32_t textColor = PackRgba(235, 235, 235);
+	const uint32_t onTarget = PackRgba(76, 175, 80);
+	const uint32_t late = PackRgba(244, 67, 54);
+	const uint32_t targetLine = PackRgba(255, 193, 7);
+
+	fill.FillRect(pPixels, pitch, x, y, Width(), Height(), background);
+	int lineY = y + kPadding;
+	for (int i = 0; i < kLineCount; ++i, lineY += m_atlas.LineHeight()) {
+		m_atlas.DrawText(fill, pPixels, pitch, x + kPadding, lineY, m_lines[i], textColor);
+	}
+
+	// Bars scale so the target period sits at half height; anything past 1.5x is late.
+	int graphTop = lineY + kPadding;
+	int64_t period = m_frequency / m_targetFps;
+	int64_t fullScale = period * 2;
+	for (size_t i = 0; i < m_graph.Size(); ++i) {
+		int64_t interval = m_graph[i];
+		int64_t clamped = interval < fullScale ? interval : fullScale;
+		int barHeight = static_cast<int>(clamped * kGraphHeight / fullScale);
+		if (barHeight < 1) barHeight = 1;
+		int barX = x + kPadding + static_cast<int>(i) * kBarWidth;
+		fill.FillRect(pPixels, pitch, barX, graphTop + kGraphHeight - barHeight, kBarWidth, barHeight,
+			interval * 2 > period * 3 ? late : onTarget);
+	}
+	fill.FillRect(pPixels, pitch, x + kPadding, graphTop + kGraphHeight / 2, kGraphSamples * kBarWidth, 1, targetLine);
+}
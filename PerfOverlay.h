@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include "FrameStatistics.h"
+#include "FrameTelemetry.h"
+#include "GlyphAtlas.h"
+#include "SoftwareFill.h"
+
+// Live stats panel: text from the glyph atlas plus a rolling frametime graph,
+// composed with rectangle fills into any RGBA8 surface. Text is rebuilt a few
+// times per second; the graph updates every frame. The time spent drawing it is
+// kept in its own histogram so it can be reported next to the frame numbers.
+class PerfOverlay {
+public:
+	static const int kLineCount = 4;
+	static const int kLineChars = 24;
+	static const int kGraphSamples = 128;
+	static const int kGraphHeight = 60;
+
+	explicit PerfOverlay(int64_t frequency, int scale = 2);
+
+	void AddFrame(int64_t intervalTicks);
+	void Refresh(const FrameStatistics& statistics, int targetFps, int64_t now);
+	void AddCost(int64_t ticks) { m_cost.Add(ticks); }
+	const FrameStatistics& Cost() const { return m_cost; }
+	const char* Line(int index) const { return m_lines[index]; }
+
+	int Width() const;
+	int Height() const;
+	void Compose(SoftwareFill& fill, uint32_t* pPixels, int pitch, int x, int y) const;
+
+	static uint32_t PackRgba(uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255) {
+		return static_cast<uint32_t>(r) | static_cast<uint32_t>(g) << 8 | static_cast<uint32_t>(b) << 16 | static_cast<uint32_t>(a) << 24;
+	}
+
+private:
+	GlyphAtlas m_atlas;
+	int64_t m_frequency;
+	int64_t m_refreshTicks;
+	int64_t m_lastRefresh = 0;
+	uint64_t m_framesSinceRefresh = 0;
+	int m_targetFps = 60;
+	FrameRing<int64_t, kGraphSamples> m_graph;
+	FrameStatistics m_cost;
+	char m_lines[kLineCount][kLineChars + 1] = {};
+};
@@ -0,0 +1,63 @@
+#include "PresentPolicy.h"
+
+namespace {
+	const int kMaxSyncInterval = 4;
+	// Stay a few percent under the panel maximum so VRR never falls back to vsync.
+	const double kVrrHeadroom = 0.97;
+}
+
+PresentPlan PlanPresent(PresentMode mode, int targetFps, int refreshRate, bool tearingSupported) {
+	PresentPlan plan;
+	plan.mode = mode;
+	plan.targetFps = targetFps > 0 ? targetFps : 1;
+
+	switch (mode) {
+	case PresentMode::VSync: {
+		if (refreshRate <= 0) {
+			plan.syncInterval = 1;
+			break;
+		}
+		int interval = (refreshRate + plan.targetFps / 2) / plan.targetFps;
+		if (interval < 1) interval = 1;
+		if (interval > kMaxSyncInterval) interval = kMaxSyncInterval;
+		plan.syncInterval = static_cast<unsigned>(interval);
+
+		// When the target is an exact divisor of the refresh rate, vsync alone paces the
+		// frames and a CPU limiter on top would only add latency.
+		int vsyncRate = refreshRate / interval;
+		int difference = vsyncRate > plan.targetFps ? vsyncRate - plan.targetFps : plan.targetFps - vsyncRate;
+		plan.useCpuLimiter = difference * 100 > plan.targetFps;
+		if (!plan.useCpuLimiter) plan.targetFps = vsyncRate;
+		break;
+	}
+	case PresentMode::Immediate:
+		plan.syncInterval = 0;
+		plan.allowTearing = tearingSupported;
+		break;
+	case PresentMode::Vrr:
+		plan.syncInterval = 0;
+		plan.allowTearing = tearingSupported;
+		if (refreshRate > 0) {
+			int ceiling = static_cast<int>(refreshRate * kVrrHeadroom);
+			if (ceiling > 0 && plan.targetFps > ceiling) plan.targetFps = ceiling;
+		}
+		break;
+	}
+	return plan;
+}
+
+const char* PresentModeName(PresentMode mode) {
+	switch (mode) {
+	case PresentMode::Immediate: return "immediate";
+	case PresentMode::Vrr: return "vrr";
+	default: return "vsync";
+	}
+}
+
+bool ParsePresentMode(const std::string& text, PresentMode& mode) {
+	if (text == "vsync") mode = PresentMode::VSync;
+	else if (text == "immediate" || text == "tearing") mode = PresentMode::Immediate;
+	else if (text == "vrr") mode = PresentMode::Vrr;
+	else return false;
+	return true;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+enum class PresentMode {
+	VSync,
+	Immediate,
+	Vrr
+};
+
+// How a target rate maps onto Present(): sync interval, tearing, whether the CPU
+// limiter paces frames or vsync does, and what the loop waits on.
+struct PresentPlan {
+	PresentMode mode = PresentMode::VSync;
+	int targetFps = 60;
+	unsigned syncInterval = 1;
+	bool allowTearing = false;
+	bool useCpuLimiter = true;
+	bool waitOnSwapChain = true;
+	unsigned maxFrameLatency = 1;
+};
+
+PresentPlan PlanPresent(PresentMode mode, int targetFps, int refreshRate, bool tearingSupported);
+const char* PresentModeName(PresentMode mode);
+bool ParsePresentMode(const std::string& text, PresentMode& mode);
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+
+enum class RenderBackendType {
+	D3D11,
+	Headless
+};
+
+class PerfOverlay;
+class TestPattern;
+
+// What the frame loop needs from a renderer: a wait for a free present slot, the
+// start of the frame's GPU work, optional synthetic render work, one clear, an
+// optional test pattern and overlay, and one present per frame.
+class RenderBackend {
+public:
+	virtual ~RenderBackend() = default;
+	virtual bool Init(int width, int height) = 0;
+	virtual void WaitForPresentSlot() = 0;
+	// `now` is the FrameClock time the frame's GPU work is issued.
+	virtual void BeginFrame(uint64_t frameIndex, int64_t now) = 0;
+	virtual void RenderWorkload(int passes) = 0;
+	virtual void Clear(const float color[4]) = 0;
+	virtual void DrawTestPattern(const TestPattern& pattern) = 0;
+	virtual void DrawOverlay(const PerfOverlay& overlay) = 0;
+	virtual void Present() = 0;
+	// How many later Present calls it takes for a frame's image to reach the swap chain.
+	virtual int PresentDelayFrames() const = 0;
+	virtual void Resize(int width, int height) = 0;
+	virtual void Cleanup() = 0;
+};
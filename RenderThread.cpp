@@ -0,0 +1,86 @@
+#include "RenderThread.h"
+
+#include "Tracer.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+RenderThread::~RenderThread() {
+	RequestStop();
+	Join();
+}
+
+bool RenderThread::Start(const RenderThreadConfig& config, const CommandHandler& onCommand, const FrameCallback& onFrame, const std::function<void()>& onExit) {
+	if (m_thread.joinable() || !onFrame) return false;
+	m_config = config;
+	m_onCommand = onCommand;
+	m_onFrame = onFrame;
+	m_onExit = onExit;
+	m_frames.store(0, std::memory_order_relaxed);
+	m_stopRequested.store(false, std::memory_order_relaxed);
+	m_running.store(true, std::memory_order_release);
+	m_thread = std::thread(&RenderThread::Run, this);
+	return true;
+}
+
+bool RenderThread::Post(const RenderCommand& command) {
+	if (m_commands.TryPush(command)) return true;
+	m_dropped++;
+	return false;
+}
+
+void RenderThread::Join() {
+	if (m_thread.joinable()) m_thread.join();
+}
+
+void RenderThread::Run() {
+	ApplyCurrentThreadConfig(m_config);
+	TRACE_THREAD_NAME("render");
+
+	while (!m_stopRequested.load(std::memory_order_acquire)) {
+		// One batch per frame, so a flood of commands cannot starve rendering.
+		size_t count = m_commands.PopBatch(m_batch, kQueueCapacity);
+		if (count > 0) {
+			TRACE_ZONE("render commands");
+			for (size_t i = 0; i < count; ++i) {
+				if (m_onCommand) m_onCommand(m_batch[i]);
+			}
+		}
+		if (!m_onFrame()) break;
+		m_frames.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	m_running.store(false, std::memory_order_release);
+	if (m_onExit) m_onExit();
+}
+
+bool ApplyCurrentThreadConfig(const RenderThreadConfig& config) {
+#ifdef _WIN32
+	int priority = THREAD_PRIORITY_NORMAL;
+	switch (config.priority) {
+	case ThreadPriority::Normal: priority = THREAD_PRIORITY_NORMAL; break;
+	case ThreadPriority::AboveNormal: priority = THREAD_PRIORITY_ABOVE_NORMAL; break;
+	case ThreadPriority::Highest: priority = THREAD_PRIORITY_HIGHEST; break;
+	case ThreadPriority::TimeCritical: priority = THREAD_PRIORITY_TIME_CRITICAL; break;
+	}
+	bool ok = SetThreadPriority(GetCurrentThread(), priority) != FALSE;
+	if (config.affinityMask != 0) {
+		ok = SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(config.affinityMask)) != 0 && ok;
+	}
+	return ok;
+#elif defined(__linux__)
+	if (config.affinityMask == 0) return true;
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (int cpu = 0; cpu < 64; ++cpu) {
+		if (config.affinityMask & (1ull << cpu)) CPU_SET(cpu, &set);
+	}
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+	return config.affinityMask == 0;
+#endif
+}
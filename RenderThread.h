@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include "SpscQueue.h"
+
+enum class RenderCommandType {
+	Resize,
+	ToggleOverlay,
+	StartLatencySweep,
+	StartMaxFpsSearch,
+	ToggleTestPattern,
+	Input
+};
+
+struct RenderCommand {
+	RenderCommandType type = RenderCommandType::Resize;
+	int width = 0;
+	int height = 0;
+	// Clock ticks at which the UI thread saw the event (Input only).
+	int64_t timestamp = 0;
+};
+
+enum class ThreadPriority {
+	Normal,
+	AboveNormal,
+	Highest,
+	TimeCritical
+};
+
+struct RenderThreadConfig {
+	ThreadPriority priority = ThreadPriority::Highest;
+	// Logical CPUs the thread may run on; 0 leaves the OS default.
+	uint64_t affinityMask = 0;
+};
+
+// Runs the frame loop on its own thread so message bursts on the UI thread (drags,
+// WM_SIZE storms) cannot delay a frame. The UI thread is the only producer of
+// commands; they are drained on the render thread before every frame.
+class RenderThread {
+public:
+	typedef std::function<void(const RenderCommand&)> CommandHandler;
+	// Runs one frame; returning false ends the thread.
+	typedef std::function<bool()> FrameCallback;
+
+	static const size_t kQueueCapacity = 256;
+
+	RenderThread() = default;
+	~RenderThread();
+	RenderThread(const RenderThread&) = delete;
+	RenderThread& operator=(const RenderThread&) = delete;
+
+	// onExit runs on the render thread after the last frame, e.g. to wake the UI thread.
+	bool Start(const RenderThreadConfig& config, const CommandHandler& onCommand, const FrameCallback& onFrame, const std::function<void()>& onExit);
+	// UI thread only. Returns false and counts the command as dropped when the queue is full.
+	bool Post(const RenderCommand& command);
+	void RequestStop() { m_stopRequested.store(true, std::memory_order_release); }
+	void Join();
+
+	bool Running() const { return m_running.load(std::memory_order_acquire); }
+	uint64_t Frames() const { return m_frames.load(std::memory_order_relaxed); }
+	uint64_t DroppedCommands() const { return m_dropped; }
+
+private:
+	void Run();
+
+	SpscQueue<RenderCommand, kQueueCapacity> m_commands;
+	RenderCommand m_batch[kQueueCapacity];
+	std::thread m_thread;
+	RenderThreadConfig m_config;
+	CommandHandler m_onCommand;
+	FrameCallback m_onFrame;
+	std::function<void()> m_onExit;
+	std::atomic<bool> m_running{ false };
+	std::atomic<bool> m_stopRequested{ false };
+	std::atomic<uint64_t> m_frames{ 0 };
+	uint64_t m_dropped = 0;
+};
+
+// Applies priority and affinity to the calling thread. Priority is only honoured on
+// Windows; raising it elsewhere needs privileges a benchmark should not ask for.
+bool ApplyCurrentThreadConfig(const RenderThreadConfig& config);
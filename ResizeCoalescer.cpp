@@ -0,0 +1,38 @@
+#include "ResizeCoalescer.h"
+
+ResizeCoalescer::ResizeCoalescer(int64_t frequency, double debounceMs)
+	: m_debounceTicks(static_cast<int64_t>(debounceMs * static_cast<double>(frequency) / 1000.0)), m_cost(frequency) {
+}
+
+void ResizeCoalescer::SetCurrent(int width, int height) {
+	m_width = width;
+	m_height = height;
+}
+
+void ResizeCoalescer::Request(int width, int height, int64_t now) {
+	if (width <= 0 || height <= 0) return;
+	m_stats.requests++;
+	if (m_pending) m_stats.coalesced++;
+	m_pendingWidth = width;
+	m_pendingHeight = height;
+	m_lastRequest = now;
+	m_pending = true;
+}
+
+bool ResizeCoalescer::Poll(int64_t now, int& width, int& height) {
+	if (!m_pending || now - m_lastRequest < m_debounceTicks) return false;
+	m_pending = false;
+	// A drag that ends where it started needs no resize at all.
+	if (m_pendingWidth == m_width && m_pendingHeight == m_height) {
+		m_stats.coalesced++;
+		return false;
+	}
+	m_width = width = m_pendingWidth;
+	m_height = height = m_pendingHeight;
+	return true;
+}
+
+void ResizeCoalescer::OnApplied(int64_t costTicks) {
+	m_stats.applied++;
+	m_cost.Add(costTicks);
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include "FrameStatistics.h"
+
+struct ResizeStats {
+	uint64_t requests = 0;
+	uint64_t applied = 0;
+	// Requests that never reached the backend: replaced by a newer one before they were
+	// applied, or a drag that ended at the size already in use.
+	uint64_t coalesced = 0;
+};
+
+// Debounces window size changes on the render thread: a size is applied only once no
+// newer one has arrived for the debounce interval, so a window drag costs one
+// swap-chain resize. Until then frames keep rendering at the old size and the
+// compositor stretches them to the window.
+class ResizeCoalescer {
+public:
+	explicit ResizeCoalescer(int64_t frequency, double debounceMs = 100.0);
+
+	void SetCurrent(int width, int height);
+	void Request(int width, int height, int64_t now);
+	// True when the caller should resize to width x height now and report the cost.
+	bool Poll(int64_t now, int& width, int& height);
+	void OnApplied(int64_t costTicks);
+
+	bool Pending() const { return m_pending; }
+	const ResizeStats& Stats() const { return m_stats; }
+	// Time spent in each applied resize.
+	const FrameStatistics& Cost() const { return m_cost; }
+
+private:
+	int64_t m_debounceTicks;
+	int m_width = 0;
+	int m_height = 0;
+	int m_pendingWidth = 0;
+	int m_pendingHeight = 0;
+	int64_t m_lastRequest = 0;
+	bool m_pending = false;
+	ResizeStats m_stats;
+	FrameStatistics m_cost;
+};
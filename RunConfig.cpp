@@ -0,0 +1,403 @@
+#include "RunConfig.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+	bool ParseInt(const std::string& text, int& value) {
+		if (text.empty()) return false;
+		char* end = nullptr;
+		errno = 0;
+		long parsed = strtol(text.c_str(), &end, 10);
+		if (errno != 0 || *end != '\0' || parsed < -2147483647L || parsed > 2147483647L) return false;
+		value = static_cast<int>(parsed);
+		return true;
+	}
+
+	bool ParseDouble(const std::string& text, double& value) {
+		if (text.empty()) return false;
+		char* end = nullptr;
+		errno = 0;
+		double parsed = strtod(text.c_str(), &end);
+		if (errno != 0 || *end != '\0') return false;
+		value = parsed;
+		return true;
+	}
+
+	bool ParseBool(const std::string& text, bool& value) {
+		if (text == "true" || text == "1" || text == "yes" || text == "on") value = true;
+		else if (text == "false" || text == "0" || text == "no" || text == "off") value = false;
+		else return false;
+		return true;
+	}
+
+	bool ParseResolution(const std::string& text, RunResolution& resolution) {
+		size_t separator = text.find('x');
+		return separator != std::string::npos &&
+			ParseInt(text.substr(0, separator), resolution.width) && ParseInt(text.substr(separator + 1), resolution.height) &&
+			resolution.width > 0 && resolution.height > 0;
+	}
+
+	bool ParseThreadPriority(const std::string& text, ThreadPriority& priority) {
+		if (text == "normal") priority = ThreadPriority::Normal;
+		else if (text == "above-normal") priority = ThreadPriority::AboveNormal;
+		else if (text == "highest") priority = ThreadPriority::Highest;
+		else if (text == "time-critical") priority = ThreadPriority::TimeCritical;
+		else return false;
+		return true;
+	}
+
+	bool ParseBackend(const std::string& text, RenderBackendType& type) {
+		if (text == "d3d11") type = RenderBackendType::D3D11;
+		else if (text == "headless") type = RenderBackendType::Headless;
+		else return false;
+		return true;
+	}
+
+	// Comma-separated list through a per-item parser; an empty item fails the whole list.
+	template<typename T, typename Parse>
+	bool ParseList(const std::string& text, std::vector<T>& list, Parse parseItem) {
+		std::vector<T> parsed;
+		size_t start = 0;
+		while (start <= text.size()) {
+			size_t comma = text.find(',', start);
+			if (comma == std::string::npos) comma = text.size();
+			T item;
+			if (!parseItem(text.substr(start, comma - start), item)) return false;
+			parsed.push_back(item);
+			start = comma + 1;
+		}
+		list = parsed;
+		return true;
+	}
+
+	bool ParsePatternElement(const std::string& text, std::string& element) {
+		element = text;
+		return text == "color" || text == "barcode" || text == "bar";
+	}
+
+	bool ParsePattern(const std::string& text, TestPatternConfig& pattern) {
+		std::vector<std::string> elements;
+		if (text != "off" && !ParseList(text, elements, ParsePatternElement)) return false;
+		pattern.colorSequence = pattern.barcode = pattern.movingBar = false;
+		for (const std::string& element : elements) {
+			if (element == "color") pattern.colorSequence = true;
+			else if (element == "barcode") pattern.barcode = true;
+			else pattern.movingBar = true;
+		}
+		return true;
+	}
+
+	bool ParseLoadPattern(const std::string& text, LoadPattern& pattern) {
+		if (text == "constant") pattern = LoadPattern::Constant;
+		else if (text == "sawtooth") pattern = LoadPattern::Sawtooth;
+		else if (text == "spike") pattern = LoadPattern::RandomSpike;
+		else return false;
+		return true;
+	}
+
+	// Cross-option checks that need every argument applied first.
+	bool ValidateRunConfig(const RunConfig& config, std::string& error) {
+		if (config.load.cpuMicroseconds > 0 && config.load.workingSetBytes > 0) {
+			error = "'load-cpu-us' and 'load-mem-kb' select different load kernels; pass one";
+			return false;
+		}
+		if (!config.checkCapturePath.empty() && (config.width <= 0 || config.height <= 0)) {
+			error = "'check-capture' needs --resolution to know the capture's frame size";
+			return false;
+		}
+		if (config.adaptive.minFps > config.adaptive.maxFps) {
+			error = "'min-fps' " + std::to_string(config.adaptive.minFps) + " is above 'max-fps' " + std::to_string(config.adaptive.maxFps);
+			return false;
+		}
+		return true;
+	}
+
+	std::string Trim(const std::string& text) {
+		size_t first = text.find_first_not_of(" \t\r\n");
+		if (first == std::string::npos) return std::string();
+		size_t last = text.find_last_not_of(" \t\r\n");
+		return text.substr(first, last - first + 1);
+	}
+
+	bool IsFlag(const std::string& key) {
+		return key == "help" || key == "windowed" || key == "fullscreen" || key == "overlay" || key == "find-max" || key == "gpu-timing";
+	}
+}
+
+bool ApplyRunOption(const std::string& key, const std::string& value, RunConfig& config, std::string& error) {
+	bool ok = true;
+	if (key == "help") {
+		config.showHelp = true;
+		return true;
+	}
+	else if (key == "backend") {
+		ok = ParseBackend(value, config.backend);
+	}
+	else if (key == "backends") {
+		ok = ParseList(value, config.backends, ParseBackend);
+	}
+	else if (key == "present") {
+		ok = ParsePresentMode(value, config.presentMode);
+	}
+	else if (key == "present-modes") {
+		ok = ParseList(value, config.presentModes, ParsePresentMode);
+	}
+	else if (key == "catch-up") {
+		if (value == "skip") config.catchUpPolicy = CatchUpPolicy::Skip;
+		else if (value == "burst") config.catchUpPolicy = CatchUpPolicy::Burst;
+		else if (value == "reanchor") config.catchUpPolicy = CatchUpPolicy::Reanchor;
+		else ok = false;
+	}
+	else if (key == "fps") {
+		ok = ParseList(value, config.targetFps, [](const std::string& text, int& fps) { return ParseInt(text, fps) && fps > 0; });
+	}
+	else if (key == "duration") {
+		ok = ParseDouble(value, config.durationSeconds) && config.durationSeconds > 0.0;
+	}
+	else if (key == "warmup") {
+		ok = ParseDouble(value, config.warmupSeconds) && config.warmupSeconds >= 0.0;
+	}
+	else if (key == "resolution") {
+		RunResolution resolution;
+		ok = ParseResolution(value, resolution);
+		config.width = resolution.width;
+		config.height = resolution.height;
+		config.fullscreen = false;
+	}
+	else if (key == "resolutions") {
+		ok = ParseList(value, config.resolutions, ParseResolution);
+	}
+	else if (key == "windowed") {
+		config.fullscreen = false;
+	}
+	else if (key == "fullscreen") {
+		ok = ParseBool(value, config.fullscreen);
+	}
+	else if (key == "overlay") {
+		ok = ParseBool(value, config.overlay);
+	}
+	else if (key == "find-max") {
+		ok = ParseBool(value, config.findMaxFps);
+	}
+	else if (key == "gpu-timing") {
+		ok = ParseBool(value, config.gpuTiming);
+	}
+	else if (key == "min-fps") {
+		ok = ParseInt(value, config.adaptive.minFps) && config.adaptive.minFps > 0;
+	}
+	else if (key == "max-fps") {
+		ok = ParseInt(value, config.adaptive.maxFps) && config.adaptive.maxFps > 0;
+	}
+	else if (key == "pacing-budget") {
+		ok = ParseDouble(value, config.adaptive.pacingBudget) && config.adaptive.pacingBudget > 0.0;
+	}
+	else if (key == "drop-budget") {
+		ok = ParseDouble(value, config.adaptive.dropBudget) && config.adaptive.dropBudget >= 0.0;
+	}
+	else if (key == "render-priority") {
+		ok = ParseThreadPriority(value, config.renderThread.priority);
+	}
+	else if (key == "render-affinity") {
+		char* end = nullptr;
+		errno = 0;
+		unsigned long long mask = strtoull(value.c_str(), &end, 0);
+		ok = !value.empty() && errno == 0 && *end == '\0';
+		if (ok) config.renderThread.affinityMask = mask;
+	}
+	else if (key == "load-cpu-us") {
+		ok = ParseInt(value, config.load.cpuMicroseconds) && config.load.cpuMicroseconds >= 0;
+		config.load.cpuKernel = config.load.cpuMicroseconds > 0 ? CpuLoadKernel::Busy : CpuLoadKernel::None;
+	}
+	else if (key == "load-mem-kb") {
+		int kilobytes = 0;
+		ok = ParseInt(value, kilobytes) && kilobytes >= 0;
+		config.load.workingSetBytes = ok ? static_cast<size_t>(kilobytes) * 1024 : 0;
+		config.load.cpuKernel = config.load.workingSetBytes > 0 ? CpuLoadKernel::Memory : CpuLoadKernel::None;
+	}
+	else if (key == "load-mem-passes") {
+		ok = ParseInt(value, config.load.memoryPasses) && config.load.memoryPasses > 0;
+	}
+	else if (key == "load-pattern") {
+		ok = ParseLoadPattern(value, config.load.pattern);
+	}
+	else if (key == "load-period") {
+		ok = ParseInt(value, config.load.patternPeriod) && config.load.patternPeriod > 0;
+	}
+	else if (key == "render-passes") {
+		ok = ParseInt(value, config.load.renderPasses) && config.load.renderPasses >= 0;
+	}
+	else if (key == "pattern") {
+		ok = ParsePattern(value, config.pattern);
+	}
+	else if (key == "check-capture") {
+		config.checkCapturePath = value;
+		ok = !value.empty();
+	}
+	else if (key == "adapter") {
+		ok = ParseInt(value, config.adapterIndex) && config.adapterIndex >= 0;
+	}
+	else if (key == "output") {
+		ok = ParseInt(value, config.outputIndex) && config.outputIndex >= 0;
+	}
+	else if (key == "outputs") {
+		ok = ParseList(value, config.outputs, [](const std::string& text, int& index) { return ParseInt(text, index) && index >= 0; });
+	}
+	else if (key == "output-fps") {
+		ok = ParseList(value, config.outputFps, [](const std::string& text, int& fps) { return ParseInt(text, fps) && fps > 0; });
+	}
+	else if (key == "stats") {
+		config.statsPath = value;
+	}
+	else if (key == "frame-log") {
+		config.frameLogPath = value;
+	}
+	else if (key == "trace") {
+		config.tracePath = value;
+		ok = !value.empty();
+	}
+	else {
+		error = "unknown option '" + key + "'";
+		return false;
+	}
+
+	if (!ok) {
+		error = "invalid value '" + value + "' for '" + key + "'";
+		return false;
+	}
+	config.unattended = true;
+	return true;
+}
+
+bool ParseRunArguments(const std::vector<std::string>& args, RunConfig& config, std::string& error) {
+	for (size_t i = 0; i < args.size(); ++i) {
+		const std::string& arg = args[i];
+		if (arg.size() < 3 || arg[0] != '-' || arg[1] != '-') {
+			error = "unexpected argument '" + arg + "'";
+			return false;
+		}
+
+		std::string key = arg.substr(2);
+		std::string value;
+		size_t equals = key.find('=');
+		if (equals != std::string::npos) {
+			value = key.substr(equals + 1);
+			key = key.substr(0, equals);
+		}
+		else if (IsFlag(key)) {
+			value = "true";
+		}
+		else if (i + 1 < args.size()) {
+			value = args[++i];
+		}
+		else {
+			error = "missing value for '" + key + "'";
+			return false;
+		}
+
+		if (key == "config") {
+			if (!LoadRunConfigFile(value, config, error)) return false;
+		}
+		else if (!ApplyRunOption(key, value, config, error)) {
+			return false;
+		}
+	}
+	return ValidateRunConfig(config, error);
+}
+
+bool LoadRunConfigFile(const std::string& path, RunConfig& config, std::string& error) {
+	FILE* file = nullptr;
+#ifdef _MSC_VER
+	if (fopen_s(&file, path.c_str(), "r") != 0) file = nullptr;
+#else
+	file = fopen(path.c_str(), "r");
+#endif
+	if (!file) {
+		error = "cannot open config file '" + path + "'";
+		return false;
+	}
+
+	char buffer[1024];
+	int lineNumber = 0;
+	bool ok = true;
+	while (ok && fgets(buffer, sizeof(buffer), file)) {
+		lineNumber++;
+		std::string line = buffer;
+		size_t comment = line.find('#');
+		if (comment != std::string::npos) line.erase(comment);
+		line = Trim(line);
+		if (line.empty()) continue;
+
+		size_t equals = line.find('=');
+		std::string key = Trim(line.substr(0, equals));
+		std::string value = equals == std::string::npos ? std::string("true") : Trim(line.substr(equals + 1));
+		if (key == "config" || (equals == std::string::npos && !IsFlag(key))) {
+			error = "bad line";
+			ok = false;
+		}
+		else {
+			ok = ApplyRunOption(key, value, config, error);
+		}
+		if (!ok) error = path + ":" + std::to_string(lineNumber) + ": " + error;
+	}
+	fclose(file);
+	return ok;
+}
+
+const char* RenderBackendName(RenderBackendType type) {
+	switch (type) {
+	case RenderBackendType::D3D11: return "d3d11";
+	case RenderBackendType::Headless: return "headless";
+	}
+	return "unknown";
+}
+
+const char* RunUsage() {
+	return
+		"CustomFPS [options]\n"
+		"  --config <file>         read options from a file (key = value per line)\n"
+		"  --backend d3d11|headless\n"
+		"  --present vsync|immediate|vrr\n"
+		"  --catch-up skip|burst|reanchor\n"
+		"  --fps <n[,n...]>        target FPS, one measured step per value\n"
+		"  --duration <seconds>    measured time per step (default 10)\n"
+		"  --warmup <seconds>      discarded time before each step (default 2)\n"
+		"  --resolution <W>x<H>    windowed size (implies --windowed)\n"
+		"  --windowed | --fullscreen\n"
+		"  --find-max              search for the highest sustainable FPS, then measure it\n"
+		"  --min-fps, --max-fps <n>\n"
+		"                          search range (default 30..1000)\n"
+		"  --pacing-budget <f>     allowed p95 pacing error as a fraction of the period (0.1)\n"
+		"  --drop-budget <f>       allowed fraction of late frames (0.01)\n"
+		"  --render-priority normal|above-normal|highest|time-critical\n"
+		"                          render thread priority (default highest)\n"
+		"  --render-affinity <mask>\n"
+		"                          render thread CPU mask, e.g. 0x4 (default any)\n"
+		"  --load-cpu-us <n>       busy CPU work per frame, in microseconds\n"
+		"  --load-mem-kb <n>       walk a working set this large every frame instead\n"
+		"  --load-mem-passes <n>   walks of the working set per frame (default 1)\n"
+		"  --load-pattern constant|sawtooth|spike\n"
+		"                          scales the load per frame (default constant)\n"
+		"  --load-period <frames>  sawtooth period (default 240)\n"
+		"  --render-passes <n>     extra full-surface render passes per frame\n"
+		"  --pattern off|color,barcode,bar\n"
+		"                          stamp a frame counter; headless runs check every present\n"
+		"  --check-capture <file>  decode a raw RGBA capture at --resolution and report\n"
+		"                          drops, repeats and reordering\n"
+		"  --adapter <index>       render GPU\n"
+		"  --output <index>        display output\n"
+		"  --outputs <i,j,...>     render to several outputs at once, one window and\n"
+		"                          render thread each\n"
+		"  --output-fps <n[,n...]> per-output target FPS for --outputs (last repeats)\n"
+		"  --backends, --resolutions, --present-modes <a,b,...>\n"
+		"                          suite matrix; every combination runs the --fps list\n"
+		"  --stats <file>          per-step report (.json, CSV otherwise)\n"
+		"  --frame-log <file>      per-frame log (.csv for text, binary otherwise); suites\n"
+		"                          and --outputs add .cellN / .outputN before the extension\n"
+		"  --trace <file>          Chrome/Perfetto trace JSON of the frame stages\n"
+		"  --gpu-timing            time the GPU clear, copy and draw stages (d3d11)\n"
+		"  --overlay               draw the stats overlay (its cost is included)\n"
+		"Any option skips the settings window. Exit codes: 0 ok, 1 usage, 2 init failed,\n"
+		"3 stats or trace file failed, 4 aborted, 5 test pattern errors.\n";
+}
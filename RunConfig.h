@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "AdaptiveFpsController.h"
+#include "FrameScheduler.h"
+#include "LoadGenerator.h"
+#include "PresentPolicy.h"
+#include "RenderBackend.h"
+#include "RenderThread.h"
+#include "TestPattern.h"
+
+enum RunExitCode {
+	kRunExitOk = 0,
+	kRunExitUsage = 1,
+	kRunExitInitFailed = 2,
+	kRunExitStatsFailed = 3,
+	kRunExitAborted = 4,
+	kRunExitPatternFailed = 5
+};
+
+struct RunResolution {
+	int width = 0;
+	int height = 0;
+};
+
+// Everything an unattended run needs. Any option on the command line or in a config
+// file marks the run unattended, which skips the settings window.
+struct RunConfig {
+	bool unattended = false;
+	bool showHelp = false;
+	RenderBackendType backend = RenderBackendType::D3D11;
+	PresentMode presentMode = PresentMode::VSync;
+	CatchUpPolicy catchUpPolicy = CatchUpPolicy::Skip;
+	std::vector<int> targetFps = { 60 };
+	double durationSeconds = 10.0;
+	double warmupSeconds = 2.0;
+	int width = 0;
+	int height = 0;
+	bool fullscreen = true;
+	int adapterIndex = 0;
+	int outputIndex = 0;
+	// Renders to every listed output at once, each paced on its own; outputFps gives
+	// each output its own target (the last value repeats) instead of the --fps list.
+	std::vector<int> outputs;
+	std::vector<int> outputFps;
+	std::string statsPath;
+	std::string frameLogPath;
+	// Chrome trace JSON of every scoped zone while the suite runs.
+	std::string tracePath;
+	// D3D11 timestamp queries around each GPU stage, logged per device and traced.
+	bool gpuTiming = false;
+	bool overlay = false;
+	RenderThreadConfig renderThread;
+	// Searches for the highest sustainable rate first, then measures one step at it
+	// in place of the --fps list.
+	bool findMaxFps = false;
+	AdaptiveFpsConfig adaptive;
+	// Frame counter stamped into every frame; headless runs decode each present.
+	TestPatternConfig pattern;
+	// Synthetic CPU and render work every frame, so pacing is measured under load.
+	LoadConfig load;
+	// Decodes a raw RGBA capture at --resolution instead of rendering.
+	std::string checkCapturePath;
+
+	// Suite matrix: when set, each entry replaces the single value above and the run
+	// covers backends x resolutions x present modes x target FPS.
+	std::vector<RenderBackendType> backends;
+	std::vector<RunResolution> resolutions;
+	std::vector<PresentMode> presentModes;
+};
+
+// Applies "--key value" / "--key=value" arguments in order. "--config <file>" loads
+// the file at that point, so later arguments override it. Options that contradict each
+// other are rejected once every argument is in.
+bool ParseRunArguments(const std::vector<std::string>& args, RunConfig& config, std::string& error);
+// "key = value" per line, '#' starts a comment. Keys are the long option names.
+bool LoadRunConfigFile(const std::string& path, RunConfig& config, std::string& error);
+bool ApplyRunOption(const std::string& key, const std::string& value, RunConfig& config, std::string& error);
+const char* RunUsage();
+const char* RenderBackendName(RenderBackendType type);
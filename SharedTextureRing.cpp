@@ -0,0 +1,61 @@
+#include "SharedTextureRing.h"
+
+SharedTextureRing::SharedTextureRing(int slotCount) {
+	Reset(slotCount);
+}
+
+void SharedTextureRing::Reset(int slotCount) {
+	if (slotCount < 1) slotCount = 1;
+	if (slotCount > kMaxSlots) slotCount = kMaxSlots;
+	m_slotCount = slotCount;
+	m_nextRender = 0;
+	m_nextCopy = 0;
+	m_renderedFrames = 0;
+	m_copiedFrames = 0;
+	for (int i = 0; i < kMaxSlots; ++i) {
+		m_states[i] = SharedSlotState::Free;
+		m_frames[i] = 0;
+	}
+}
+
+int SharedTextureRing::BeginRender() {
+	int slot = m_nextRender;
+	if (m_states[slot] != SharedSlotState::Free) return -1;
+	m_states[slot] = SharedSlotState::Rendering;
+	m_nextRender = (m_nextRender + 1) % m_slotCount;
+	return slot;
+}
+
+void SharedTextureRing::EndRender(int slot) {
+	if (slot < 0 || m_states[slot] != SharedSlotState::Rendering) return;
+	m_states[slot] = SharedSlotState::Ready;
+	m_frames[slot] = m_renderedFrames++;
+}
+
+int SharedTextureRing::BeginCopy() {
+	int slot = m_nextCopy;
+	if (m_states[slot] != SharedSlotState::Ready) return -1;
+	m_states[slot] = SharedSlotState::Copying;
+	m_nextCopy = (m_nextCopy + 1) % m_slotCount;
+	return slot;
+}
+
+void SharedTextureRing::EndCopy(int slot) {
+	if (slot < 0 || m_states[slot] != SharedSlotState::Copying) return;
+	m_states[slot] = SharedSlotState::Free;
+	m_copiedFrames++;
+}
+
+int SharedTextureRing::CopiesDue() const {
+	int ready = ReadyCount();
+	if (ready > 1) return ready - 1;
+	return m_copiedFrames == 0 ? ready : 0;
+}
+
+int SharedTextureRing::ReadyCount() const {
+	int count = 0;
+	for (int i = 0; i < m_slotCount; ++i) {
+		if (m_states[i] == SharedSlotState::Ready) count++;
+	}
+	return count;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+enum class SharedSlotState {
+	Free,
+	Rendering,
+	Ready,
+	Copying
+};
+
+// Ordering for the multi-GPU copy pipeline: the render adapter fills slots in ring
+// order and the display adapter copies them out in the same order, so frame N+1 can
+// render while frame N is being copied.
+class SharedTextureRing {
+public:
+	static const int kMaxSlots = 8;
+
+	explicit SharedTextureRing(int slotCount = 3);
+
+	void Reset(int slotCount);
+	int SlotCount() const { return m_slotCount; }
+
+	int BeginRender();
+	void EndRender(int slot);
+	int BeginCopy();
+	void EndCopy(int slot);
+
+	int ReadyCount() const;
+	// Copies to start once a frame is submitted: every ready frame but the newest, so the
+	// display runs one frame behind, or the very first frame on its own. The frame after
+	// that has nothing older ready, so the display shows the first frame twice.
+	int CopiesDue() const;
+	SharedSlotState State(int slot) const { return m_states[slot]; }
+	uint64_t SlotFrame(int slot) const { return m_frames[slot]; }
+	uint64_t RenderedFrames() const { return m_renderedFrames; }
+	uint64_t CopiedFrames() const { return m_copiedFrames; }
+
+private:
+	int m_slotCount = 0;
+	int m_nextRender = 0;
+	int m_nextCopy = 0;
+	uint64_t m_renderedFrames = 0;
+	uint64_t m_copiedFrames = 0;
+	SharedSlotState m_states[kMaxSlots];
+	uint64_t m_frames[kMaxSlots];
+};
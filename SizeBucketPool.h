@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct SizeBucketPoolStats {
+	uint64_t allocations = 0;
+	uint64_t reuses = 0;
+	uint64_t evictions = 0;
+};
+
+// Keeps released size-dependent resources around for reuse. Sizes are rounded up to
+// a bucket, so nearby sizes share one allocation and callers use its top-left
+// width x height region; resizing back and forth between sizes stops reallocating.
+// Idle entries are trimmed to maxIdle after each Acquire, oldest first, so a resize
+// that releases one size and acquires another can still swap back to the first.
+template <typename Entry>
+class SizeBucketPool {
+public:
+	explicit SizeBucketPool(int bucketSize = 128, int maxIdle = 1)
+		: m_bucketSize(bucketSize > 0 ? bucketSize : 1), m_maxIdle(maxIdle > 0 ? maxIdle : 0) {}
+
+	int BucketSize(int size) const {
+		return (size + m_bucketSize - 1) / m_bucketSize * m_bucketSize;
+	}
+
+	// create(bucketWidth, bucketHeight, entry) runs only when no idle entry matches.
+	template <typename Create, typename Destroy>
+	bool Acquire(int width, int height, Entry& entry, int& bucketWidth, int& bucketHeight, Create create, Destroy destroy) {
+		bucketWidth = BucketSize(width);
+		bucketHeight = BucketSize(height);
+		bool found = false;
+		for (size_t i = 0; i < m_idle.size() && !found; ++i) {
+			if (m_idle[i].width == bucketWidth && m_idle[i].height == bucketHeight) {
+				entry = m_idle[i].entry;
+				m_idle.erase(m_idle.begin() + i);
+				m_stats.reuses++;
+				found = true;
+			}
+		}
+		if (static_cast<int>(m_idle.size()) > m_maxIdle) {
+			size_t excess = m_idle.size() - static_cast<size_t>(m_maxIdle);
+			for (size_t i = 0; i < excess; ++i) destroy(m_idle[i].entry);
+			m_idle.erase(m_idle.begin(), m_idle.begin() + static_cast<std::ptrdiff_t>(excess));
+			m_stats.evictions += excess;
+		}
+		if (found) return true;
+
+		entry = Entry();
+		if (!create(bucketWidth, bucketHeight, entry)) return false;
+		m_stats.allocations++;
+		return true;
+	}
+
+	void Release(const Entry& entry, int bucketWidth, int bucketHeight) {
+		m_idle.push_back(Idle{ bucketWidth, bucketHeight, entry });
+	}
+
+	template <typename Destroy>
+	void Clear(Destroy destroy) {
+		for (Idle& idle : m_idle) destroy(idle.entry);
+		m_idle.clear();
+	}
+
+	int IdleCount() const { return static_cast<int>(m_idle.size()); }
+	const SizeBucketPoolStats& Stats() const { return m_stats; }
+
+private:
+	struct Idle {
+		int width;
+		int height;
+		Entry entry;
+	};
+
+	int m_bucketSize;
+	int m_maxIdle;
+	std::vector<Idle> m_idle;
+	SizeBucketPoolStats m_stats;
+};
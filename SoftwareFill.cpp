@@ -0,0 +1,207 @@
+#include "SoftwareFill.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SOFTWAREFILL_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(_M_ARM64) || defined(__aarch64__) || defined(__ARM_NEON)
+#define SOFTWAREFILL_NEON 1
+#include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SOFTWAREFILL_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SOFTWAREFILL_TARGET(isa)
+#endif
+
+namespace {
+
+	void FillScalar(uint32_t* pDst, size_t count, uint32_t value) {
+		for (size_t i = 0; i < count; ++i) pDst[i] = value;
+	}
+
+#ifdef SOFTWAREFILL_X86
+	size_t HeadToAlignment(const uint32_t* pDst, size_t count, size_t alignment) {
+		size_t misalignment = reinterpret_cast<uintptr_t>(pDst) & (alignment - 1);
+		size_t head = misalignment ? (alignment - misalignment) / sizeof(uint32_t) : 0;
+		return head < count ? head : count;
+	}
+
+	SOFTWAREFILL_TARGET("sse2")
+	void FillSse2(uint32_t* pDst, size_t count, uint32_t value, bool streaming) {
+		size_t head = HeadToAlignment(pDst, count, 16);
+		FillScalar(pDst, head, value);
+		pDst += head;
+		count -= head;
+
+		__m128i v = _mm_set1_epi32(static_cast<int>(value));
+		size_t blocks = count / 16;
+		__m128i* p = reinterpret_cast<__m128i*>(pDst);
+		if (streaming) {
+			for (size_t i = 0; i < blocks; ++i, p += 4) {
+				_mm_stream_si128(p, v);
+				_mm_stream_si128(p + 1, v);
+				_mm_stream_si128(p + 2, v);
+				_mm_stream_si128(p + 3, v);
+			}
+			_mm_sfence();
+		}
+		else {
+			for (size_t i = 0; i < blocks; ++i, p += 4) {
+				_mm_store_si128(p, v);
+				_mm_store_si128(p + 1, v);
+				_mm_store_si128(p + 2, v);
+				_mm_store_si128(p + 3, v);
+			}
+		}
+		FillScalar(pDst + blocks * 16, count - blocks * 16, value);
+	}
+
+	SOFTWAREFILL_TARGET("avx2")
+	void FillAvx2(uint32_t* pDst, size_t count, uint32_t value, bool streaming) {
+		size_t head = HeadToAlignment(pDst, count, 32);
+		FillScalar(pDst, head, value);
+		pDst += head;
+		count -= head;
+
+		__m256i v = _mm256_set1_epi32(static_cast<int>(value));
+		size_t blocks = count / 32;
+		__m256i* p = reinterpret_cast<__m256i*>(pDst);
+		if (streaming) {
+			for (size_t i = 0; i < blocks; ++i, p += 4) {
+				_mm256_stream_si256(p, v);
+				_mm256_stream_si256(p + 1, v);
+				_mm256_stream_si256(p + 2, v);
+				_mm256_stream_si256(p + 3, v);
+			}
+			_mm_sfence();
+		}
+		else {
+			for (size_t i = 0; i < blocks; ++i, p += 4) {
+				_mm256_store_si256(p, v);
+				_mm256_store_si256(p + 1, v);
+				_mm256_store_si256(p + 2, v);
+				_mm256_store_si256(p + 3, v);
+			}
+		}
+		FillScalar(pDst + blocks * 32, count - blocks * 32, value);
+	}
+
+	bool CpuHasAvx2() {
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7) return false;
+		__cpuid(info, 1);
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+		if (!osxsave || !avx || (_xgetbv(0) & 6) != 6) return false;
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+#endif
+
+#ifdef SOFTWAREFILL_NEON
+	void FillNeon(uint32_t* pDst, size_t count, uint32_t value) {
+		uint32x4_t v = vdupq_n_u32(value);
+		size_t blocks = count / 16;
+		for (size_t i = 0; i < blocks; ++i, pDst += 16) {
+			vst1q_u32(pDst, v);
+			vst1q_u32(pDst + 4, v);
+			vst1q_u32(pDst + 8, v);
+			vst1q_u32(pDst + 12, v);
+		}
+		FillScalar(pDst, count - blocks * 16, value);
+	}
+#endif
+
+}
+
+FillKernel DetectFillKernel() {
+#if defined(SOFTWAREFILL_X86)
+	return CpuHasAvx2() ? FillKernel::Avx2 : FillKernel::Sse2;
+#elif defined(SOFTWAREFILL_NEON)
+	return FillKernel::Neon;
+#else
+	return FillKernel::Scalar;
+#endif
+}
+
+const char* FillKernelName(FillKernel kernel) {
+	switch (kernel) {
+	case FillKernel::Sse2: return "sse2";
+	case FillKernel::Avx2: return "avx2";
+	case FillKernel::Neon: return "neon";
+	default: return "scalar";
+	}
+}
+
+void FillSpan(FillKernel kernel, uint32_t* pDst, size_t count, uint32_t value, bool streaming) {
+	switch (kernel) {
+#ifdef SOFTWAREFILL_X86
+	case FillKernel::Avx2:
+		FillAvx2(pDst, count, value, streaming);
+		return;
+	case FillKernel::Sse2:
+		FillSse2(pDst, count, value, streaming);
+		return;
+#endif
+#ifdef SOFTWAREFILL_NEON
+	case FillKernel::Neon:
+		FillNeon(pDst, count, value);
+		return;
+#endif
+	default:
+		FillScalar(pDst, count, value);
+		return;
+	}
+}
+
+SoftwareFill::SoftwareFill(int workerCount) : m_pool(workerCount), m_kernel(DetectFillKernel()) {
+}
+
+void SoftwareFill::Fill(uint32_t* pPixels, int width, int height, int pitch, uint32_t value) {
+	FillRect(pPixels, pitch, 0, 0, width, height, value);
+}
+
+void SoftwareFill::FillRect(uint32_t* pPixels, int pitch, int x, int y, int width, int height, uint32_t value) {
+	if (!pPixels || width <= 0 || height <= 0) return;
+
+	size_t bytes = static_cast<size_t>(width) * height * sizeof(uint32_t);
+	bool streaming = bytes >= m_streamingThreshold;
+	uint32_t* pOrigin = pPixels + static_cast<size_t>(y) * pitch + x;
+
+	// A contiguous surface is one span; otherwise fill row by row.
+	auto fillRows = [&](int firstRow, int rowCount) {
+		uint32_t* pRow = pOrigin + static_cast<size_t>(firstRow) * pitch;
+		if (width == pitch) {
+			FillSpan(m_kernel, pRow, static_cast<size_t>(width) * rowCount, value, streaming);
+			return;
+		}
+		for (int row = 0; row < rowCount; ++row, pRow += pitch) {
+			FillSpan(m_kernel, pRow, static_cast<size_t>(width), value, streaming);
+		}
+	};
+
+	int threads = m_pool.ThreadCount();
+	if (threads == 1 || bytes < m_parallelThreshold) {
+		fillRows(0, height);
+		return;
+	}
+
+	int tileCount = threads * 4 < height ? threads * 4 : height;
+	int rowsPerTile = (height + tileCount - 1) / tileCount;
+	tileCount = (height + rowsPerTile - 1) / rowsPerTile;
+	m_pool.ParallelFor(tileCount, [&](int tile) {
+		int firstRow = tile * rowsPerTile;
+		int rowCount = firstRow + rowsPerTile > height ? height - firstRow : rowsPerTile;
+		fillRows(firstRow, rowCount);
+	});
+}
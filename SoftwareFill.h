@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "WorkerPool.h"
+
+enum class FillKernel {
+	Scalar,
+	Sse2,
+	Avx2,
+	Neon
+};
+
+FillKernel DetectFillKernel();
+const char* FillKernelName(FillKernel kernel);
+
+// Fills `count` 32-bit pixels. Streaming uses non-temporal stores where the kernel has them,
+// which keeps surfaces larger than the cache from evicting everything else.
+void FillSpan(FillKernel kernel, uint32_t* pDst, size_t count, uint32_t value, bool streaming);
+
+// Surface fill split into row bands across a worker pool, using the best kernel the CPU supports.
+class SoftwareFill {
+public:
+	explicit SoftwareFill(int workerCount = -1);
+
+	void Fill(uint32_t* pPixels, int width, int height, int pitch, uint32_t value);
+	void FillRect(uint32_t* pPixels, int pitch, int x, int y, int width, int height, uint32_t value);
+
+	FillKernel Kernel() const { return m_kernel; }
+	void SetKernel(FillKernel kernel) { m_kernel = kernel; }
+	void SetStreamingThreshold(size_t bytes) { m_streamingThreshold = bytes; }
+	int ThreadCount() const { return m_pool.ThreadCount(); }
+
+private:
+	WorkerPool m_pool;
+	FillKernel m_kernel;
+	size_t m_streamingThreshold = 8 * 1024 * 1024;
+	size_t m_parallelThreshold = 256 * 1024;
+};
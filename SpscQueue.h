@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded single-producer/single-consumer queue. TryPush is only called from the
+// producer thread, TryPop/PopBatch only from the consumer thread.
+template <typename T, size_t Capacity>
+class SpscQueue {
+	static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "SpscQueue capacity must be a power of two");
+
+public:
+	bool TryPush(const T& value) {
+		uint64_t tail = m_tail.load(std::memory_order_relaxed);
+		if (tail - m_cachedHead == Capacity) {
+			m_cachedHead = m_head.load(std::memory_order_acquire);
+			if (tail - m_cachedHead == Capacity) return false;
+		}
+		m_items[tail & (Capacity - 1)] = value;
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool TryPop(T& value) {
+		return PopBatch(&value, 1) == 1;
+	}
+
+	size_t PopBatch(T* out, size_t maxCount) {
+		uint64_t head = m_head.load(std::memory_order_relaxed);
+		if (m_cachedTail == head) {
+			m_cachedTail = m_tail.load(std::memory_order_acquire);
+			if (m_cachedTail == head) return 0;
+		}
+		uint64_t available = m_cachedTail - head;
+		size_t count = available < maxCount ? static_cast<size_t>(available) : maxCount;
+		for (size_t i = 0; i < count; ++i) {
+			out[i] = m_items[(head + i) & (Capacity - 1)];
+		}
+		m_head.store(head + count, std::memory_order_release);
+		return count;
+	}
+
+	size_t SizeApprox() const {
+		return static_cast<size_t>(m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire));
+	}
+
+	static constexpr size_t MaxSize() { return Capacity; }
+
+private:
+	alignas(64) std::atomic<uint64_t> m_head{ 0 };
+	uint64_t m_cachedTail = 0;
+	alignas(64) std::atomic<uint64_t> m_tail{ 0 };
+	uint64_t m_cachedHead = 0;
+	alignas(64) std::array<T, Capacity> m_items{};
+};
@@ -0,0 +1,125 @@
+#include "StartupTasks.h"
+
+#include <algorithm>
+#include <cstdio>
+
+StartupTasks::StartupTasks(FrameClock& clock)
+	: m_clock(clock), m_origin(clock.Now()) {
+}
+
+StartupTasks::~StartupTasks() {
+	WaitAll();
+	for (std::thread& thread : m_threads) thread.join();
+}
+
+int StartupTasks::Add(const std::string& name, const std::function<bool()>& task, const std::vector<int>& dependencies) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	int id = static_cast<int>(m_tasks.size());
+	if (m_started) return -1;
+	for (int dependency : dependencies) {
+		if (dependency < 0 || dependency >= id) return -1;
+	}
+	Task entry;
+	entry.phase.name = name;
+	entry.phase.background = true;
+	entry.work = task;
+	entry.dependencies = dependencies;
+	m_tasks.push_back(entry);
+	return id;
+}
+
+void StartupTasks::Start() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_started) return;
+		m_started = true;
+	}
+	m_threads.reserve(m_tasks.size());
+	for (size_t i = 0; i < m_tasks.size(); ++i) {
+		m_threads.emplace_back(&StartupTasks::RunTask, this, static_cast<int>(i));
+	}
+}
+
+void StartupTasks::RunTask(int index) {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	Task& task = m_tasks[index];
+	bool ready = true;
+	for (int dependency : task.dependencies) {
+		m_finished.wait(lock, [&]() { return m_tasks[dependency].done; });
+		if (!m_tasks[dependency].phase.ok) ready = false;
+	}
+
+	int64_t start = m_clock.Now();
+	bool ok = false;
+	if (ready) {
+		lock.unlock();
+		ok = task.work();
+		lock.lock();
+	}
+	int64_t end = m_clock.Now();
+	task.phase.ok = ok;
+	task.phase.skipped = !ready;
+	task.phase.startMs = Milliseconds(start - m_origin);
+	task.phase.durationMs = Milliseconds(end - start);
+	task.done = true;
+	m_finished.notify_all();
+}
+
+bool StartupTasks::Wait(int task) {
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (task < 0 || task >= static_cast<int>(m_tasks.size()) || !m_started) return false;
+	m_finished.wait(lock, [&]() { return m_tasks[task].done; });
+	return m_tasks[task].phase.ok;
+}
+
+bool StartupTasks::WaitAll() {
+	bool ok = true;
+	for (int i = 0; i < static_cast<int>(m_tasks.size()); ++i) {
+		if (!Wait(i)) ok = false;
+	}
+	return ok;
+}
+
+bool StartupTasks::RunInline(const std::string& name, const std::function<bool()>& task) {
+	int64_t start = m_clock.Now();
+	bool ok = task();
+	int64_t end = m_clock.Now();
+
+	StartupPhase phase;
+	phase.name = name;
+	phase.ok = ok;
+	phase.startMs = Milliseconds(start - m_origin);
+	phase.durationMs = Milliseconds(end - start);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_inline.push_back(phase);
+	return ok;
+}
+
+std::vector<StartupPhase> StartupTasks::Phases() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	std::vector<StartupPhase> phases = m_inline;
+	for (const Task& task : m_tasks) {
+		if (task.done) phases.push_back(task.phase);
+	}
+	std::stable_sort(phases.begin(), phases.end(), [](const StartupPhase& a, const StartupPhase& b) { return a.startMs < b.startMs; });
+	return phases;
+}
+
+double StartupTasks::Milliseconds(int64_t ticks) const {
+	return static_cast<double>(ticks) * 1000.0 / static_cast<double>(m_clock.Frequency());
+}
+
+std::string FormatStartupPhases(const std::vector<StartupPhase>& phases) {
+	std::string text;
+	double total = 0.0;
+	for (const StartupPhase& phase : phases) {
+		char buffer[160];
+		snprintf(buffer, sizeof(buffer), "%s%s %.2f+%.2f ms%s, ", phase.name.c_str(), phase.background ? "*" : "",
+			phase.startMs, phase.durationMs, phase.skipped ? " skipped" : (phase.ok ? "" : " failed"));
+		text += buffer;
+		total = std::max(total, phase.startMs + phase.durationMs);
+	}
+	char buffer[64];
+	snprintf(buffer, sizeof(buffer), "total %.2f ms", total);
+	return text + buffer;
+}
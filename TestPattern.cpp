@@ -0,0 +1,251 @@
+#include "TestPattern.h"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+	const uint32_t kWhite = 0xFFFFFFFFu;
+	const uint32_t kBlack = 0xFF000000u;
+
+	// Channel bits (r, g, b) of each palette entry; black and white are left out so
+	// flash frames and blank captures never decode as a colour.
+	const int kPalette[TestPattern::kColorCount][3] = {
+		{ 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 0, 1, 1 }, { 1, 0, 1 }, { 1, 1, 0 }
+	};
+
+	int Luma(uint32_t pixel) {
+		int r = pixel & 0xFF;
+		int g = (pixel >> 8) & 0xFF;
+		int b = (pixel >> 16) & 0xFF;
+		return (r + 2 * g + b) / 4;
+	}
+}
+
+uint8_t TestPattern::Crc8(uint32_t value) {
+	uint8_t crc = 0;
+	for (int byte = 3; byte >= 0; --byte) {
+		crc ^= static_cast<uint8_t>(value >> (8 * byte));
+		for (int bit = 0; bit < 8; ++bit) {
+			crc = (crc & 0x80) ? static_cast<uint8_t>((crc << 1) ^ 0x07) : static_cast<uint8_t>(crc << 1);
+		}
+	}
+	return crc;
+}
+
+uint32_t TestPattern::PaletteColor(int index) {
+	const int* bits = kPalette[index % kColorCount];
+	return (bits[0] ? 0xFFu : 0u) | (bits[1] ? 0xFF00u : 0u) | (bits[2] ? 0xFF0000u : 0u) | 0xFF000000u;
+}
+
+int TestPattern::CellWidth(const TestPatternConfig& config, int width) {
+	int cellWidth = config.cellWidth;
+	if (kBarcodeCells * cellWidth + 2 * kMargin > width) cellWidth = (width - 2 * kMargin) / kBarcodeCells;
+	return cellWidth;
+}
+
+bool TestPattern::ClearColor(float color[4]) const {
+	if (!m_config.colorSequence) return false;
+	const int* bits = kPalette[m_counter % kColorCount];
+	for (int i = 0; i < 3; ++i) color[i] = bits[i] ? 1.0f : 0.0f;
+	color[3] = 1.0f;
+	return true;
+}
+
+bool TestPattern::BarcodeRegion(int width, int height, PatternRegion& region) const {
+	int cellWidth = CellWidth(m_config, width);
+	if (!m_config.barcode || cellWidth <= 0 || m_config.barcodeHeight <= 0 || height < m_config.barcodeHeight + 2 * kMargin) return false;
+	region.x = kMargin;
+	region.y = height - kMargin - m_config.barcodeHeight;
+	region.width = kBarcodeCells * cellWidth;
+	region.height = m_config.barcodeHeight;
+	return true;
+}
+
+bool TestPattern::BarRegion(int width, int height, PatternRegion& region) const {
+	if (!m_config.movingBar || m_config.barWidth <= 0) return false;
+	// The bar stays clear of the barcode so it never corrupts a cell.
+	PatternRegion barcode;
+	int bottom = BarcodeRegion(width, height, barcode) ? barcode.y - kMargin : height - kMargin;
+	int travel = width - 2 * kMargin - m_config.barWidth;
+	if (travel <= 0 || bottom <= kMargin) return false;
+	uint64_t step = static_cast<uint64_t>(m_config.barStep > 0 ? m_config.barStep : 1);
+	region.x = kMargin + static_cast<int>(m_counter * step % static_cast<uint64_t>(travel));
+	region.y = kMargin;
+	region.width = m_config.barWidth;
+	region.height = bottom - kMargin;
+	return true;
+}
+
+void TestPattern::Compose(SoftwareFill& fill, uint32_t* pPixels, int pitch, int width, int height) const {
+	PatternRegion region;
+	if (BarcodeRegion(width, height, region)) {
+		ComposeBarcode(fill, pPixels + static_cast<size_t>(region.y) * pitch + region.x, pitch, region);
+	}
+	if (BarRegion(width, height, region)) {
+		ComposeBar(fill, pPixels + static_cast<size_t>(region.y) * pitch + region.x, pitch, region);
+	}
+}
+
+void TestPattern::ComposeBarcode(SoftwareFill& fill, uint32_t* pPixels, int pitch, const PatternRegion& region) const {
+	uint32_t counter = static_cast<uint32_t>(m_counter);
+	uint8_t crc = Crc8(counter);
+	int cellWidth = region.width / kBarcodeCells;
+	for (int cell = 0; cell < kBarcodeCells; ++cell) {
+		bool bit;
+		if (cell < kGuardCells) bit = cell == 0;
+		else if (cell < kGuardCells + kCounterBits) bit = ((counter >> (kCounterBits - 1 - (cell - kGuardCells))) & 1) != 0;
+		else bit = ((crc >> (kCrcBits - 1 - (cell - kGuardCells - kCounterBits))) & 1) != 0;
+		fill.FillRect(pPixels, pitch, cell * cellWidth, 0, cellWidth, region.height, bit ? kWhite : kBlack);
+	}
+}
+
+void TestPattern::ComposeBar(SoftwareFill& fill, uint32_t* pPixels, int pitch, const PatternRegion& region) const {
+	fill.FillRect(pPixels, pitch, 0, 0, region.width, region.height, kWhite);
+}
+
+TestPatternDecoder::TestPatternDecoder(const TestPatternConfig& config)
+	: m_config(config) {
+}
+
+void TestPatternDecoder::Reset() {
+	m_stats = PatternCheckStats();
+	m_last = 0;
+	m_haveLast = false;
+}
+
+bool TestPatternDecoder::DecodeBarcode(const uint32_t* pPixels, int width, int height, int pitch, uint32_t& counter) const {
+	PatternRegion region;
+	if (!TestPattern(m_config).BarcodeRegion(width, height, region)) return false;
+
+	int cellWidth = region.width / TestPattern::kBarcodeCells;
+	const uint32_t* pRow = pPixels + static_cast<size_t>(region.y + region.height / 2) * pitch + region.x;
+	uint64_t bits = 0;
+	for (int cell = 0; cell < TestPattern::kBarcodeCells; ++cell) {
+		bits = bits << 1 | (Luma(pRow[cell * cellWidth + cellWidth / 2]) >= 128 ? 1u : 0u);
+	}
+
+	const int payloadBits = TestPattern::kCounterBits + TestPattern::kCrcBits;
+	if ((bits >> payloadBits) != 2) return false;
+	counter = static_cast<uint32_t>(bits >> TestPattern::kCrcBits);
+	return TestPattern::Crc8(counter) == static_cast<uint8_t>(bits & 0xFF);
+}
+
+bool TestPatternDecoder::DecodeColor(const uint32_t* pPixels, int width, int height, int pitch, int& index) const {
+	// Top-right corner: outside the overlay, the barcode and the bar's travel.
+	const int half = TestPattern::kMargin / 2;
+	if (width < TestPattern::kMargin || height < TestPattern::kMargin) return false;
+	int sum[3] = {};
+	for (int dy = -1; dy <= 1; ++dy) {
+		for (int dx = -1; dx <= 1; ++dx) {
+			uint32_t pixel = pPixels[static_cast<size_t>(half + dy) * pitch + (width - 1 - half + dx)];
+			for (int c = 0; c < 3; ++c) sum[c] += (pixel >> (8 * c)) & 0xFF;
+		}
+	}
+	int bits[3];
+	for (int c = 0; c < 3; ++c) bits[c] = sum[c] / 9 >= 128 ? 1 : 0;
+	for (int i = 0; i < TestPattern::kColorCount; ++i) {
+		if (bits[0] == kPalette[i][0] && bits[1] == kPalette[i][1] && bits[2] == kPalette[i][2]) {
+			index = i;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool TestPatternDecoder::Decode(const uint32_t* pPixels, int width, int height, int pitch, uint64_t& counter) const {
+	if (!pPixels) return false;
+	if (m_config.barcode) {
+		uint32_t value = 0;
+		if (!DecodeBarcode(pPixels, width, height, pitch, value)) return false;
+		// Extend to 64 bits around the last counter so a 32-bit wrap reads as +1.
+		counter = (m_last & ~0xFFFFFFFFull) | value;
+		if (m_haveLast && counter + 0x80000000ull < m_last) counter += 0x100000000ull;
+		else if (m_haveLast && counter > m_last + 0x80000000ull && counter >= 0x100000000ull) counter -= 0x100000000ull;
+		return true;
+	}
+	if (m_config.colorSequence) {
+		int index = 0;
+		if (!DecodeColor(pPixels, width, height, pitch, index)) return false;
+		const uint64_t modulus = TestPattern::kColorCount;
+		if (!m_haveLast) {
+			counter = static_cast<uint64_t>(index);
+			return true;
+		}
+		counter = m_last + (static_cast<uint64_t>(index) + modulus - m_last % modulus) % modulus;
+		return true;
+	}
+	return false;
+}
+
+void TestPatternDecoder::AddFrame(const uint32_t* pPixels, int width, int height, int pitch) {
+	uint64_t counter = 0;
+	if (!Decode(pPixels, width, height, pitch, counter)) {
+		m_stats.frames++;
+		m_stats.undecoded++;
+		return;
+	}
+	AddCounter(counter);
+}
+
+void TestPatternDecoder::AddCounter(uint64_t counter) {
+	m_stats.frames++;
+	m_stats.decoded++;
+	if (!m_haveLast) {
+		m_last = counter;
+		m_haveLast = true;
+		return;
+	}
+	if (counter == m_last) {
+		m_stats.repeated++;
+	}
+	else if (counter < m_last) {
+		m_stats.reordered++;
+	}
+	else {
+		if (counter > m_last + 1) {
+			m_stats.dropped += counter - m_last - 1;
+			m_stats.dropEvents++;
+		}
+		m_last = counter;
+	}
+}
+
+bool CheckPatternCapture(const std::string& path, int width, int height, TestPatternDecoder& decoder, std::string& error) {
+	if (width <= 0 || height <= 0) {
+		error = "capture check needs the frame size (--resolution)";
+		return false;
+	}
+	FILE* file = nullptr;
+#ifdef _MSC_VER
+	if (fopen_s(&file, path.c_str(), "rb") != 0) file = nullptr;
+#else
+	file = fopen(path.c_str(), "rb");
+#endif
+	if (!file) {
+		error = "cannot open capture '" + path + "'";
+		return false;
+	}
+
+	std::vector<uint32_t> frame(static_cast<size_t>(width) * height);
+	size_t read = 0;
+	while ((read = fread(frame.data(), sizeof(uint32_t), frame.size(), file)) == frame.size()) {
+		decoder.AddFrame(frame.data(), width, height, width);
+	}
+	bool ok = ferror(file) == 0 && read == 0;
+	fclose(file);
+	if (!ok) error = "capture '" + path + "' is not a whole number of " + std::to_string(width) + "x" + std::to_string(height) + " RGBA frames";
+	return ok;
+}
+
+std::string FormatPatternCheck(const PatternCheckStats& stats) {
+	char buffer[192];
+	snprintf(buffer, sizeof(buffer), "frames=%llu decoded=%llu undecoded=%llu dropped=%llu (%llu events) repeated=%llu reordered=%llu",
+		static_cast<unsigned long long>(stats.frames), static_cast<unsigned long long>(stats.decoded), static_cast<unsigned long long>(stats.undecoded),
+		static_cast<unsigned long long>(stats.dropped), static_cast<unsigned long long>(stats.dropEvents),
+		static_cast<unsigned long long>(stats.repeated), static_cast<unsigned long long>(stats.reordered));
+	return buffer;
+}
+
+bool PatternCheckPassed(const PatternCheckStats& stats) {
+	return stats.undecoded == 0 && stats.dropped == 0 && stats.repeated == 0 && stats.reordered == 0;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "SoftwareFill.h"
+
+struct TestPatternConfig {
+	// Clear colour cycles through kColorCount colours, one per frame.
+	bool colorSequence = false;
+	// Black/white cells along the bottom-left edge: guard, 32-bit frame counter, CRC-8.
+	bool barcode = false;
+	// Vertical bar stepping a fixed distance per frame, for judging pacing by eye.
+	bool movingBar = false;
+	int cellWidth = 16;
+	int barcodeHeight = 24;
+	int barWidth = 8;
+	int barStep = 8;
+
+	bool Enabled() const { return colorSequence || barcode || movingBar; }
+};
+
+struct PatternRegion {
+	int x = 0;
+	int y = 0;
+	int width = 0;
+	int height = 0;
+};
+
+// Stamps a frame counter into every frame so drops and repeats show up in the output
+// itself. Layout depends only on the config and the surface size, so a decoder given
+// the same two finds the same cells.
+class TestPattern {
+public:
+	static const int kColorCount = 6;
+	static const int kGuardCells = 2;
+	static const int kCounterBits = 32;
+	static const int kCrcBits = 8;
+	static const int kBarcodeCells = kGuardCells + kCounterBits + kCrcBits;
+	static const int kMargin = 16;
+
+	explicit TestPattern(const TestPatternConfig& config = TestPatternConfig()) : m_config(config) {}
+
+	const TestPatternConfig& Config() const { return m_config; }
+	void SetFrame(uint64_t counter) { m_counter = counter; }
+	uint64_t Frame() const { return m_counter; }
+
+	// Clear colour for this frame; false when the colour sequence is off.
+	bool ClearColor(float color[4]) const;
+	// False when the pattern element is off or does not fit the surface.
+	bool BarcodeRegion(int width, int height, PatternRegion& region) const;
+	bool BarRegion(int width, int height, PatternRegion& region) const;
+	// Draws the barcode and bar into an RGBA8 surface. pPixels is the surface origin.
+	void Compose(SoftwareFill& fill, uint32_t* pPixels, int pitch, int width, int height) const;
+	// Draws one region into a buffer whose origin is the region's top-left corner,
+	// so GPU backends can upload just that rectangle.
+	void ComposeBarcode(SoftwareFill& fill, uint32_t* pPixels, int pitch, const PatternRegion& region) const;
+	void ComposeBar(SoftwareFill& fill, uint32_t* pPixels, int pitch, const PatternRegion& region) const;
+
+	static uint8_t Crc8(uint32_t value);
+	static uint32_t PaletteColor(int index);
+	static int CellWidth(const TestPatternConfig& config, int width);
+
+private:
+	TestPatternConfig m_config;
+	uint64_t m_counter = 0;
+};
+
+struct PatternCheckStats {
+	uint64_t frames = 0;
+	uint64_t decoded = 0;
+	uint64_t undecoded = 0;
+	// Counters that never appeared between two decoded frames.
+	uint64_t dropped = 0;
+	uint64_t dropEvents = 0;
+	uint64_t repeated = 0;
+	// Counters lower than one already seen.
+	uint64_t reordered = 0;
+};
+
+// Reads the counter back out of presented or captured frames and checks the sequence.
+// The barcode gives the exact counter; without it the colour sequence gives the counter
+// modulo kColorCount, which still catches drops and repeats shorter than that but cannot
+// see reordering. A frame torn between two counters fails the CRC and counts as undecoded.
+class TestPatternDecoder {
+public:
+	explicit TestPatternDecoder(const TestPatternConfig& config);
+
+	void Reset();
+	bool Decode(const uint32_t* pPixels, int width, int height, int pitch, uint64_t& counter) const;
+	void AddFrame(const uint32_t* pPixels, int width, int height, int pitch);
+	void AddCounter(uint64_t counter);
+	const PatternCheckStats& Stats() const { return m_stats; }
+
+private:
+	bool DecodeBarcode(const uint32_t* pPixels, int width, int height, int pitch, uint32_t& counter) const;
+	bool DecodeColor(const uint32_t* pPixels, int width, int height, int pitch, int& index) const;
+
+	TestPatternConfig m_config;
+	PatternCheckStats m_stats;
+	uint64_t m_last = 0;
+	bool m_haveLast = false;
+};
+
+// Checks a raw RGBA8 frame dump, e.g. `ffmpeg -i capture.mp4 -f rawvideo -pix_fmt rgba out.rgba`,
+// captured at the render resolution.
+bool CheckPatternCapture(const std::string& path, int width, int height, TestPatternDecoder& decoder, std::string& error);
+std::string FormatPatternCheck(const PatternCheckStats& stats);
+// True when every checked frame decoded, in order, with nothing dropped or repeated.
+bool PatternCheckPassed(const PatternCheckStats& stats);
@@ -0,0 +1,86 @@
+#include "TimerResolution.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <timeapi.h>
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
+TimerCalibration CalibrateWakeGranularity(FrameClock& clock, int samples, int64_t requestTicks) {
+	TimerCalibration calibration;
+	if (samples < 2) samples = 2;
+	if (requestTicks <= 0) requestTicks = clock.Frequency() / 4000;
+
+	// One unmeasured sleep first, so the timer is armed and the thread has run recently.
+	clock.SleepUntil(clock.Now() + requestTicks);
+	std::vector<int64_t> overshoots;
+	overshoots.reserve(samples);
+	for (int i = 0; i < samples; ++i) {
+		int64_t deadline = clock.Now() + requestTicks;
+		clock.SleepUntil(deadline);
+		int64_t overshoot = clock.Now() - deadline;
+		overshoots.push_back(overshoot < 0 ? 0 : overshoot);
+	}
+
+	std::sort(overshoots.begin(), overshoots.end());
+	calibration.samples = samples;
+	calibration.requestTicks = requestTicks;
+	calibration.medianOvershoot = overshoots[overshoots.size() / 2];
+	calibration.granularity = overshoots[overshoots.size() - 2];
+	calibration.maxOvershoot = overshoots.back();
+	return calibration;
+}
+
+std::string FormatTimerCalibration(const TimerCalibration& calibration, int64_t frequency) {
+	const double toUs = 1000000.0 / static_cast<double>(frequency);
+	char buffer[160];
+	snprintf(buffer, sizeof(buffer), "wake granularity=%.1f us median=%.1f us max=%.1f us (%d x %.0f us sleeps)",
+		static_cast<double>(calibration.granularity) * toUs, static_cast<double>(calibration.medianOvershoot) * toUs,
+		static_cast<double>(calibration.maxOvershoot) * toUs, calibration.samples, static_cast<double>(calibration.requestTicks) * toUs);
+	return buffer;
+}
+
+#ifdef _WIN32
+
+bool HighResolutionTimerAvailable() {
+	static const bool available = []() {
+		HANDLE hTimer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+		if (!hTimer) return false;
+		CloseHandle(hTimer);
+		return true;
+	}();
+	return available;
+}
+
+TimerResolutionScope::TimerResolutionScope() {
+	if (HighResolutionTimerAvailable()) return;
+	TIMECAPS caps;
+	unsigned period = 1;
+	if (timeGetDevCaps(&caps, sizeof(caps)) == MMSYSERR_NOERROR && caps.wPeriodMin > 1) period = caps.wPeriodMin;
+	if (timeBeginPeriod(period) == TIMERR_NOERROR) m_periodMs = period;
+}
+
+TimerResolutionScope::~TimerResolutionScope() {
+	if (m_periodMs) timeEndPeriod(m_periodMs);
+}
+
+#else
+
+bool HighResolutionTimerAvailable() {
+	return true;
+}
+
+TimerResolutionScope::TimerResolutionScope() {
+}
+
+TimerResolutionScope::~TimerResolutionScope() {
+}
+
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "FrameClock.h"
+
+// How late short sleeps wake up on this system, in FrameClock ticks.
+struct TimerCalibration {
+	int samples = 0;
+	int64_t requestTicks = 0;
+	int64_t medianOvershoot = 0;
+	// Worst overshoot once the single slowest wake is dropped.
+	int64_t granularity = 0;
+	int64_t maxOvershoot = 0;
+};
+
+// Sleeps `samples` times for `requestTicks` (default 250 us) through the clock's own
+// SleepUntil and measures how far past each deadline it wakes.
+TimerCalibration CalibrateWakeGranularity(FrameClock& clock, int samples = 16, int64_t requestTicks = 0);
+std::string FormatTimerCalibration(const TimerCalibration& calibration, int64_t frequency);
+
+// True when SystemClock sleeps on a high-resolution waitable timer, which needs no
+// raised system timer resolution. Always true off Windows.
+bool HighResolutionTimerAvailable();
+
+// Raises the system timer resolution for a render session, and only when no
+// high-resolution waitable timer is available; the settings window stays at the
+// default rate.
+class TimerResolutionScope {
+public:
+	TimerResolutionScope();
+	~TimerResolutionScope();
+	TimerResolutionScope(const TimerResolutionScope&) = delete;
+	TimerResolutionScope& operator=(const TimerResolutionScope&) = delete;
+
+	// Raised period in milliseconds; 0 when the resolution was left alone.
+	unsigned PeriodMs() const { return m_periodMs; }
+
+private:
+	unsigned m_periodMs = 0;
+};
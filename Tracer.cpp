@@ -0,0 +1,285 @@
+#include "Tracer.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <time.h>
+#endif
+
+std::atomic<bool> Tracer::s_active{ false };
+
+namespace {
+	thread_local void* t_pBuffer = nullptr;
+
+	int64_t QueryFrequency() {
+#ifdef _WIN32
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		return frequency.QuadPart;
+#else
+		return 1000000000;
+#endif
+	}
+
+	double TicksToUs(int64_t ticks, int64_t frequency) {
+		return static_cast<double>(ticks) * 1000000.0 / static_cast<double>(frequency);
+	}
+
+	void WriteJsonString(FILE* file, const char* text) {
+		fputc('"', file);
+		for (const char* c = text; *c; ++c) {
+			if (*c == '"' || *c == '\\') fputc('\\', file);
+			if (static_cast<unsigned char>(*c) >= 0x20) fputc(*c, file);
+		}
+		fputc('"', file);
+	}
+}
+
+Tracer& Tracer::Instance() {
+	static Tracer tracer;
+	return tracer;
+}
+
+int64_t Tracer::Now() {
+#ifdef _WIN32
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart;
+#else
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+int64_t Tracer::Frequency() {
+	static const int64_t frequency = QueryFrequency();
+	return frequency;
+}
+
+Tracer::ThreadBuffer::ThreadBuffer() {
+	for (std::atomic<TraceEvent*>& chunk : chunks) chunk.store(nullptr, std::memory_order_relaxed);
+}
+
+Tracer::ThreadBuffer::~ThreadBuffer() {
+	for (std::atomic<TraceEvent*>& chunk : chunks) delete[] chunk.load(std::memory_order_relaxed);
+}
+
+const TraceEvent& Tracer::ThreadBuffer::At(uint64_t index) const {
+	return chunks[(index / kChunkEvents) % kMaxChunks].load(std::memory_order_acquire)[index % kChunkEvents];
+}
+
+// Buffers live as long as the process, so a thread that exits mid-capture still exports.
+Tracer::ThreadBuffer& Tracer::CurrentBuffer() {
+	if (!t_pBuffer) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		t_pBuffer = &AddBuffer();
+	}
+	return *static_cast<ThreadBuffer*>(t_pBuffer);
+}
+
+// Caller holds m_mutex.
+Tracer::ThreadBuffer& Tracer::AddBuffer() {
+	m_buffers.push_back(std::make_unique<ThreadBuffer>());
+	ThreadBuffer& buffer = *m_buffers.back();
+	buffer.threadId = static_cast<uint32_t>(m_buffers.size());
+	buffer.captureStart.store(0, std::memory_order_relaxed);
+	return buffer;
+}
+
+void Tracer::Start() {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (std::unique_ptr<ThreadBuffer>& buffer : m_buffers) {
+		buffer->captureStart.store(buffer->count.load(std::memory_order_acquire), std::memory_order_release);
+		buffer->dropped.store(0, std::memory_order_relaxed);
+	}
+	m_captureStart = Now();
+	m_captureEnd = 0;
+	s_active.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::Stop() {
+	s_active.store(false, std::memory_order_relaxed);
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_captureEnd = Now();
+}
+
+bool Tracer::InCapture(const TraceEvent& event) const {
+	return event.start >= m_captureStart && (m_captureEnd == 0 || event.start <= m_captureEnd);
+}
+
+void Tracer::SetThreadName(const char* name) {
+	ThreadBuffer& buffer = CurrentBuffer();
+	std::lock_guard<std::mutex> lock(m_mutex);
+	buffer.name = name;
+}
+
+void Tracer::Record(const char* name, int64_t start, int64_t end) {
+	Append(CurrentBuffer(), name, start, end);
+}
+
+void Tracer::RecordOnTrack(const char* track, const TraceEvent* events, size_t count) {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	ThreadBuffer* pBuffer = nullptr;
+	for (std::unique_ptr<ThreadBuffer>& buffer : m_buffers) {
+		if (buffer->track && buffer->name == track) pBuffer = buffer.get();
+	}
+	if (!pBuffer) {
+		pBuffer = &AddBuffer();
+		pBuffer->track = true;
+		pBuffer->name = track;
+	}
+	for (size_t i = 0; i < count; ++i) Append(*pBuffer, events[i].name, events[i].start, events[i].end);
+}
+
+// Only one thread writes a buffer at a time; readers see an event once count covers it.
+// Slots behind captureStart are free to reuse; the capture itself is never overwritten,
+// so an export running alongside reads stable events. A stale captureStart only makes
+// the writer drop early, never overwrite.
+void Tracer::Append(ThreadBuffer& buffer, const char* name, int64_t start, int64_t end) {
+	uint64_t index = buffer.count.load(std::memory_order_relaxed);
+	if (index - buffer.captureStart.load(std::memory_order_acquire) >= ThreadBuffer::kCapacity) {
+		buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+	size_t chunkIndex = static_cast<size_t>((index / ThreadBuffer::kChunkEvents) % ThreadBuffer::kMaxChunks);
+
+	TraceEvent* pChunk = buffer.chunks[chunkIndex].load(std::memory_order_relaxed);
+	if (!pChunk) {
+		pChunk = new TraceEvent[ThreadBuffer::kChunkEvents];
+		buffer.chunks[chunkIndex].store(pChunk, std::memory_order_release);
+	}
+	TraceEvent& event = pChunk[index % ThreadBuffer::kChunkEvents];
+	event.name = name;
+	event.start = start;
+	event.end = end;
+	buffer.count.store(index + 1, std::memory_order_release);
+}
+
+bool Tracer::WriteChromeTrace(const std::string& path, std::string& error) const {
+	FILE* file = nullptr;
+#ifdef _MSC_VER
+	if (fopen_s(&file, path.c_str(), "w") != 0) file = nullptr;
+#else
+	file = fopen(path.c_str(), "w");
+#endif
+	if (!file) {
+		error = "cannot open trace file '" + path + "'";
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const int64_t frequency = Frequency();
+	bool first = true;
+	fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+	for (const std::unique_ptr<ThreadBuffer>& buffer : m_buffers) {
+		uint64_t count = buffer->count.load(std::memory_order_acquire);
+		uint64_t captureStart = buffer->captureStart.load(std::memory_order_relaxed);
+		if (count == captureStart) continue;
+
+		if (!buffer->name.empty()) {
+			fprintf(file, "%s\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %u, \"args\": {\"name\": ", first ? "" : ",", buffer->threadId);
+			WriteJsonString(file, buffer->name.c_str());
+			fprintf(file, "}}");
+			first = false;
+		}
+		for (uint64_t i = captureStart; i < count; ++i) {
+			const TraceEvent& event = buffer->At(i);
+			if (!InCapture(event)) continue;
+			fprintf(file, "%s\n{\"name\": ", first ? "" : ",");
+			WriteJsonString(file, event.name);
+			fprintf(file, ", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}", buffer->threadId,
+				TicksToUs(event.start - m_captureStart, frequency), TicksToUs(event.end - event.start, frequency));
+			first = false;
+		}
+	}
+	fprintf(file, "\n], \"otherData\": {\"dropped_events\": %llu}}\n", static_cast<unsigned long long>(SumDropped()));
+
+	bool ok = ferror(file) == 0;
+	if (fclose(file) != 0) ok = false;
+	if (!ok) error = "failed writing trace file '" + path + "'";
+	return ok;
+}
+
+std::vector<TraceZoneSummary> Tracer::Summarize() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	const int64_t frequency = Frequency();
+	// Keyed by text: the same literal can have a different address in each translation unit.
+	std::map<std::string, TraceZoneSummary> zones;
+	for (const std::unique_ptr<ThreadBuffer>& buffer : m_buffers) {
+		uint64_t count = buffer->count.load(std::memory_order_acquire);
+		for (uint64_t i = buffer->captureStart.load(std::memory_order_relaxed); i < count; ++i) {
+			const TraceEvent& event = buffer->At(i);
+			if (!InCapture(event)) continue;
+			TraceZoneSummary& zone = zones[event.name];
+			double us = TicksToUs(event.end - event.start, frequency);
+			zone.count++;
+			zone.totalMs += us / 1000.0;
+			if (us > zone.maxUs) zone.maxUs = us;
+		}
+	}
+
+	std::vector<TraceZoneSummary> summary;
+	for (std::pair<const std::string, TraceZoneSummary>& zone : zones) {
+		zone.second.name = zone.first;
+		zone.second.meanUs = zone.second.totalMs * 1000.0 / static_cast<double>(zone.second.count);
+		summary.push_back(zone.second);
+	}
+	std::sort(summary.begin(), summary.end(), [](const TraceZoneSummary& a, const TraceZoneSummary& b) { return a.totalMs > b.totalMs; });
+	return summary;
+}
+
+uint64_t Tracer::DroppedEvents() const {
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return SumDropped();
+}
+
+uint64_t Tracer::SumDropped() const {
+	uint64_t dropped = 0;
+	for (const std::unique_ptr<ThreadBuffer>& buffer : m_buffers) dropped += buffer->dropped.load(std::memory_order_relaxed);
+	return dropped;
+}
+
+TraceOverhead Tracer::MeasureOverhead(size_t zones) {
+	TraceOverhead overhead;
+	if (zones == 0 || Active()) return overhead;
+
+	const double nsPerTick = 1e9 / static_cast<double>(Frequency());
+	int64_t start = Now();
+	for (size_t i = 0; i < zones; ++i) {
+		TraceZone zone("trace overhead");
+	}
+	overhead.disabledNs = static_cast<double>(Now() - start) * nsPerTick / static_cast<double>(zones);
+
+	// Recorded outside any capture, so the next Start() skips these events.
+	s_active.store(true, std::memory_order_relaxed);
+	start = Now();
+	for (size_t i = 0; i < zones; ++i) {
+		TraceZone zone("trace overhead");
+	}
+	overhead.enabledNs = static_cast<double>(Now() - start) * nsPerTick / static_cast<double>(zones);
+	s_active.store(false, std::memory_order_relaxed);
+	return overhead;
+}
+
+std::string FormatTraceSummary(const std::vector<TraceZoneSummary>& zones, size_t limit) {
+	std::string text;
+	for (size_t i = 0; i < zones.size() && i < limit; ++i) {
+		const TraceZoneSummary& zone = zones[i];
+		char buffer[192];
+		snprintf(buffer, sizeof(buffer), "%s%s %llux %.3f ms mean %.1f us max %.1f us", i ? ", " : "", zone.name.c_str(),
+			static_cast<unsigned long long>(zone.count), zone.totalMs, zone.meanUs, zone.maxUs);
+		text += buffer;
+	}
+	return text.empty() ? std::string("no zones") : text;
+}
+
+std::string FormatTraceOverhead(const TraceOverhead& overhead) {
+	char buffer[96];
+	snprintf(buffer, sizeof(buffer), "per zone off=%.1f ns on=%.1f ns", overhead.disabledNs, overhead.enabledNs);
+	return buffer;
+}
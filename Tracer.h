@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Build with CUSTOMFPS_TRACING=0 to compile every TRACE_ZONE out.
+#ifndef CUSTOMFPS_TRACING
+#define CUSTOMFPS_TRACING 1
+#endif
+
+struct TraceEvent {
+	// String literal; only the pointer is stored.
+	const char* name;
+	int64_t start;
+	int64_t end;
+};
+
+struct TraceZoneSummary {
+	std::string name;
+	uint64_t count = 0;
+	double totalMs = 0.0;
+	double meanUs = 0.0;
+	double maxUs = 0.0;
+};
+
+struct TraceOverhead {
+	// Per zone, with tracing switched off at runtime and while capturing.
+	double disabledNs = 0.0;
+	double enabledNs = 0.0;
+};
+
+// Process-wide scoped-zone recorder. Each thread appends to its own buffer without
+// locks; the registry mutex is only taken the first time a thread records, when a
+// capture starts, and on export. Buffers grow in fixed chunks that are never moved, so
+// a capture can be exported while other threads are still recording. The chunks form a
+// ring: events from before the current capture are overwritten, and only a capture
+// longer than the ring drops events. Nesting is not stored: zones on one thread nest by
+// time, which is how trace viewers draw them.
+class Tracer {
+public:
+	static Tracer& Instance();
+
+	static bool Active() { return s_active.load(std::memory_order_relaxed); }
+	static int64_t Now();
+	static int64_t Frequency();
+
+	// Start discards nothing: events before it stay in the buffers but are not exported.
+	void Start();
+	void Stop();
+	// Names the calling thread in exported traces.
+	void SetThreadName(const char* name);
+	void Record(const char* name, int64_t start, int64_t end);
+	// Appends to a named timeline that belongs to no thread, such as a GPU queue; the
+	// track is created on first use. Takes the registry mutex once per call.
+	void RecordOnTrack(const char* track, const TraceEvent* events, size_t count);
+
+	// Events of the last capture, per thread, with the drop count under "otherData".
+	// Chrome trace JSON loads in chrome://tracing and ui.perfetto.dev.
+	bool WriteChromeTrace(const std::string& path, std::string& error) const;
+	// Zones of the last capture grouped by name, most total time first.
+	std::vector<TraceZoneSummary> Summarize() const;
+	uint64_t DroppedEvents() const;
+	// Times `zones` empty zones each way. Not while capturing: the events would land in it.
+	TraceOverhead MeasureOverhead(size_t zones);
+
+private:
+	struct ThreadBuffer {
+		static const size_t kChunkEvents = 4096;
+		static const size_t kMaxChunks = 1024;
+		static const uint64_t kCapacity = static_cast<uint64_t>(kChunkEvents) * kMaxChunks;
+
+		ThreadBuffer();
+		~ThreadBuffer();
+		const TraceEvent& At(uint64_t index) const;
+
+		std::atomic<TraceEvent*> chunks[kMaxChunks];
+		std::atomic<uint64_t> count{ 0 };
+		std::atomic<uint64_t> dropped{ 0 };
+		// Index of the first event of the current capture. Written under m_mutex; the
+		// recording thread reads it to know which events it may overwrite.
+		std::atomic<uint64_t> captureStart{ 0 };
+		uint32_t threadId = 0;
+		std::string name;
+		bool track = false;
+	};
+
+	Tracer() = default;
+	ThreadBuffer& CurrentBuffer();
+	ThreadBuffer& AddBuffer();
+	static void Append(ThreadBuffer& buffer, const char* name, int64_t start, int64_t end);
+	// Zones still open at Stop() are kept; ones left over from an earlier capture are not.
+	bool InCapture(const TraceEvent& event) const;
+	// Caller holds m_mutex.
+	uint64_t SumDropped() const;
+
+	static std::atomic<bool> s_active;
+	mutable std::mutex m_mutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+	int64_t m_captureStart = 0;
+	int64_t m_captureEnd = 0;
+};
+
+// Records one zone from construction to destruction while a capture is running; costs
+// one relaxed load otherwise.
+class TraceZone {
+public:
+	explicit TraceZone(const char* name) : m_name(name), m_start(Tracer::Active() ? Tracer::Now() : 0) {}
+	~TraceZone() {
+		if (m_start != 0) Tracer::Instance().Record(m_name, m_start, Tracer::Now());
+	}
+	TraceZone(const TraceZone&) = delete;
+	TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+	const char* m_name;
+	int64_t m_start;
+};
+
+#if CUSTOMFPS_TRACING
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_ZONE(name) TraceZone TRACE_CONCAT(traceZone, __LINE__)(name)
+#define TRACE_THREAD_NAME(name) Tracer::Instance().SetThreadName(name)
+#else
+#define TRACE_ZONE(name) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#endif
+
+// "present 1200x 974.8 ms mean 812.3 us max 2400.0 us, clear ..." (top `limit` zones).
+std::string FormatTraceSummary(const std::vector<TraceZoneSummary>& zones, size_t limit = 8);
+std::string FormatTraceOverhead(const TraceOverhead& overhead);
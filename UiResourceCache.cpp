@@ -0,0 +1,138 @@
+#include "UiResourceCache.h"
+
+namespace {
+	const Gdiplus::REAL kButtonRadius = 15.0f;
+
+	int64_t QueryTicks() {
+		LARGE_INTEGER counter;
+		QueryPerformanceCounter(&counter);
+		return counter.QuadPart;
+	}
+}
+
+UiResourceCache::UiResourceCache() {
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	m_frequency = frequency.QuadPart;
+	m_backgroundCost.Reset(m_frequency);
+	m_itemCost.Reset(m_frequency);
+}
+
+UiResourceCache::~UiResourceCache() {
+	Destroy();
+}
+
+void UiResourceCache::Create(int backgroundWidth, int backgroundHeight) {
+	using namespace Gdiplus;
+	Destroy();
+	m_backgroundWidth = backgroundWidth;
+	m_backgroundHeight = backgroundHeight;
+	m_backgroundCost.Reset(m_frequency);
+	m_itemCost.Reset(m_frequency);
+
+	m_pComboFont.reset(new Font(L"Segoe UI", 16, FontStyleRegular, UnitPixel));
+	m_pButtonBrush.reset(new SolidBrush(Color(20, 0, 0, 0)));
+	m_pButtonPressedBrush.reset(new SolidBrush(Color(40, 0, 0, 0)));
+	m_pShadowBrush.reset(new SolidBrush(Color(60, 0, 0, 0)));
+	m_pWhiteBrush.reset(new SolidBrush(Color(255, 255, 255, 255)));
+	m_pBlackBrush.reset(new SolidBrush(Color(255, 0, 0, 0)));
+	m_pSelectedBrush.reset(new SolidBrush(Color(220, 235, 255)));
+	m_pFocusPen.reset(new Pen(Color(100, 33, 150, 243), 2.0f));
+
+	m_pCenteredFormat.reset(new StringFormat());
+	m_pCenteredFormat->SetAlignment(StringAlignmentCenter);
+	m_pCenteredFormat->SetLineAlignment(StringAlignmentCenter);
+	m_pLeftFormat.reset(new StringFormat());
+	m_pLeftFormat->SetAlignment(StringAlignmentNear);
+	m_pLeftFormat->SetLineAlignment(StringAlignmentCenter);
+}
+
+void UiResourceCache::Destroy() {
+	m_pCachedBackground.reset();
+	m_pBackground.reset();
+	m_buttonPaths.clear();
+	m_fonts.clear();
+	m_pComboFont.reset();
+	m_pButtonBrush.reset();
+	m_pButtonPressedBrush.reset();
+	m_pShadowBrush.reset();
+	m_pWhiteBrush.reset();
+	m_pBlackBrush.reset();
+	m_pSelectedBrush.reset();
+	m_pFocusPen.reset();
+	m_pCenteredFormat.reset();
+	m_pLeftFormat.reset();
+}
+
+bool UiResourceCache::BuildBackground(Gdiplus::Graphics& graphics) {
+	using namespace Gdiplus;
+	if (!m_pBackground) {
+		m_pBackground.reset(new Bitmap(m_backgroundWidth, m_backgroundHeight, PixelFormat32bppPARGB));
+		if (m_pBackground->GetLastStatus() != Ok) {
+			m_pBackground.reset();
+			return false;
+		}
+		Graphics target(m_pBackground.get());
+		Rect rc(0, 0, m_backgroundWidth, m_backgroundHeight);
+		LinearGradientBrush gradient(rc, Color(255, 33, 150, 243), Color(255, 13, 71, 161), LinearGradientModeVertical);
+		target.FillRectangle(&gradient, rc);
+	}
+	// CachedBitmap is converted to the screen format up front, so drawing it is a plain blit.
+	m_pCachedBackground.reset(new CachedBitmap(m_pBackground.get(), &graphics));
+	if (m_pCachedBackground->GetLastStatus() != Ok) {
+		m_pCachedBackground.reset();
+		return false;
+	}
+	return true;
+}
+
+void UiResourceCache::DrawBackground(Gdiplus::Graphics& graphics) {
+	using namespace Gdiplus;
+	if (!m_pCachedBackground && !BuildBackground(graphics)) {
+		if (m_pBackground) graphics.DrawImage(m_pBackground.get(), 0, 0);
+		return;
+	}
+	// Fails once the display bit depth changes; rebuild against the new format.
+	if (graphics.DrawCachedBitmap(m_pCachedBackground.get(), 0, 0) != Ok && BuildBackground(graphics)) {
+		graphics.DrawCachedBitmap(m_pCachedBackground.get(), 0, 0);
+	}
+}
+
+const Gdiplus::GraphicsPath* UiResourceCache::ButtonPath(int width, int height) {
+	using namespace Gdiplus;
+	for (const ButtonPathEntry& entry : m_buttonPaths) {
+		if (entry.width == width && entry.height == height) return entry.path.get();
+	}
+
+	ButtonPathEntry entry{ width, height, std::unique_ptr<GraphicsPath>(new GraphicsPath()) };
+	REAL right = REAL(width);
+	REAL bottom = REAL(height);
+	REAL diameter = kButtonRadius * 2;
+	entry.path->AddArc(0.0f, 0.0f, diameter, diameter, 180, 90);
+	entry.path->AddArc(right - diameter, 0.0f, diameter, diameter, 270, 90);
+	entry.path->AddArc(right - diameter, bottom - diameter, diameter, diameter, 0, 90);
+	entry.path->AddArc(0.0f, bottom - diameter, diameter, diameter, 90, 90);
+	entry.path->CloseFigure();
+	m_buttonPaths.push_back(std::move(entry));
+	return m_buttonPaths.back().path.get();
+}
+
+Gdiplus::Font* UiResourceCache::FontFor(HDC hdc, HFONT hFont) {
+	for (const FontEntry& entry : m_fonts) {
+		if (entry.hFont == hFont) return entry.font.get();
+	}
+	LOGFONTW lf;
+	if (!hFont || GetObjectW(hFont, sizeof(LOGFONTW), &lf) == 0) return m_pComboFont.get();
+	m_fonts.push_back(FontEntry{ hFont, std::unique_ptr<Gdiplus::Font>(new Gdiplus::Font(hdc, &lf)) });
+	return m_fonts.back().font.get();
+}
+
+int64_t UiResourceCache::PaintStart() const {
+	return QueryTicks();
+}
+
+void UiResourceCache::PaintEnd(int64_t start, bool background) {
+	int64_t cost = QueryTicks() - start;
+	if (background) m_backgroundCost.Add(cost);
+	else m_itemCost.Add(cost);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <Windows.h>
+#include <gdiplus.h>
+#include <memory>
+#include <vector>
+#include "FrameStatistics.h"
+
+// GDI+ objects for the owner-drawn settings window, built once per window instead of
+// on every WM_PAINT / WM_DRAWITEM: the background gradient pre-rendered into a
+// CachedBitmap, one rounded-rect path per button size, a GDI+ font per HFONT, and the
+// brushes, pens and string formats the controls draw with. Also times every paint so
+// the per-paint cost can be logged when the window closes.
+class UiResourceCache {
+public:
+	UiResourceCache();
+	~UiResourceCache();
+	UiResourceCache(const UiResourceCache&) = delete;
+	UiResourceCache& operator=(const UiResourceCache&) = delete;
+
+	// Create and Destroy bracket one window's lifetime; Destroy must run before GdiplusShutdown.
+	void Create(int backgroundWidth, int backgroundHeight);
+	void Destroy();
+
+	// Blits the pre-rendered background; rebuilds it when the display format changed.
+	void DrawBackground(Gdiplus::Graphics& graphics);
+	// Rounded rectangle of the given size at the origin.
+	const Gdiplus::GraphicsPath* ButtonPath(int width, int height);
+	Gdiplus::Font* FontFor(HDC hdc, HFONT hFont);
+
+	Gdiplus::Font* ComboFont() const { return m_pComboFont.get(); }
+	Gdiplus::SolidBrush* ButtonBrush(bool pressed) const { return pressed ? m_pButtonPressedBrush.get() : m_pButtonBrush.get(); }
+	Gdiplus::SolidBrush* ShadowBrush() const { return m_pShadowBrush.get(); }
+	Gdiplus::SolidBrush* WhiteBrush() const { return m_pWhiteBrush.get(); }
+	Gdiplus::SolidBrush* BlackBrush() const { return m_pBlackBrush.get(); }
+	Gdiplus::SolidBrush* SelectedBrush() const { return m_pSelectedBrush.get(); }
+	Gdiplus::Pen* FocusPen() const { return m_pFocusPen.get(); }
+	const Gdiplus::StringFormat* CenteredFormat() const { return m_pCenteredFormat.get(); }
+	const Gdiplus::StringFormat* LeftFormat() const { return m_pLeftFormat.get(); }
+
+	int64_t PaintStart() const;
+	void PaintEnd(int64_t start, bool background);
+	const FrameStatistics& BackgroundCost() const { return m_backgroundCost; }
+	const FrameStatistics& ItemCost() const { return m_itemCost; }
+
+private:
+	struct ButtonPathEntry {
+		int width;
+		int height;
+		std::unique_ptr<Gdiplus::GraphicsPath> path;
+	};
+	struct FontEntry {
+		HFONT hFont;
+		std::unique_ptr<Gdiplus::Font> font;
+	};
+
+	bool BuildBackground(Gdiplus::Graphics& graphics);
+
+	int m_backgroundWidth = 0;
+	int m_backgroundHeight = 0;
+	std::unique_ptr<Gdiplus::Bitmap> m_pBackground;
+	std::unique_ptr<Gdiplus::CachedBitmap> m_pCachedBackground;
+	std::vector<ButtonPathEntry> m_buttonPaths;
+	std::vector<FontEntry> m_fonts;
+	std::unique_ptr<Gdiplus::Font> m_pComboFont;
+	std::unique_ptr<Gdiplus::SolidBrush> m_pButtonBrush;
+	std::unique_ptr<Gdiplus::SolidBrush> m_pButtonPressedBrush;
+	std::unique_ptr<Gdiplus::SolidBrush> m_pShadowBrush;
+	std::unique_ptr<Gdiplus::SolidBrush> m_pWhiteBrush;
+	std::unique_ptr<Gdiplus::SolidBrush> m_pBlackBrush;
+	std::unique_ptr<Gdiplus::SolidBrush> m_pSelectedBrush;
+	std::unique_ptr<Gdiplus::Pen> m_pFocusPen;
+	std::unique_ptr<Gdiplus::StringFormat> m_pCenteredFormat;
+	std::unique_ptr<Gdiplus::StringFormat> m_pLeftFormat;
+
+	int64_t m_frequency = 0;
+	FrameStatistics m_backgroundCost;
+	FrameStatistics m_itemCost;
+};
@@ -0,0 +1,69 @@
+#include "WorkerPool.h"
+
+#include "Tracer.h"
+
+WorkerPool::WorkerPool(int workerCount) {
+	if (workerCount < 0) {
+		int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+		workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+	for (int i = 0; i < workerCount; ++i) {
+		m_threads.emplace_back(&WorkerPool::WorkerMain, this);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_wake.notify_all();
+	for (std::thread& thread : m_threads) thread.join();
+}
+
+void WorkerPool::ParallelFor(int taskCount, const std::function<void(int)>& task) {
+	if (m_threads.empty() || taskCount <= 1) {
+		for (int i = 0; i < taskCount; ++i) task(i);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_pTask = &task;
+		m_taskCount = taskCount;
+		m_nextTask.store(0, std::memory_order_relaxed);
+		m_busyWorkers = static_cast<int>(m_threads.size());
+		m_generation++;
+	}
+	m_wake.notify_all();
+
+	RunTasks();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_done.wait(lock, [this] { return m_busyWorkers == 0; });
+	m_pTask = nullptr;
+}
+
+void WorkerPool::RunTasks() {
+	for (int i = m_nextTask.fetch_add(1); i < m_taskCount; i = m_nextTask.fetch_add(1)) {
+		TRACE_ZONE("worker task");
+		(*m_pTask)(i);
+	}
+}
+
+void WorkerPool::WorkerMain() {
+	TRACE_THREAD_NAME("worker");
+	uint64_t seenGeneration = 0;
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true) {
+		m_wake.wait(lock, [&] { return m_stopping || m_generation != seenGeneration; });
+		if (m_stopping) return;
+		seenGeneration = m_generation;
+
+		lock.unlock();
+		RunTasks();
+		lock.lock();
+
+		if (--m_busyWorkers == 0) m_done.notify_one();
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that split an indexed task range with the calling thread.
+class WorkerPool {
+public:
+	explicit WorkerPool(int workerCount = -1);
+	~WorkerPool();
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	int ThreadCount() const { return static_cast<int>(m_threads.size()) + 1; }
+	void ParallelFor(int taskCount, const std::function<void(int)>& task);
+
+private:
+	void WorkerMain();
+	void RunTasks();
+
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	const std::function<void(int)>* m_pTask = nullptr;
+	int m_taskCount = 0;
+	std::atomic<int> m_nextTask{ 0 };
+	int m_busyWorkers = 0;
+	uint64_t m_generation = 0;
+	bool m_stopping = false;
+};
@@ -0,0 +1,83 @@
+#include <cstdio>
+#include <cstdlib>
+#include "FrameClock.h"
+#include "FramePacer.h"
+#include "FrameStatistics.h"
+#include "TimerResolution.h"
+
+// FramePacer on the real SystemClock: for each target rate, how far past its deadline
+// every frame wakes and what the wait costs in CPU time, against a plain SleepUntil.
+// Fails when the pacer ever returns before a deadline, so a short run doubles as a test.
+// Usage: bench-pacer [seconds per rate, default 2]
+
+namespace {
+	struct PacingResult {
+		FrameStatistics error;
+		double cpuUsPerFrame = 0.0;
+		PacerStats stats;
+		uint64_t early = 0;
+	};
+
+	template<typename Wait>
+	PacingResult MeasurePacing(SystemClock& clock, int fps, double seconds, Wait wait) {
+		PacingResult result;
+		result.error.Reset(clock.Frequency());
+		const int64_t period = clock.Frequency() / fps;
+		const int frames = static_cast<int>(seconds * fps);
+		int64_t deadline = clock.Now() + period;
+		double cpuStart = ProcessCpuSeconds();
+		for (int i = 0; i < frames; ++i) {
+			int64_t woke = wait(deadline);
+			if (woke < deadline) result.early++;
+			else result.error.Add(woke - deadline);
+			deadline += period;
+			// A late frame starts the grid over, as the Skip policy would.
+			if (woke > deadline) deadline = woke + period;
+		}
+		result.cpuUsPerFrame = (ProcessCpuSeconds() - cpuStart) * 1e6 / frames;
+		return result;
+	}
+
+	void PrintResult(const char* mode, int fps, const PacingResult& result, int64_t frequency) {
+		const FrameStatistics& error = result.error;
+		printf("%-6s %5d fps frames=%llu error p50=%.1f us p99=%.1f us p99.9=%.1f us max=%.1f us cpu=%.1f us/frame",
+			mode, fps, static_cast<unsigned long long>(error.Count()), error.QuantileMs(0.5) * 1000.0, error.QuantileMs(0.99) * 1000.0,
+			error.QuantileMs(0.999) * 1000.0, error.Summary().maxMs * 1000.0, result.cpuUsPerFrame);
+		if (result.stats.waits > 0) {
+			printf(" sleeps=%.0f%% spin=%.1f us/frame", 100.0 * static_cast<double>(result.stats.sleeps) / static_cast<double>(result.stats.waits),
+				static_cast<double>(result.stats.spinTicks) * 1e6 / static_cast<double>(frequency) / static_cast<double>(result.stats.waits));
+		}
+		printf("\n");
+	}
+}
+
+int main(int argc, char** argv) {
+	double seconds = argc > 1 ? atof(argv[1]) : 2.0;
+	if (seconds <= 0.0) seconds = 2.0;
+
+	SystemClock clock;
+	TimerCalibration calibration = CalibrateWakeGranularity(clock);
+	printf("timer %s\n", FormatTimerCalibration(calibration, clock.Frequency()).c_str());
+
+	const int rates[] = { 60, 144, 240, 500, 1000 };
+	uint64_t early = 0;
+	for (int fps : rates) {
+		FramePacer pacer(clock);
+		pacer.SetCalibration(calibration);
+		PacingResult paced = MeasurePacing(clock, fps, seconds, [&pacer](int64_t deadline) { return pacer.WaitUntil(deadline); });
+		paced.stats = pacer.Stats();
+		PrintResult("pacer", fps, paced, clock.Frequency());
+		early += paced.early;
+
+		PacingResult slept = MeasurePacing(clock, fps, seconds, [&clock](int64_t deadline) {
+			clock.SleepUntil(deadline);
+			return clock.Now();
+		});
+		PrintResult("sleep", fps, slept, clock.Frequency());
+	}
+	if (early > 0) {
+		printf("pacer returned early %llu times\n", static_cast<unsigned long long>(early));
+		return 1;
+	}
+	return 0;
+}
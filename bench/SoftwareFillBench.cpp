@@ -0,0 +1,77 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "FrameClock.h"
+#include "SoftwareFill.h"
+
+// SoftwareFill across resolutions from 800x600 to 8K: scalar on one thread against the
+// detected kernel on one thread and on the whole pool. Reports ms per fill and GB/s.
+// Usage: bench-software-fill [seconds per case, default 0.5]
+
+namespace {
+	struct FillCase {
+		const char* name;
+		FillKernel kernel;
+		int workers;
+	};
+
+	double MeasureFill(SystemClock& clock, SoftwareFill& fill, std::vector<uint32_t>& pixels, int width, int height, double seconds, int& fills) {
+		const int64_t budget = static_cast<int64_t>(seconds * static_cast<double>(clock.Frequency()));
+		uint32_t value = 0xff000000u;
+		fills = 0;
+		fill.Fill(pixels.data(), width, height, width, value);
+		int64_t start = clock.Now();
+		int64_t now = start;
+		while (now - start < budget || fills < 3) {
+			fill.Fill(pixels.data(), width, height, width, ++value);
+			fills++;
+			now = clock.Now();
+		}
+		return static_cast<double>(now - start) * 1000.0 / static_cast<double>(clock.Frequency()) / fills;
+	}
+}
+
+int main(int argc, char** argv) {
+	double seconds = argc > 1 ? atof(argv[1]) : 0.5;
+	if (seconds <= 0.0) seconds = 0.5;
+
+	const int resolutions[][2] = { { 800, 600 }, { 1280, 720 }, { 1920, 1080 }, { 2560, 1440 }, { 3840, 2160 }, { 5120, 2880 }, { 7680, 4320 } };
+	const FillKernel best = DetectFillKernel();
+	const FillCase cases[] = {
+		{ "scalar x1", FillKernel::Scalar, 0 },
+		{ "best x1", best, 0 },
+		{ "best pool", best, -1 },
+	};
+
+	SystemClock clock;
+	int failures = 0;
+	for (const FillCase& fillCase : cases) {
+		SoftwareFill fill(fillCase.workers);
+		fill.SetKernel(fillCase.kernel);
+		printf("%s: kernel=%s threads=%d\n", fillCase.name, FillKernelName(fillCase.kernel), fill.ThreadCount());
+		for (const int* resolution : resolutions) {
+			const int width = resolution[0], height = resolution[1];
+			std::vector<uint32_t> pixels(static_cast<size_t>(width) * height);
+			int fills = 0;
+			double ms = MeasureFill(clock, fill, pixels, width, height, seconds, fills);
+			double bytes = static_cast<double>(pixels.size()) * 4.0;
+			printf("  %5dx%-5d %8.3f ms/fill %7.2f GB/s (%d fills)\n", width, height, ms, bytes / (ms / 1000.0) / 1e9, fills);
+
+			// Every pixel holds the last value written, first and last rows included.
+			uint32_t last = pixels[0];
+			for (size_t i = 0; i < pixels.size(); i += 4099) {
+				if (pixels[i] != last) {
+					failures++;
+					break;
+				}
+			}
+			if (pixels.back() != last) failures++;
+		}
+	}
+	if (failures > 0) {
+		printf("%d fills left stale pixels\n", failures);
+		return 1;
+	}
+	return 0;
+}
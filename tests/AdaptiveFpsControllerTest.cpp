@@ -0,0 +1,161 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AdaptiveFpsController.h"
+#include "BenchmarkRun.h"
+#include "FakeClock.h"
+#include "FrameLoop.h"
+#include "RenderBackend.h"
+#include "RunConfig.h"
+#include "TestCheck.h"
+
+// The search runs against a simulated machine: a FakeClock and a backend whose every
+// frame costs a fixed slice of simulated time, so the highest sustainable rate is known
+// exactly and a whole search takes milliseconds.
+
+namespace {
+	const int64_t kFrequency = 1000000000;
+
+	// Renders at most capacityFps: each frame's work is charged to the clock at Present.
+	class SyntheticBackend : public RenderBackend {
+	public:
+		SyntheticBackend(FakeClock& clock, double capacityFps)
+			: m_clock(clock), m_frameCost(static_cast<int64_t>(static_cast<double>(kFrequency) / capacityFps)) {}
+
+		bool Init(int, int) override { return true; }
+		void WaitForPresentSlot() override {}
+		void BeginFrame(uint64_t, int64_t) override {}
+		void RenderWorkload(int) override {}
+		void Clear(const float*) override {}
+		void DrawTestPattern(const TestPattern&) override {}
+		void DrawOverlay(const PerfOverlay&) override {}
+		void Present() override { m_clock.Advance(m_frameCost); }
+		int PresentDelayFrames() const override { return 0; }
+		void Resize(int, int) override {}
+		void Cleanup() override {}
+
+	private:
+		FakeClock& m_clock;
+		int64_t m_frameCost;
+	};
+
+	struct SearchOutcome {
+		int bestFps = 0;
+		std::vector<AdaptiveProbe> probes;
+		std::vector<RunStepResult> results;
+	};
+
+	SearchOutcome RunSearch(double capacityFps, int minFps, int maxFps) {
+		FakeClock clock(kFrequency);
+		clock.SetWakeLatencies({ 20000, 35000, 25000 });
+		SyntheticBackend backend(clock, capacityFps);
+		RunConfig config;
+		config.findMaxFps = true;
+		config.adaptive.minFps = minFps;
+		config.adaptive.maxFps = maxFps;
+		config.warmupSeconds = 0.1;
+		config.durationSeconds = 0.2;
+		FrameLoop loop(backend, clock, minFps);
+		BenchmarkRun run(loop, config);
+		run.Start();
+		for (int frame = 0; frame < 1000000 && run.Tick(); ++frame) {}
+		CHECK(run.Finished());
+		CHECK(run.Search().Done());
+
+		SearchOutcome outcome;
+		outcome.bestFps = run.Search().BestFps();
+		outcome.probes = run.Search().Probes();
+		outcome.results = run.Results();
+		return outcome;
+	}
+
+	// After the ramp every probe lies inside the bracket of the best pass and the lowest
+	// fail so far, or re-probes the best pass to confirm it: the search never swings back.
+	void CheckBracketShrinks(const std::vector<AdaptiveProbe>& probes) {
+		int low = 0;
+		int high = 0;
+		bool ramped = false;
+		uint64_t outside = 0;
+		for (const AdaptiveProbe& probe : probes) {
+			if (ramped && (probe.targetFps < low || (high > 0 && probe.targetFps >= high))) outside++;
+			if (probe.passed && probe.targetFps > low) low = probe.targetFps;
+			if (!probe.passed) {
+				if (high == 0 || probe.targetFps < high) high = probe.targetFps;
+				ramped = true;
+			}
+		}
+		CHECK_EQ(outside, 0);
+	}
+
+	void TestConvergesOnCapacity() {
+		const double capacities[] = { 75.0, 144.0, 347.0, 613.0 };
+		for (double capacity : capacities) {
+			SearchOutcome outcome = RunSearch(capacity, 30, 1000);
+			// A rate up to 1% above capacity still passes the achieved-rate check.
+			int resolution = AdaptiveFpsConfig().resolutionFps;
+			CHECK(outcome.bestFps >= static_cast<int>(capacity) - resolution);
+			CHECK(outcome.bestFps <= static_cast<int>(capacity * 1.01) + resolution);
+			// Doubling from 30 to 1000, then bisecting down to 2 fps, plus one confirm.
+			CHECK(outcome.probes.size() <= 17);
+			CheckBracketShrinks(outcome.probes);
+			CHECK_EQ(outcome.results.size(), 1);
+			if (!outcome.results.empty()) {
+				CHECK_EQ(outcome.results[0].targetFps, outcome.bestFps);
+				CHECK(outcome.results[0].sustainable);
+			}
+		}
+	}
+
+	void TestCappedAtMaxFps() {
+		SearchOutcome outcome = RunSearch(5000.0, 30, 1000);
+		CHECK_EQ(outcome.bestFps, 1000);
+		CheckBracketShrinks(outcome.probes);
+	}
+
+	// Even minFps is too fast: nothing is sustainable, and the bottom rate is measured.
+	void TestNothingSustainable() {
+		SearchOutcome outcome = RunSearch(20.0, 30, 1000);
+		CHECK_EQ(outcome.bestFps, 0);
+		CHECK_EQ(outcome.probes.size(), 1);
+		CHECK_EQ(outcome.results.size(), 1);
+		if (!outcome.results.empty()) {
+			CHECK_EQ(outcome.results[0].targetFps, 30);
+			CHECK(!outcome.results[0].sustainable);
+		}
+	}
+
+	// One stall per window is the drop budget's business, not a failed rate.
+	void TestRareHitchPasses() {
+		AdaptiveFpsConfig config;
+		config.minFps = 100;
+		config.maxFps = 100;
+		AdaptiveFpsController controller(kFrequency, config);
+		controller.Start();
+		const int64_t period = kFrequency / 100;
+		for (int frame = 0; frame < 1000 && !controller.Done(); ++frame) {
+			controller.AddFrame(frame == 60 ? period * 2 : period);
+		}
+		CHECK(controller.Done());
+		CHECK_EQ(controller.BestFps(), 100);
+		CHECK(!controller.Probes().empty() && controller.Probes()[0].passed);
+	}
+
+	void TestRejectsInvertedRange() {
+		RunConfig config;
+		std::string error;
+		CHECK(!ParseRunArguments({ "--find-max", "--min-fps", "500", "--max-fps", "200" }, config, error));
+		CHECK(error.find("min-fps") != std::string::npos);
+
+		RunConfig valid;
+		CHECK(ParseRunArguments({ "--find-max", "--min-fps", "200", "--max-fps", "200" }, valid, error));
+	}
+}
+
+int main() {
+	TestConvergesOnCapacity();
+	TestCappedAtMaxFps();
+	TestNothingSustainable();
+	TestRareHitchPasses();
+	TestRejectsInvertedRange();
+	return TestExitCode();
+}
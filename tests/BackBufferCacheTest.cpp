@@ -0,0 +1,120 @@
+#include <cstdint>
+#include "BackBufferCache.h"
+#include "TestCheck.h"
+
+// A stand-in swap chain that counts every call the way COM calls would be counted,
+// driven through the cache the same way D3D11Backend drives it.
+
+namespace {
+	struct MockSwapChain {
+		int bufferCount = 3;
+		int failBuffer = -1;
+		uint64_t getBufferCalls = 0;
+		uint64_t createViewCalls = 0;
+		uint64_t releaseCalls = 0;
+		int liveHandles = 0;
+
+		uint64_t Calls() const { return getBufferCalls + createViewCalls + releaseCalls; }
+	};
+
+	struct MockEntry {
+		int texture = -1;
+		int view = -1;
+	};
+
+	bool Acquire(MockSwapChain& swapChain, int index, MockEntry& entry, int& comCalls) {
+		swapChain.getBufferCalls++;
+		comCalls++;
+		if (index == swapChain.failBuffer) return false;
+		entry.texture = index;
+		swapChain.liveHandles++;
+		swapChain.createViewCalls++;
+		comCalls++;
+		entry.view = index;
+		swapChain.liveHandles++;
+		return true;
+	}
+
+	int Release(MockSwapChain& swapChain, MockEntry& entry) {
+		int comCalls = 0;
+		if (entry.view >= 0) { entry.view = -1; swapChain.releaseCalls++; swapChain.liveHandles--; comCalls++; }
+		if (entry.texture >= 0) { entry.texture = -1; swapChain.releaseCalls++; swapChain.liveHandles--; comCalls++; }
+		return comCalls;
+	}
+
+	bool Rebuild(BackBufferCache<MockEntry>& cache, MockSwapChain& swapChain) {
+		return cache.Rebuild(swapChain.bufferCount, [&swapChain](int index, MockEntry& entry, int& comCalls) {
+			return Acquire(swapChain, index, entry, comCalls);
+		});
+	}
+
+	void Clear(BackBufferCache<MockEntry>& cache, MockSwapChain& swapChain) {
+		cache.Clear([&swapChain](MockEntry& entry) { return Release(swapChain, entry); });
+	}
+
+	// Once built, frames only look entries up: the counters must not move.
+	void TestSteadyStateMakesNoCalls() {
+		MockSwapChain swapChain;
+		BackBufferCache<MockEntry> cache;
+		CHECK(Rebuild(cache, swapChain));
+		CHECK_EQ(cache.Size(), 3);
+		CHECK_EQ(swapChain.Calls(), 6);
+		CHECK_EQ(cache.Stats().comCalls, 6);
+
+		const uint64_t frames = 100000;
+		uint64_t missing = 0;
+		for (uint64_t frame = 0; frame < frames; ++frame) {
+			int index = static_cast<int>(frame % 3);
+			MockEntry* pEntry = cache.Get(index);
+			if (!pEntry || pEntry->texture != index || pEntry->view != index) missing++;
+		}
+		CHECK_EQ(missing, 0);
+		CHECK_EQ(swapChain.Calls(), 6);
+		CHECK_EQ(cache.Stats().comCalls, 6);
+		CHECK_EQ(cache.Stats().lookups, frames);
+		CHECK_EQ(cache.Stats().rebuilds, 1);
+	}
+
+	// A resize releases every handle and fetches the new buffers once.
+	void TestResize() {
+		MockSwapChain swapChain;
+		BackBufferCache<MockEntry> cache;
+		CHECK(Rebuild(cache, swapChain));
+		Clear(cache, swapChain);
+		CHECK(cache.Empty());
+		CHECK_EQ(swapChain.liveHandles, 0);
+		CHECK_EQ(swapChain.releaseCalls, 6);
+
+		swapChain.bufferCount = 2;
+		CHECK(Rebuild(cache, swapChain));
+		CHECK_EQ(cache.Size(), 2);
+		CHECK(cache.Get(2) == nullptr);
+		CHECK(cache.Get(-1) == nullptr);
+		CHECK_EQ(cache.Stats().rebuilds, 2);
+		CHECK_EQ(cache.Stats().comCalls, swapChain.Calls());
+
+		Clear(cache, swapChain);
+		CHECK_EQ(swapChain.liveHandles, 0);
+		CHECK_EQ(cache.Stats().comCalls, swapChain.Calls());
+	}
+
+	// A buffer that cannot be fetched fails the rebuild; the others are still released.
+	void TestFailedAcquire() {
+		MockSwapChain swapChain;
+		swapChain.failBuffer = 1;
+		BackBufferCache<MockEntry> cache;
+		CHECK(!Rebuild(cache, swapChain));
+		CHECK_EQ(cache.Size(), 3);
+		CHECK_EQ(cache.Get(1)->texture, -1);
+		Clear(cache, swapChain);
+		CHECK_EQ(swapChain.liveHandles, 0);
+		CHECK_EQ(cache.Stats().comCalls, swapChain.Calls());
+	}
+}
+
+int main() {
+	TestSteadyStateMakesNoCalls();
+	TestResize();
+	TestFailedAcquire();
+	return TestExitCode();
+}
@@ -0,0 +1,214 @@
+#include <cstdint>
+#include <memory>
+#include "BackendCache.h"
+#include "TestCheck.h"
+
+// The reuse policy against mock devices: the hooks count what a D3D11 backend would
+// have had to rebuild, and the mock backend records resizes and cleanups.
+
+namespace {
+	int g_adapterA = 0, g_adapterB = 0, g_windowA = 0, g_windowB = 0;
+
+	struct DeviceLog {
+		int created = 0;
+		int destroyed = 0;
+		int surfaceResets = 0;
+		int surfaceReleases = 0;
+		int resizes = 0;
+		bool failCreate = false;
+		bool failSurfaceReset = false;
+	};
+
+	class MockBackend : public RenderBackend {
+	public:
+		explicit MockBackend(DeviceLog& log) : m_log(log) { m_log.created++; }
+		~MockBackend() override { m_log.destroyed++; }
+
+		bool Init(int, int) override { return true; }
+		void WaitForPresentSlot() override {}
+		void BeginFrame(uint64_t, int64_t) override {}
+		void RenderWorkload(int) override {}
+		void Clear(const float*) override {}
+		void DrawTestPattern(const TestPattern&) override {}
+		void DrawOverlay(const PerfOverlay&) override {}
+		void Present() override {}
+		int PresentDelayFrames() const override { return 0; }
+		void Resize(int width, int height) override {
+			m_log.resizes++;
+			this->width = width;
+			this->height = height;
+		}
+		void Cleanup() override {}
+
+		int width = 0;
+		int height = 0;
+
+	private:
+		DeviceLog& m_log;
+	};
+
+	BackendCacheHooks MockHooks(DeviceLog& log) {
+		BackendCacheHooks hooks;
+		hooks.create = [&log](const BackendCacheKey& key) -> std::unique_ptr<RenderBackend> {
+			if (log.failCreate) return nullptr;
+			std::unique_ptr<MockBackend> backend = std::make_unique<MockBackend>(log);
+			backend->width = key.width;
+			backend->height = key.height;
+			return backend;
+		};
+		hooks.resetSurface = [&log](RenderBackend&, const BackendCacheKey&) {
+			log.surfaceResets++;
+			return !log.failSurfaceReset;
+		};
+		hooks.releaseSurface = [&log](RenderBackend&) { log.surfaceReleases++; };
+		return hooks;
+	}
+
+	BackendCacheKey BaseKey() {
+		BackendCacheKey key;
+		key.renderAdapter = &g_adapterA;
+		key.displayAdapter = &g_adapterA;
+		key.window = &g_windowA;
+		key.width = 1280;
+		key.height = 720;
+		return key;
+	}
+
+	void TestPlan() {
+		BackendCacheKey base = BaseKey();
+		CHECK(PlanBackendReuse(base, base) == BackendReuse::Full);
+
+		BackendCacheKey key = base;
+		key.width = 1920;
+		CHECK(PlanBackendReuse(base, key) == BackendReuse::Resize);
+		key = base;
+		key.window = &g_windowB;
+		CHECK(PlanBackendReuse(base, key) == BackendReuse::SwapChain);
+		key = base;
+		key.allowTearing = true;
+		key.height = 1080;
+		CHECK(PlanBackendReuse(base, key) == BackendReuse::SwapChain);
+		key = base;
+		key.maxFrameLatency = 2;
+		CHECK(PlanBackendReuse(base, key) == BackendReuse::SwapChain);
+		key = base;
+		key.displayAdapter = &g_adapterB;
+		CHECK(PlanBackendReuse(base, key) == BackendReuse::Rebuild);
+		key = base;
+		key.type = RenderBackendType::Headless;
+		CHECK(PlanBackendReuse(base, key) == BackendReuse::Rebuild);
+	}
+
+	// Each level does only its own work: new devices, a new surface, a resize, nothing.
+	void TestReuseLevels() {
+		DeviceLog log;
+		BackendCache cache(MockHooks(log));
+		BackendReuse reuse = BackendReuse::Full;
+		BackendCacheKey key = BaseKey();
+		CHECK(cache.Plan(key) == BackendReuse::Rebuild);
+		RenderBackend* pFirst = cache.Acquire(key, reuse);
+		CHECK(pFirst != nullptr);
+		CHECK(reuse == BackendReuse::Rebuild);
+		CHECK_EQ(log.created, 1);
+
+		CHECK(cache.Acquire(key, reuse) == pFirst);
+		CHECK(reuse == BackendReuse::Full);
+
+		key.width = 1920;
+		key.height = 1080;
+		CHECK(cache.Acquire(key, reuse) == pFirst);
+		CHECK(reuse == BackendReuse::Resize);
+		CHECK_EQ(log.resizes, 1);
+		CHECK_EQ(static_cast<MockBackend*>(pFirst)->width, 1920);
+
+		key.window = &g_windowB;
+		CHECK(cache.Acquire(key, reuse) == pFirst);
+		CHECK(reuse == BackendReuse::SwapChain);
+		CHECK_EQ(log.surfaceResets, 1);
+
+		key.renderAdapter = &g_adapterB;
+		RenderBackend* pSecond = cache.Acquire(key, reuse);
+		CHECK(pSecond != nullptr);
+		CHECK(reuse == BackendReuse::Rebuild);
+		CHECK_EQ(log.created, 2);
+		CHECK_EQ(log.destroyed, 1);
+
+		const BackendCacheStats& stats = cache.Stats();
+		CHECK_EQ(stats.rebuilds, 2);
+		CHECK_EQ(stats.swapChainResets, 1);
+		CHECK_EQ(stats.resizes, 1);
+		CHECK_EQ(stats.reuses, 1);
+		CHECK_EQ(stats.failures, 0);
+		CHECK(cache.Key().renderAdapter == &g_adapterB);
+	}
+
+	// A surface that cannot be re-created on the old devices falls back to new devices.
+	void TestFailedSurfaceReset() {
+		DeviceLog log;
+		BackendCache cache(MockHooks(log));
+		BackendReuse reuse = BackendReuse::Full;
+		BackendCacheKey key = BaseKey();
+		cache.Acquire(key, reuse);
+		log.failSurfaceReset = true;
+		key.window = &g_windowB;
+		CHECK(cache.Acquire(key, reuse) != nullptr);
+		CHECK(reuse == BackendReuse::Rebuild);
+		CHECK_EQ(log.surfaceResets, 1);
+		CHECK_EQ(log.created, 2);
+		CHECK_EQ(log.destroyed, 1);
+		CHECK_EQ(cache.Stats().swapChainResets, 0);
+
+		// And when even that fails, nothing is cached.
+		log.failCreate = true;
+		key.window = &g_windowA;
+		CHECK(cache.Acquire(key, reuse) == nullptr);
+		CHECK(cache.Backend() == nullptr);
+		CHECK_EQ(cache.Stats().failures, 1);
+		CHECK_EQ(log.destroyed, 2);
+	}
+
+	// Once the surface is released, even an identical key needs a new swap chain.
+	void TestReleaseSurface() {
+		DeviceLog log;
+		BackendCache cache(MockHooks(log));
+		BackendReuse reuse = BackendReuse::Full;
+		BackendCacheKey key = BaseKey();
+		RenderBackend* pBackend = cache.Acquire(key, reuse);
+		cache.ReleaseSurface();
+		cache.ReleaseSurface();
+		CHECK_EQ(log.surfaceReleases, 1);
+		CHECK(cache.Plan(key) == BackendReuse::SwapChain);
+		key.width = 800;
+		CHECK(cache.Plan(key) == BackendReuse::SwapChain);
+
+		CHECK(cache.Acquire(key, reuse) == pBackend);
+		CHECK(reuse == BackendReuse::SwapChain);
+		CHECK_EQ(log.surfaceResets, 1);
+		CHECK(cache.Plan(key) == BackendReuse::Full);
+	}
+
+	void TestReset() {
+		DeviceLog log;
+		BackendCache cache(MockHooks(log));
+		BackendReuse reuse = BackendReuse::Full;
+		BackendCacheKey key = BaseKey();
+		cache.Acquire(key, reuse);
+		cache.Reset();
+		CHECK(cache.Backend() == nullptr);
+		CHECK_EQ(log.destroyed, 1);
+		CHECK(cache.Key().window == nullptr);
+		CHECK(cache.Plan(key) == BackendReuse::Rebuild);
+		cache.Acquire(key, reuse);
+		CHECK(reuse == BackendReuse::Rebuild);
+		CHECK_EQ(log.created, 2);
+	}
+}
+
+int main() {
+	TestPlan();
+	TestReuseLevels();
+	TestFailedSurfaceReset();
+	TestReleaseSurface();
+	TestReset();
+	return TestExitCode();
+}
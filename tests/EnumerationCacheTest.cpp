@@ -0,0 +1,115 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "EnumerationCache.h"
+#include "TestCheck.h"
+
+// The snapshot is a version number read from a fake topology, so a stale snapshot is
+// one whose version is behind the source.
+
+namespace {
+	struct Topology {
+		uint64_t version = 0;
+		int outputs = 0;
+	};
+
+	void TestHitsAndInvalidate() {
+		EnumerationCache<Topology> cache;
+		int enumerated = 0;
+		std::vector<uint64_t> released;
+		auto enumerate = [&enumerated](Topology& snapshot) { snapshot.version = static_cast<uint64_t>(++enumerated); snapshot.outputs = 2; };
+		auto release = [&released](Topology& snapshot) { released.push_back(snapshot.version); };
+
+		CHECK(cache.Stale());
+		CHECK(cache.Refresh(enumerate, release));
+		CHECK(!cache.Refresh(enumerate, release));
+		CHECK(!cache.Refresh(enumerate, release));
+		CHECK(!cache.Stale());
+		CHECK_EQ(cache.Current().version, 1);
+		CHECK(released.empty());
+
+		// Several invalidations before the next refresh cost one enumeration.
+		cache.Invalidate();
+		cache.Invalidate();
+		CHECK(cache.Stale());
+		CHECK(cache.Refresh(enumerate, release));
+		CHECK_EQ(cache.Current().version, 2);
+		CHECK_EQ(released.size(), 1);
+		CHECK_EQ(released[0], 1);
+
+		cache.Clear(release);
+		CHECK(!cache.Valid());
+		CHECK(cache.Stale());
+		CHECK_EQ(cache.Current().outputs, 0);
+		cache.Clear(release);
+		CHECK_EQ(released.size(), 2);
+
+		EnumerationCacheStats stats = cache.Stats();
+		CHECK_EQ(stats.enumerations, 2);
+		CHECK_EQ(stats.hits, 2);
+		CHECK_EQ(stats.invalidations, 2);
+	}
+
+	// An Invalidate() landing while Refresh() enumerates: the snapshot may predate the
+	// change, so it has to come out stale and the next Refresh() enumerates again.
+	void TestInvalidateDuringRefresh() {
+		EnumerationCache<Topology> cache;
+		uint64_t source = 1;
+		bool changeTopology = true;
+		auto release = [](Topology&) {};
+		auto enumerate = [&](Topology& snapshot) {
+			snapshot.version = source;
+			if (changeTopology) {
+				changeTopology = false;
+				source++;
+				cache.Invalidate();
+			}
+		};
+		CHECK(cache.Refresh(enumerate, release));
+		CHECK_EQ(cache.Current().version, 1);
+		CHECK(cache.Stale());
+		CHECK(cache.Refresh(enumerate, release));
+		CHECK_EQ(cache.Current().version, 2);
+		CHECK(!cache.Stale());
+		CHECK(!cache.Refresh(enumerate, release));
+	}
+
+	// The same race with a real second thread: however the invalidations interleave with
+	// the refreshes, once they stop one more Refresh() catches up with the source.
+	void TestConcurrentInvalidate() {
+		EnumerationCache<Topology> cache;
+		std::atomic<uint64_t> source{ 0 };
+		std::atomic<bool> stop{ false };
+		auto release = [](Topology&) {};
+		auto enumerate = [&source](Topology& snapshot) {
+			snapshot.version = source.load(std::memory_order_acquire);
+			std::this_thread::yield();
+		};
+
+		std::thread invalidator([&]() {
+			for (int i = 0; i < 20000 && !stop.load(std::memory_order_relaxed); ++i) {
+				source.fetch_add(1, std::memory_order_acq_rel);
+				cache.Invalidate();
+				if (i % 64 == 0) std::this_thread::yield();
+			}
+		});
+		for (int i = 0; i < 20000; ++i) cache.Refresh(enumerate, release);
+		stop.store(true, std::memory_order_relaxed);
+		invalidator.join();
+
+		cache.Refresh(enumerate, release);
+		CHECK(!cache.Stale());
+		CHECK_EQ(cache.Current().version, source.load());
+		EnumerationCacheStats stats = cache.Stats();
+		CHECK_EQ(stats.invalidations, source.load());
+		CHECK_EQ(stats.enumerations + stats.hits, 20001);
+	}
+}
+
+int main() {
+	TestHitsAndInvalidate();
+	TestInvalidateDuringRefresh();
+	TestConcurrentInvalidate();
+	return TestExitCode();
+}
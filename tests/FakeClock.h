@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "FrameClock.h"
+
+// Simulated FrameClock for tests: time moves only when the code under test sleeps or
+// spins, or when the test charges work with Advance(), so every run is deterministic.
+// A sleep wakes late by the next entry of a repeating latency list, the way a coarse
+// OS timer does; a deadline already passed returns at once.
+class FakeClock : public FrameClock {
+public:
+	explicit FakeClock(int64_t frequency = 1000000000, int64_t start = 1000000000)
+		: m_frequency(frequency), m_now(start) {}
+
+	int64_t Now() override { return m_now; }
+	int64_t Frequency() const override { return m_frequency; }
+	void SleepUntil(int64_t deadline) override {
+		m_sleeps++;
+		if (deadline <= m_now) return;
+		m_now = deadline;
+		if (!m_wakeLatencies.empty()) {
+			m_now += m_wakeLatencies[m_nextLatency];
+			m_nextLatency = (m_nextLatency + 1) % m_wakeLatencies.size();
+		}
+	}
+	void Relax() override { m_now += m_relaxTicks; }
+
+	void Advance(int64_t ticks) { m_now += ticks; }
+	void SetWakeLatencies(const std::vector<int64_t>& latencies) {
+		m_wakeLatencies = latencies;
+		m_nextLatency = 0;
+	}
+	void SetRelaxTicks(int64_t ticks) { m_relaxTicks = ticks; }
+	uint64_t Sleeps() const { return m_sleeps; }
+
+private:
+	int64_t m_frequency;
+	int64_t m_now;
+	int64_t m_relaxTicks = 50;
+	std::vector<int64_t> m_wakeLatencies;
+	size_t m_nextLatency = 0;
+	uint64_t m_sleeps = 0;
+};
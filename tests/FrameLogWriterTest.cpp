@@ -0,0 +1,203 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "FrameLogWriter.h"
+#include "SpscQueue.h"
+#include "TestCheck.h"
+
+namespace {
+	// Eight million values through a small queue, so both ends wrap it constantly and the
+	// producer keeps finding it full.
+	void TestQueueStress() {
+		const uint64_t kValues = 8000000;
+		SpscQueue<uint64_t, 1024> queue;
+		std::thread producer([&queue, kValues]() {
+			for (uint64_t value = 0; value < kValues; ++value) {
+				while (!queue.TryPush(value)) std::this_thread::yield();
+			}
+		});
+
+		uint64_t expected = 0;
+		uint64_t outOfOrder = 0;
+		uint64_t batch[256];
+		while (expected < kValues) {
+			size_t count = queue.PopBatch(batch, 256);
+			if (count == 0) {
+				std::this_thread::yield();
+				continue;
+			}
+			for (size_t i = 0; i < count; ++i) {
+				if (batch[i] != expected) outOfOrder++;
+				expected = batch[i] + 1;
+			}
+		}
+		producer.join();
+		CHECK_EQ(outOfOrder, 0);
+		CHECK_EQ(expected, kValues);
+		uint64_t extra = 0;
+		CHECK(!queue.TryPop(extra));
+		CHECK_EQ(queue.SizeApprox(), 0);
+	}
+
+	FrameRecord MakeRecord(uint64_t frameIndex) {
+		FrameRecord record;
+		record.frameIndex = frameIndex;
+		record.deadline = static_cast<int64_t>(frameIndex) * 1000;
+		record.wake = record.deadline + 1;
+		record.submit = record.deadline + 2;
+		record.present = record.deadline + 3;
+		record.interval = 1000;
+		return record;
+	}
+
+	// Producer on its own thread, as the render thread is. It stays within the queue's
+	// capacity of the writer, so nothing may be dropped; then every record must be on
+	// disk, in order and intact.
+	void TestWriterStress(FrameLogFormat format, const char* path, uint64_t records) {
+		FrameLogWriter writer;
+		CHECK(!writer.IsOpen());
+		if (!writer.Open(path, format, 10000000)) {
+			CHECK(!"cannot open frame log");
+			return;
+		}
+		CHECK(writer.IsOpen());
+
+		std::thread producer([&writer, records]() {
+			const uint64_t window = FrameLogWriter::kQueueCapacity / 2;
+			for (uint64_t i = 0; i < records; ++i) {
+				while (i >= writer.Written() + window) std::this_thread::yield();
+				writer.Push(MakeRecord(i));
+			}
+		});
+		producer.join();
+		writer.Close();
+		CHECK(!writer.IsOpen());
+		CHECK_EQ(writer.Dropped(), 0);
+		CHECK_EQ(writer.Written(), records);
+
+		// Ignored once closed, as the contract in FrameLogWriter.h allows.
+		writer.Push(MakeRecord(records));
+		CHECK_EQ(writer.Written(), records);
+
+		FILE* file = fopen(path, format == FrameLogFormat::Binary ? "rb" : "r");
+		if (!file) {
+			CHECK(!"cannot reopen frame log");
+			return;
+		}
+		uint64_t read = 0;
+		uint64_t mismatched = 0;
+		if (format == FrameLogFormat::Binary) {
+			FrameLogHeader header;
+			CHECK(fread(&header, sizeof(header), 1, file) == 1);
+			CHECK(memcmp(header.magic, "CFPSLOG", 8) == 0);
+			CHECK_EQ(header.recordSize, sizeof(FrameRecord));
+			CHECK_EQ(header.frequency, 10000000);
+			std::vector<FrameRecord> chunk(4096);
+			size_t count = 0;
+			while ((count = fread(chunk.data(), sizeof(FrameRecord), chunk.size(), file)) > 0) {
+				for (size_t i = 0; i < count; ++i) {
+					FrameRecord expected = MakeRecord(read++);
+					if (memcmp(&chunk[i], &expected, sizeof(FrameRecord)) != 0) mismatched++;
+				}
+			}
+		}
+		else {
+			char line[256];
+			CHECK(fgets(line, sizeof(line), file) && strcmp(line, "# frequency=10000000\n") == 0);
+			CHECK(fgets(line, sizeof(line), file) && strcmp(line, "frame,deadline,wake,submit,present,interval\n") == 0);
+			while (fgets(line, sizeof(line), file)) {
+				unsigned long long frameIndex = 0;
+				long long deadline = 0, wake = 0, submit = 0, present = 0, interval = 0;
+				FrameRecord expected = MakeRecord(read++);
+				if (sscanf(line, "%llu,%lld,%lld,%lld,%lld,%lld", &frameIndex, &deadline, &wake, &submit, &present, &interval) != 6 ||
+					frameIndex != expected.frameIndex || deadline != expected.deadline || present != expected.present) {
+					mismatched++;
+				}
+			}
+		}
+		fclose(file);
+		remove(path);
+		CHECK_EQ(read, records);
+		CHECK_EQ(mismatched, 0);
+	}
+
+	// Without a consumer keeping up, a full queue drops instead of blocking the producer.
+	void TestWriterDropsWhenFull() {
+		FrameLogWriter writer;
+		if (!writer.Open("frame_log_full.bin", FrameLogFormat::Binary, 1000)) {
+			CHECK(!"cannot open frame log");
+			return;
+		}
+		const uint64_t pushed = FrameLogWriter::kQueueCapacity * 64;
+		for (uint64_t i = 0; i < pushed; ++i) writer.Push(MakeRecord(i));
+		writer.Close();
+		CHECK_EQ(writer.Written() + writer.Dropped(), pushed);
+		remove("frame_log_full.bin");
+	}
+
+	// A producer left pushing through Close() can strand records in the queue. The next
+	// log must start with its own records only, so the stragglers are marked with frame
+	// indices the second log never uses.
+	void TestReopenDropsStragglers() {
+		const char* path = "frame_log_reopen.bin";
+		const uint64_t kStraggler = 1ull << 40;
+		const uint64_t kRecords = 100;
+		uint64_t foreign = 0;
+		uint64_t missing = 0;
+		for (int round = 0; round < 20; ++round) {
+			FrameLogWriter writer;
+			if (!writer.Open(path, FrameLogFormat::Binary, 1000)) {
+				CHECK(!"cannot open frame log");
+				return;
+			}
+			std::atomic<bool> started{ false };
+			std::thread producer([&writer, &started, kStraggler]() {
+				for (uint64_t i = 0; i < 200000; ++i) {
+					writer.Push(MakeRecord(kStraggler + i));
+					if (i == 1000) started.store(true, std::memory_order_release);
+				}
+			});
+			while (!started.load(std::memory_order_acquire)) std::this_thread::yield();
+			writer.Close();
+			producer.join();
+
+			if (!writer.Open(path, FrameLogFormat::Binary, 1000)) {
+				CHECK(!"cannot reopen frame log");
+				return;
+			}
+			for (uint64_t i = 0; i < kRecords; ++i) writer.Push(MakeRecord(i));
+			writer.Close();
+
+			FILE* file = fopen(path, "rb");
+			if (!file) {
+				CHECK(!"cannot read frame log");
+				return;
+			}
+			FrameLogHeader header;
+			CHECK(fread(&header, sizeof(header), 1, file) == 1);
+			FrameRecord record;
+			uint64_t next = 0;
+			while (fread(&record, sizeof(record), 1, file) == 1) {
+				if (record.frameIndex >= kStraggler) foreign++;
+				else if (record.frameIndex == next) next++;
+			}
+			fclose(file);
+			missing += kRecords - next;
+		}
+		remove(path);
+		CHECK_EQ(foreign, 0);
+		CHECK_EQ(missing, 0);
+	}
+}
+
+int main() {
+	TestQueueStress();
+	TestWriterStress(FrameLogFormat::Binary, "frame_log_stress.bin", 4000000);
+	TestWriterStress(FrameLogFormat::Csv, "frame_log_stress.csv", 200000);
+	TestWriterDropsWhenFull();
+	TestReopenDropsStragglers();
+	return TestExitCode();
+}
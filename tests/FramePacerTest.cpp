@@ -0,0 +1,120 @@
+#include <cstdint>
+#include <vector>
+#include "FakeClock.h"
+#include "FramePacer.h"
+#include "TestCheck.h"
+#include "TimerResolution.h"
+
+// Calibration and the pacer's sleep margin against a FakeClock whose wake-up latencies
+// are known exactly. Ticks are nanoseconds.
+
+namespace {
+	const int64_t kUs = 1000;
+	const int64_t kMs = 1000000;
+
+	// One unmeasured warm-up sleep, then sixteen samples of 10..160 us in shuffled order.
+	std::vector<int64_t> KnownLatencies() {
+		const int64_t samples[] = { 70, 10, 160, 40, 130, 100, 20, 150, 60, 90, 30, 120, 80, 140, 50, 110 };
+		std::vector<int64_t> latencies(1, 999 * kUs);
+		for (int64_t sample : samples) latencies.push_back(sample * kUs);
+		return latencies;
+	}
+
+	void TestCalibration() {
+		FakeClock clock;
+		clock.SetWakeLatencies(KnownLatencies());
+		TimerCalibration calibration = CalibrateWakeGranularity(clock);
+		CHECK_EQ(calibration.samples, 16);
+		CHECK_EQ(calibration.requestTicks, 250 * kUs);
+		// Sorted, the samples are 10..160 us: the median is the ninth, the granularity
+		// drops only the single slowest.
+		CHECK_EQ(calibration.medianOvershoot, 90 * kUs);
+		CHECK_EQ(calibration.granularity, 150 * kUs);
+		CHECK_EQ(calibration.maxOvershoot, 160 * kUs);
+		CHECK_EQ(clock.Sleeps(), 17);
+	}
+
+	void TestMarginSeed() {
+		FakeClock clock;
+		FramePacer pacer(clock);
+		CHECK(!pacer.Calibrated());
+		CHECK_EQ(pacer.SleepMargin(), 2 * kMs);
+
+		clock.SetWakeLatencies(KnownLatencies());
+		pacer.SetCalibration(CalibrateWakeGranularity(clock));
+		CHECK(pacer.Calibrated());
+		CHECK_EQ(pacer.SleepMargin(), 150 * kUs);
+		// Kept across Reset().
+		pacer.Reset();
+		CHECK_EQ(pacer.SleepMargin(), 150 * kUs);
+
+		// Below the 50 us floor the seed is raised to it.
+		TimerCalibration fine;
+		fine.samples = 16;
+		fine.medianOvershoot = 5 * kUs;
+		fine.granularity = 10 * kUs;
+		pacer.SetCalibration(fine);
+		CHECK_EQ(pacer.SleepMargin(), 50 * kUs);
+	}
+
+	// Paces 2000 frames at 100 fps with every wake `latency` late; returns early wakes.
+	uint64_t Pace(FramePacer& pacer, FakeClock& clock, int64_t latency) {
+		clock.SetWakeLatencies({ latency });
+		uint64_t early = 0;
+		int64_t deadline = clock.Now() + 10 * kMs;
+		for (int i = 0; i < 2000; ++i) {
+			if (pacer.WaitUntil(deadline) < deadline) early++;
+			deadline += 10 * kMs;
+		}
+		return early;
+	}
+
+	// The learned margin may grow to max(4 ms, 2 * granularity) and no further.
+	void TestMarginCeiling() {
+		TimerCalibration calibration;
+		calibration.samples = 16;
+
+		// Fine timer: the 4 ms ceiling applies even though 2 * granularity is 300 us.
+		FakeClock fineClock;
+		FramePacer finePacer(fineClock);
+		calibration.medianOvershoot = 90 * kUs;
+		calibration.granularity = 150 * kUs;
+		finePacer.SetCalibration(calibration);
+		CHECK_EQ(Pace(finePacer, fineClock, 8 * kMs), 0);
+		CHECK_EQ(finePacer.SleepMargin(), 4 * kMs);
+
+		// Coarse timer: 2 * granularity lifts the ceiling to 6 ms.
+		FakeClock coarseClock;
+		FramePacer coarsePacer(coarseClock);
+		calibration.medianOvershoot = 2 * kMs;
+		calibration.granularity = 3 * kMs;
+		coarsePacer.SetCalibration(calibration);
+		CHECK_EQ(coarsePacer.SleepMargin(), 3 * kMs);
+		CHECK_EQ(Pace(coarsePacer, coarseClock, 8 * kMs), 0);
+		CHECK_EQ(coarsePacer.SleepMargin(), 6 * kMs);
+	}
+
+	// With a steady latency under the margin every frame wakes in time to spin the rest.
+	void TestSteadyLatency() {
+		FakeClock clock;
+		clock.SetWakeLatencies(KnownLatencies());
+		FramePacer pacer(clock);
+		pacer.SetCalibration(CalibrateWakeGranularity(clock));
+		CHECK_EQ(Pace(pacer, clock, 100 * kUs), 0);
+		const PacerStats& stats = pacer.Stats();
+		CHECK_EQ(stats.waits, 2000);
+		CHECK_EQ(stats.sleeps, 2000);
+		// Spinning lands within one Relax() step of the deadline.
+		CHECK(stats.lateTicks < static_cast<int64_t>(stats.waits) * 50);
+		CHECK(pacer.SleepMargin() >= 100 * kUs);
+		CHECK(pacer.SleepMargin() < 2 * kMs);
+	}
+}
+
+int main() {
+	TestCalibration();
+	TestMarginSeed();
+	TestMarginCeiling();
+	TestSteadyLatency();
+	return TestExitCode();
+}
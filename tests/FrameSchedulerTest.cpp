@@ -0,0 +1,179 @@
+#include <climits>
+#include <cstdint>
+#include "FrameScheduler.h"
+#include "TestCheck.h"
+
+// The scheduler only sees the `now` it is handed, so a plain tick counter stands in for
+// the clock: 1 MHz and 100 fps give a 10000-tick period.
+
+namespace {
+	const int64_t kFrequency = 1000000;
+	const int64_t kPeriod = 10000;
+
+	__extension__ typedef unsigned __int128 Wide;
+
+	// deadline(n) = t0 + floor(n * frequency / fps), computed without overflow.
+	int64_t ExactDeadline(int64_t anchor, uint64_t frameIndex, int64_t frequency, int fps) {
+		return anchor + static_cast<int64_t>(static_cast<Wide>(frameIndex) * static_cast<uint64_t>(frequency) / static_cast<uint64_t>(fps));
+	}
+
+	void TestGrid() {
+		// QPC's 10 MHz against 144 fps leaves a remainder on every frame.
+		FrameScheduler scheduler(10000000, 144);
+		scheduler.Start(123456789);
+		for (uint64_t n = 0; n < 100000; ++n) {
+			if (scheduler.Deadline(n) != ExactDeadline(123456789, n, 10000000, 144)) {
+				CHECK_EQ(scheduler.Deadline(n), ExactDeadline(123456789, n, 10000000, 144));
+				break;
+			}
+		}
+		// n * frequency overflows 64 bits from about 9.2e11 frames at 10 MHz.
+		const uint64_t soak[] = { 922337203685ull, 1ull << 40, 1ull << 42, 5000000000000ull };
+		for (uint64_t n : soak) {
+			CHECK_EQ(scheduler.Deadline(n), ExactDeadline(123456789, n, 10000000, 144));
+			CHECK(scheduler.Deadline(n + 1) > scheduler.Deadline(n));
+		}
+	}
+
+	void TestOnTime() {
+		FrameScheduler scheduler(kFrequency, 100);
+		scheduler.Start(0);
+		CHECK_EQ(scheduler.NextDeadline(0), 0);
+		scheduler.Advance();
+		// Late, but by less than a period: the frame keeps its slot.
+		CHECK_EQ(scheduler.NextDeadline(kPeriod + kPeriod - 1), kPeriod);
+		CHECK_EQ(scheduler.SkippedFrames(), 0);
+		CHECK_EQ(scheduler.Reanchors(), 0);
+	}
+
+	void TestSkip() {
+		FrameScheduler scheduler(kFrequency, 100, CatchUpPolicy::Skip);
+		scheduler.Start(0);
+		scheduler.NextDeadline(0);
+		scheduler.Advance();
+		// Slots 1..3 have passed; the frame takes slot 3 and 1, 2 are dropped.
+		CHECK_EQ(scheduler.NextDeadline(3 * kPeriod + 5500), 3 * kPeriod);
+		CHECK_EQ(scheduler.FrameIndex(), 3);
+		CHECK_EQ(scheduler.SkippedFrames(), 2);
+		scheduler.Advance();
+		CHECK_EQ(scheduler.NextDeadline(3 * kPeriod + 6000), 4 * kPeriod);
+
+		// Landing exactly on a slot renders into that slot.
+		scheduler.Advance();
+		CHECK_EQ(scheduler.NextDeadline(8 * kPeriod), 8 * kPeriod);
+		CHECK_EQ(scheduler.SkippedFrames(), 5);
+	}
+
+	void TestBurst() {
+		FrameScheduler scheduler(kFrequency, 100, CatchUpPolicy::Burst);
+		scheduler.SetMaxBurst(2);
+		scheduler.Start(0);
+		scheduler.NextDeadline(0);
+		scheduler.Advance();
+
+		// Two missed slots are rendered back to back, then the rest are skipped.
+		int64_t now = 5 * kPeriod + 100;
+		CHECK_EQ(scheduler.NextDeadline(now), kPeriod);
+		scheduler.Advance();
+		CHECK_EQ(scheduler.NextDeadline(now), 2 * kPeriod);
+		scheduler.Advance();
+		CHECK_EQ(scheduler.BurstFrames(), 2);
+		CHECK_EQ(scheduler.NextDeadline(now), 5 * kPeriod);
+		CHECK_EQ(scheduler.SkippedFrames(), 2);
+
+		// Back on time ends the burst; the next fall-behind gets a fresh budget.
+		scheduler.Advance();
+		CHECK_EQ(scheduler.NextDeadline(6 * kPeriod), 6 * kPeriod);
+		scheduler.Advance();
+		CHECK_EQ(scheduler.NextDeadline(9 * kPeriod), 7 * kPeriod);
+		CHECK_EQ(scheduler.BurstFrames(), 3);
+	}
+
+	void TestReanchor() {
+		FrameScheduler scheduler(kFrequency, 100, CatchUpPolicy::Reanchor);
+		scheduler.Start(0);
+		scheduler.NextDeadline(0);
+		scheduler.Advance();
+
+		const int64_t now = 2 * kPeriod + 1234;
+		CHECK_EQ(scheduler.NextDeadline(now), now);
+		CHECK_EQ(scheduler.Reanchors(), 1);
+		CHECK_EQ(scheduler.FrameIndex(), 0);
+		CHECK_EQ(scheduler.SkippedFrames(), 0);
+		CHECK_EQ(scheduler.Deadline(1), now + kPeriod);
+	}
+
+	void TestStall() {
+		// A stall of stallFrames periods re-anchors whatever the policy.
+		const CatchUpPolicy policies[] = { CatchUpPolicy::Skip, CatchUpPolicy::Burst };
+		for (CatchUpPolicy policy : policies) {
+			FrameScheduler scheduler(kFrequency, 100, policy);
+			scheduler.SetStallFrames(30);
+			scheduler.Start(0);
+			scheduler.NextDeadline(0);
+			scheduler.Advance();
+			const int64_t now = kPeriod + 30 * kPeriod;
+			CHECK_EQ(scheduler.NextDeadline(now), now);
+			CHECK_EQ(scheduler.Reanchors(), 1);
+			CHECK_EQ(scheduler.BurstFrames(), 0);
+		}
+	}
+
+	void TestRetarget() {
+		FrameScheduler scheduler(kFrequency, 100);
+		scheduler.Start(0);
+		for (int i = 0; i < 10; ++i) {
+			scheduler.NextDeadline(i * kPeriod);
+			scheduler.Advance();
+		}
+		scheduler.SetTargetFps(250, 100500);
+		CHECK_EQ(scheduler.FrameIndex(), 0);
+		CHECK_EQ(scheduler.PeriodTicks(), 4000);
+		CHECK_EQ(scheduler.Deadline(3), 100500 + 12000);
+		scheduler.SetTargetFps(0, 0);
+		CHECK_EQ(scheduler.TargetFps(), 1);
+	}
+
+	void TestSoakSkip() {
+		// Skips of 2e9 frames, each short of a stall, walk the index past the point where
+		// n * frequency overflows; every skip must still land on the exact slot.
+		FrameScheduler scheduler(10000000, 144, CatchUpPolicy::Skip);
+		scheduler.SetStallFrames(INT_MAX);
+		const int64_t anchor = 1000000000000ll;
+		scheduler.Start(anchor);
+		scheduler.NextDeadline(anchor);
+		scheduler.Advance();
+
+		const uint64_t step = 2000000000ull;
+		uint64_t frameIndex = 1;
+		uint64_t skipped = 0;
+		for (int i = 0; i < 600; ++i) {
+			frameIndex += step;
+			skipped += step;
+			int64_t expected = ExactDeadline(anchor, frameIndex, 10000000, 144);
+			int64_t deadline = scheduler.NextDeadline(expected + 100);
+			if (deadline != expected || scheduler.FrameIndex() != frameIndex) {
+				CHECK_EQ(deadline, expected);
+				CHECK_EQ(scheduler.FrameIndex(), frameIndex);
+				break;
+			}
+			scheduler.Advance();
+			frameIndex++;
+		}
+		CHECK(frameIndex > 922337203685ull);
+		CHECK_EQ(scheduler.SkippedFrames(), skipped);
+		CHECK_EQ(scheduler.Reanchors(), 0);
+	}
+}
+
+int main() {
+	TestGrid();
+	TestOnTime();
+	TestSkip();
+	TestBurst();
+	TestReanchor();
+	TestStall();
+	TestRetarget();
+	TestSoakSkip();
+	return TestExitCode();
+}
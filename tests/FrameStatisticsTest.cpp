@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "FrameStatistics.h"
+#include "FrameTelemetry.h"
+#include "TestCheck.h"
+
+// Ticks are nanoseconds throughout (frequency 1e9), so expected values need no conversion.
+
+namespace {
+	// Half of the widest sub-bucket relative to its lower bound: 0.5 / 64.
+	const double kMaxRelativeError = 1.0 / 128.0;
+
+	bool Near(double actual, double expected, double relative) {
+		return std::fabs(actual - expected) <= relative * std::fabs(expected);
+	}
+
+	void TestBucketIndexing() {
+		// With 0 and a huge value around it, the median is whatever bucket v landed in.
+		std::vector<uint64_t> values;
+		for (uint64_t v = 1; v < 4096; ++v) values.push_back(v);
+		for (int exponent = 12; exponent <= 40; ++exponent) {
+			uint64_t power = 1ull << exponent;
+			values.push_back(power - 1);
+			values.push_back(power);
+			values.push_back(power + 1);
+			values.push_back(power + power / 3);
+		}
+		for (uint64_t v : values) {
+			FrameStatistics stats;
+			stats.Add(0);
+			stats.Add(static_cast<int64_t>(v));
+			stats.Add(int64_t(1) << 50);
+			double median = stats.QuantileMs(0.5) * 1e6;
+			// Below one sub-bucket range every nanosecond has its own bucket.
+			bool ok = v < 64 ? median == static_cast<double>(v) : Near(median, static_cast<double>(v), kMaxRelativeError);
+			if (!ok) {
+				CHECK_EQ(median, v);
+				break;
+			}
+		}
+
+		// Past 2^41 ns everything shares the last bucket, clamped to the real maximum.
+		FrameStatistics stats;
+		stats.Add(int64_t(1) << 45);
+		stats.Add(int64_t(1) << 46);
+		CHECK(stats.QuantileMs(0.5) * 1e6 <= static_cast<double>(int64_t(1) << 46));
+		CHECK(stats.QuantileMs(0.5) * 1e6 >= static_cast<double>(int64_t(1) << 40));
+	}
+
+	void TestQuantileBounds() {
+		std::mt19937_64 random(42);
+		std::lognormal_distribution<double> frametime(std::log(7e6), 0.4);
+		FrameStatistics stats;
+		std::vector<int64_t> samples;
+		for (int i = 0; i < 100000; ++i) {
+			int64_t sample = static_cast<int64_t>(frametime(random));
+			samples.push_back(sample);
+			stats.Add(sample);
+		}
+		std::sort(samples.begin(), samples.end());
+
+		const double quantiles[] = { 0.01, 0.25, 0.5, 0.9, 0.95, 0.99, 0.999, 0.9999 };
+		for (double quantile : quantiles) {
+			size_t rank = static_cast<size_t>(std::ceil(quantile * static_cast<double>(samples.size())));
+			double exact = static_cast<double>(samples[rank - 1]);
+			CHECK(Near(stats.QuantileMs(quantile) * 1e6, exact, kMaxRelativeError));
+		}
+		CHECK_EQ(stats.QuantileMs(0.0) * 1e6, samples.front());
+		CHECK_EQ(stats.QuantileMs(1.0) * 1e6, samples.back());
+
+		double sum = 0.0;
+		for (int64_t sample : samples) sum += static_cast<double>(sample);
+		CHECK(Near(stats.MeanMs() * 1e6, sum / static_cast<double>(samples.size()), 1e-9));
+	}
+
+	void TestConversion() {
+		// 10 MHz ticks; negative intervals count as zero.
+		FrameStatistics stats(10000000);
+		stats.Add(10000);
+		stats.Add(-5);
+		CHECK(stats.Summary().maxMs == 1.0);
+		CHECK(stats.Summary().minMs == 0.0);
+		CHECK_EQ(stats.Count(), 2);
+
+		stats.Reset(1000);
+		CHECK_EQ(stats.Count(), 0);
+		stats.Add(16);
+		CHECK(stats.Summary().maxMs == 16.0);
+	}
+
+	void TestLowFps() {
+		// 1% of 1000 frames is exactly the ten slowest.
+		FrameStatistics stats;
+		for (int i = 0; i < 990; ++i) stats.Add(10000000);
+		for (int i = 0; i < 10; ++i) stats.Add(50000000);
+		CHECK(Near(stats.LowFps(0.01), 20.0, kMaxRelativeError));
+		CHECK(Near(stats.Summary().averageFps, 1000.0 / 10.4, 1e-9));
+
+		// Slowest fraction spanning two buckets: five 40 ms and five 30 ms frames.
+		stats.Reset();
+		for (int i = 0; i < 990; ++i) stats.Add(10000000);
+		for (int i = 0; i < 5; ++i) stats.Add(30000000);
+		for (int i = 0; i < 5; ++i) stats.Add(40000000);
+		CHECK(Near(stats.LowFps(0.01), 1000.0 / 35.0, kMaxRelativeError));
+
+		// 0.1% of 1001 rounds up to two frames: the exact maximum plus one 40 ms frame.
+		stats.Add(123456789);
+		CHECK(Near(stats.LowFps(0.001), 2e9 / (123456789.0 + 40000000.0), kMaxRelativeError));
+
+		// A fraction of a frame rounds up: 1% of 150 frames is the two slowest.
+		stats.Reset();
+		for (int i = 0; i < 148; ++i) stats.Add(5000000);
+		stats.Add(20000000);
+		stats.Add(30000000);
+		CHECK(Near(stats.LowFps(0.01), 1000.0 / 25.0, kMaxRelativeError));
+		CHECK(Near(stats.LowFps(0.001), 1000.0 / 30.0, 1e-12));
+
+		stats.Reset();
+		CHECK(stats.LowFps(0.01) == 0.0);
+	}
+
+	void TestDurationFormat() {
+		FrameStatistics stats;
+		for (int i = 0; i < 99; ++i) stats.Add(1000000);
+		stats.Add(8000000);
+		// Quantiles are the middle of the 1 ms sub-bucket; mean and max are exact.
+		CHECK(FormatDurationSummary(stats.Summary()) == "count=100 mean=1.070 ms p50=1.004 ms p99=1.004 ms max=8.000 ms");
+	}
+
+	void TestFrameRing() {
+		FrameRing<int, 4> ring;
+		CHECK(ring.Empty());
+		CHECK_EQ(ring.MaxSize(), 4);
+		for (int i = 1; i <= 3; ++i) ring.Push(i);
+		CHECK_EQ(ring.Size(), 3);
+		CHECK_EQ(ring[0], 1);
+		CHECK_EQ(ring.Latest(), 3);
+
+		// Past capacity the oldest entries go first and index 0 stays the oldest kept.
+		for (int i = 4; i <= 10; ++i) ring.Push(i);
+		CHECK_EQ(ring.Size(), 4);
+		CHECK_EQ(ring.TotalPushed(), 10);
+		for (size_t i = 0; i < 4; ++i) CHECK_EQ(ring[i], 7 + static_cast<int>(i));
+		CHECK_EQ(ring.Latest(), 10);
+
+		// Every wrap position, not just a multiple of the capacity.
+		FrameRing<uint64_t, 8> records;
+		for (uint64_t pushed = 1; pushed <= 40; ++pushed) {
+			records.Push(pushed);
+			size_t size = records.Size();
+			CHECK_EQ(size, pushed < 8 ? pushed : 8);
+			CHECK_EQ(records[0], pushed - size + 1);
+			CHECK_EQ(records[size - 1], pushed);
+		}
+
+		ring.Clear();
+		CHECK(ring.Empty());
+		CHECK_EQ(ring.Size(), 0);
+		ring.Push(99);
+		CHECK_EQ(ring[0], 99);
+	}
+}
+
+int main() {
+	TestBucketIndexing();
+	TestQuantileBounds();
+	TestConversion();
+	TestLowFps();
+	TestDurationFormat();
+	TestFrameRing();
+	return TestExitCode();
+}
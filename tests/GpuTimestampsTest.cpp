@@ -0,0 +1,197 @@
+#include <cstdint>
+#include <vector>
+#include "GpuTimestamps.h"
+#include "TestCheck.h"
+
+// GpuTimestampRing against a scripted query source: the test decides when each slot's
+// queries are ready, whether they are disjoint and what every timestamp reads. CPU ticks
+// are nanoseconds; the GPU counts at 24 MHz, so every value goes through ToCpuTicks.
+
+namespace {
+	const int64_t kCpuFrequency = 1000000000;
+	const uint64_t kGpuFrequency = 24000000;
+
+	class ScriptedQuerySource : public GpuQuerySource {
+	public:
+		struct SlotScript {
+			bool ready = true;
+			bool disjoint = false;
+			uint64_t frequency = kGpuFrequency;
+			uint64_t ticks[kGpuMarkCount] = {};
+			int reads = 0;
+		};
+
+		bool Create(int slotCount) override {
+			slots.assign(slotCount, SlotScript());
+			created++;
+			return true;
+		}
+		void Release() override { released++; }
+		void Begin(int slot) override { slots[slot] = SlotScript(); slots[slot].ready = readyOnEnd; }
+		// Each mark reads the scripted GPU clock at the time it is written.
+		void Mark(int slot, int mark) override { slots[slot].ticks[mark] = gpuNow; }
+		void End(int) override {}
+		bool Read(int slot, uint32_t written, uint64_t ticks[kGpuMarkCount], uint64_t& frequency, bool& disjoint) override {
+			SlotScript& script = slots[slot];
+			script.reads++;
+			if (!script.ready) return false;
+			for (int mark = 0; mark < kGpuMarkCount; ++mark) {
+				if (written & (1u << mark)) ticks[mark] = script.ticks[mark];
+			}
+			frequency = script.frequency;
+			disjoint = script.disjoint;
+			return true;
+		}
+
+		std::vector<SlotScript> slots;
+		uint64_t gpuNow = 0;
+		bool readyOnEnd = true;
+		int created = 0;
+		int released = 0;
+	};
+
+	// One frame: workload of `workloadGpu` ticks, clear of `clearGpu`, issued at `cpuIssue`.
+	bool RunFrame(GpuTimestampRing& ring, ScriptedQuerySource& source, uint64_t frameIndex, int64_t cpuIssue, uint64_t workloadGpu, uint64_t clearGpu) {
+		if (!ring.BeginFrame(frameIndex, cpuIssue)) return false;
+		source.gpuNow += workloadGpu;
+		ring.Mark(kGpuMarkWorkload);
+		source.gpuNow += clearGpu;
+		ring.Mark(kGpuMarkClear);
+		ring.EndFrame();
+		return true;
+	}
+
+	// A slot is read only once readDelay frames have begun after it.
+	void TestReadDelay() {
+		ScriptedQuerySource source;
+		GpuTimestampRing ring(source, kCpuFrequency, 8, 3);
+		CHECK(ring.Create());
+		for (uint64_t frame = 0; frame < 3; ++frame) {
+			CHECK(RunFrame(ring, source, frame, 1000000 * static_cast<int64_t>(frame), 24000, 2400));
+		}
+		CHECK_EQ(source.slots[0].reads, 0);
+		CHECK_EQ(ring.Stage(kGpuMarkBegin).Count(), 0);
+
+		CHECK(RunFrame(ring, source, 3, 3000000, 24000, 2400));
+		CHECK_EQ(source.slots[0].reads, 1);
+		CHECK_EQ(source.slots[1].reads, 0);
+		CHECK_EQ(ring.Stage(kGpuMarkBegin).Count(), 1);
+		CHECK_EQ(ring.History().Latest().frameIndex, 0);
+
+		ring.Release();
+		CHECK_EQ(source.released, 1);
+		CHECK(!ring.BeginFrame(4, 4000000));
+	}
+
+	// 24000 GPU ticks are 1 ms and 2400 are 0.1 ms, even with the GPU counter far past
+	// the point where ticks * cpuFrequency overflows 64 bits.
+	void TestStagesAndRescaling() {
+		ScriptedQuerySource source;
+		source.gpuNow = 1000000000000000ull;
+		GpuTimestampRing ring(source, kCpuFrequency, 4, 1);
+		CHECK(ring.Create());
+		const int frames = 50;
+		int64_t cpuIssue = 5000000000;
+		for (int frame = 0; frame < frames; ++frame) {
+			CHECK(RunFrame(ring, source, frame, cpuIssue, 24000, 2400));
+			// The GPU idles between frames as long as the frames themselves take.
+			source.gpuNow += 26400;
+			cpuIssue += 2200000;
+		}
+		ring.Collect();
+		CHECK_EQ(ring.Stage(kGpuMarkWorkload).Count(), frames);
+		CHECK_EQ(ring.Stage(kGpuMarkClear).Count(), frames);
+		CHECK_EQ(ring.Stage(kGpuMarkCopy).Count(), 0);
+		CHECK(ring.Stage(kGpuMarkWorkload).MeanMs() == 1.0);
+		CHECK(ring.Stage(kGpuMarkClear).MeanMs() == 0.1);
+		CHECK(ring.Stage(kGpuMarkBegin).MeanMs() == 1.1);
+
+		const GpuFrameTiming& last = ring.History().Latest();
+		CHECK_EQ(last.frameIndex, frames - 1);
+		CHECK_EQ(last.StageTicks(kGpuMarkWorkload), 1000000);
+		CHECK_EQ(last.StageTicks(kGpuMarkClear), 100000);
+		CHECK_EQ(last.StageTicks(kGpuMarkCopy), 0);
+		CHECK(!last.Has(kGpuMarkCopy));
+		CHECK_EQ(ring.SkippedFrames(), 0);
+		CHECK_EQ(ring.DisjointFrames(), 0);
+	}
+
+	// The CPU-to-GPU offset is the largest seen so far, so no frame starts on the GPU
+	// before it was issued, and a frame that ran late keeps its true lag.
+	void TestOffsetOnlyGrows() {
+		ScriptedQuerySource source;
+		GpuTimestampRing ring(source, kCpuFrequency, 4, 1);
+		CHECK(ring.Create());
+		// GPU begin at 1 ms issued at 10 ms: offset 9 ms.
+		source.gpuNow = 24000;
+		RunFrame(ring, source, 0, 10000000, 0, 0);
+		ring.Collect();
+		CHECK_EQ(ring.History().Latest().marks[kGpuMarkBegin], 10000000);
+
+		// Issued 2 ms later but started on the GPU only 1 ms later: offset grows to 10 ms.
+		source.gpuNow = 48000;
+		RunFrame(ring, source, 1, 12000000, 0, 0);
+		ring.Collect();
+		CHECK_EQ(ring.History().Latest().marks[kGpuMarkBegin], 12000000);
+
+		// Started 5 ms after issue: the offset stays at 10 ms and the lag shows.
+		source.gpuNow = 48000 + 24000 * 7;
+		RunFrame(ring, source, 2, 14000000, 0, 0);
+		ring.Collect();
+		CHECK_EQ(ring.History().Latest().marks[kGpuMarkBegin], 19000000);
+		CHECK_EQ(ring.History().Latest().cpuIssue, 14000000);
+	}
+
+	// A busy oldest slot stalls read-back without blocking; once every slot is in flight
+	// the next frames go untimed and count as skipped. Reads resume in order once it lands.
+	void TestNotReadySkips() {
+		ScriptedQuerySource source;
+		GpuTimestampRing ring(source, kCpuFrequency, 4, 1);
+		CHECK(ring.Create());
+		source.readyOnEnd = false;
+		for (uint64_t frame = 0; frame < 4; ++frame) CHECK(RunFrame(ring, source, frame, 1000000 * static_cast<int64_t>(frame), 2400, 2400));
+		CHECK(!ring.BeginFrame(4, 4000000));
+		CHECK(!ring.FrameOpen());
+		CHECK(!ring.BeginFrame(5, 5000000));
+		CHECK_EQ(ring.SkippedFrames(), 2);
+		CHECK(source.slots[0].reads >= 2);
+		CHECK_EQ(source.slots[1].reads, 0);
+
+		for (ScriptedQuerySource::SlotScript& slot : source.slots) slot.ready = true;
+		source.readyOnEnd = true;
+		CHECK(RunFrame(ring, source, 6, 6000000, 2400, 2400));
+		CHECK_EQ(ring.Stage(kGpuMarkBegin).Count(), 4);
+		CHECK_EQ(ring.History().Latest().frameIndex, 3);
+		CHECK_EQ(ring.SkippedFrames(), 2);
+	}
+
+	// Disjoint slots, and ones reporting no frequency, are consumed but not measured.
+	void TestDisjoint() {
+		ScriptedQuerySource source;
+		GpuTimestampRing ring(source, kCpuFrequency, 4, 1);
+		CHECK(ring.Create());
+		for (uint64_t frame = 0; frame < 3; ++frame) {
+			CHECK(RunFrame(ring, source, frame, 1000000 * static_cast<int64_t>(frame), 2400, 2400));
+			if (frame == 0) source.slots[0].disjoint = true;
+			if (frame == 1) source.slots[1].frequency = 0;
+		}
+		ring.Collect();
+		CHECK_EQ(ring.DisjointFrames(), 2);
+		CHECK_EQ(ring.Stage(kGpuMarkBegin).Count(), 1);
+		CHECK_EQ(ring.History().Latest().frameIndex, 2);
+
+		ring.ResetStatistics();
+		CHECK_EQ(ring.DisjointFrames(), 0);
+		CHECK_EQ(ring.Stage(kGpuMarkBegin).Count(), 0);
+		CHECK(ring.History().Empty());
+	}
+}
+
+int main() {
+	TestReadDelay();
+	TestStagesAndRescaling();
+	TestOffsetOnlyGrows();
+	TestNotReadySkips();
+	TestDisjoint();
+	return TestExitCode();
+}
@@ -0,0 +1,183 @@
+#include <cstdint>
+#include <vector>
+#include "FakeClock.h"
+#include "FrameLoop.h"
+#include "LatencyProbe.h"
+#include "RenderBackend.h"
+#include "TestCheck.h"
+
+// The latency probe with synthetic inputs on a FakeClock, alone and driven by a FrameLoop.
+// Ticks are nanoseconds.
+
+namespace {
+	const int64_t kMs = 1000000;
+
+	// Presents take 1 ms of simulated time; the image reaches the swap chain `delay`
+	// presents later, as multi-GPU D3D11 does with delay 1. Records each frame's clear.
+	class DelayedBackend : public RenderBackend {
+	public:
+		DelayedBackend(FakeClock& clock, int delay) : m_clock(clock), m_delay(delay) {}
+
+		bool Init(int, int) override { return true; }
+		void WaitForPresentSlot() override {}
+		void BeginFrame(uint64_t, int64_t) override {}
+		void RenderWorkload(int) override {}
+		void Clear(const float color[4]) override { whiteClears.push_back(color[0] == 1.0f && color[1] == 1.0f && color[2] == 1.0f); }
+		void DrawTestPattern(const TestPattern&) override {}
+		void DrawOverlay(const PerfOverlay&) override {}
+		void Present() override { m_clock.Advance(kMs); }
+		int PresentDelayFrames() const override { return m_delay; }
+		void Resize(int, int) override {}
+		void Cleanup() override {}
+
+		std::vector<bool> whiteClears;
+
+	private:
+		FakeClock& m_clock;
+		int m_delay;
+	};
+
+	// Inputs before the next flash share it; the earliest one is measured.
+	void TestCoalescing() {
+		FakeClock clock;
+		LatencyProbe probe(clock);
+		probe.OnInput(100);
+		probe.OnInput(200);
+		probe.OnInput(300);
+		CHECK(probe.InputPending());
+		CHECK_EQ(probe.CoalescedInputs(), 2);
+
+		CHECK(probe.BeginFrame(7, 1000));
+		CHECK(!probe.InputPending());
+		CHECK(!probe.BeginFrame(8, 1100));
+		probe.OnSubmit(1500);
+		probe.OnPresent(2100);
+		CHECK_EQ(probe.Samples(), 1);
+		CHECK_EQ(probe.LastSample().frameIndex, 7);
+		CHECK_EQ(probe.LastSample().input, 100);
+		CHECK_EQ(probe.Summary(60).inputToSubmit.maxMs * 1e6, 1400);
+		CHECK_EQ(probe.Summary(60).inputToPresent.maxMs * 1e6, 2000);
+		CHECK_EQ(probe.Summary(60).coalescedInputs, 2);
+
+		probe.Reset();
+		CHECK_EQ(probe.Samples(), 0);
+		CHECK_EQ(probe.CoalescedInputs(), 0);
+	}
+
+	// Runs a 100 fps loop, injects one input after frame 3 and returns the probe's sample.
+	LatencySample FlashThroughLoop(int delay, uint64_t& samplesAfterFlashFrame, std::vector<int64_t>& presents, std::vector<bool>& whiteClears) {
+		FakeClock clock;
+		clock.SetWakeLatencies({ 20000 });
+		DelayedBackend backend(clock, delay);
+		LatencyProbe probe(clock);
+		FrameLoop loop(backend, clock, 100);
+		loop.SetLatencyProbe(&probe);
+		loop.Start();
+		for (int frame = 0; frame < 8; ++frame) {
+			presents.push_back(loop.RunFrame().present);
+			if (frame == 3) probe.OnInput(clock.Now());
+			if (frame == 4) samplesAfterFlashFrame = probe.Samples();
+		}
+		whiteClears = backend.whiteClears;
+		CHECK_EQ(probe.Samples(), 1);
+		return probe.LastSample();
+	}
+
+	// With a one-frame present delay the flash is timed at the Present after its own.
+	void TestPresentDelay() {
+		uint64_t samples = 0;
+		std::vector<int64_t> presents;
+		std::vector<bool> whiteClears;
+		LatencySample direct = FlashThroughLoop(0, samples, presents, whiteClears);
+		CHECK_EQ(samples, 1);
+		CHECK_EQ(direct.frameIndex, 4);
+		CHECK_EQ(direct.present, presents[4]);
+		CHECK(whiteClears.size() == 8 && whiteClears[4] && !whiteClears[3] && !whiteClears[5]);
+
+		presents.clear();
+		LatencySample delayed = FlashThroughLoop(1, samples, presents, whiteClears);
+		CHECK_EQ(samples, 0);
+		CHECK_EQ(delayed.frameIndex, 4);
+		CHECK_EQ(delayed.present, presents[5]);
+		CHECK_EQ(delayed.present - delayed.input, direct.present - direct.input + 10 * kMs);
+		CHECK(whiteClears.size() == 8 && whiteClears[4] && !whiteClears[5]);
+	}
+
+	// An input while the last flash is still on its way flashes the frame after that.
+	void TestInputDuringDelayedFlash() {
+		FakeClock clock;
+		clock.SetWakeLatencies({ 20000 });
+		DelayedBackend backend(clock, 1);
+		LatencyProbe probe(clock);
+		FrameLoop loop(backend, clock, 100);
+		loop.SetLatencyProbe(&probe);
+		loop.Start();
+		probe.OnInput(clock.Now());
+		loop.RunFrame();
+		probe.OnInput(clock.Now());
+		loop.RunFrame();
+		CHECK(probe.InputPending());
+		CHECK_EQ(probe.Samples(), 1);
+		loop.RunFrame();
+		loop.RunFrame();
+		CHECK_EQ(probe.Samples(), 2);
+		CHECK_EQ(probe.LastSample().frameIndex, 2);
+		CHECK(backend.whiteClears[0] && !backend.whiteClears[1] && backend.whiteClears[2] && !backend.whiteClears[3]);
+	}
+
+	// Feeds one sample of `latency` ticks straight through the probe.
+	void AddSample(LatencyProbe& probe, uint64_t frameIndex, int64_t input, int64_t latency) {
+		probe.OnInput(input);
+		probe.BeginFrame(frameIndex, input + 1);
+		probe.OnSubmit(input + latency / 2);
+		probe.OnPresent(input + latency);
+	}
+
+	void TestSweep() {
+		FakeClock clock;
+		LatencyProbe probe(clock);
+		LatencySweep sweep;
+		CHECK(!sweep.Active());
+		CHECK_EQ(sweep.CurrentFps(), 0);
+
+		sweep.Start({ 60, 144, 240 }, 3);
+		CHECK(sweep.Active());
+		const int64_t latencies[] = { 20 * kMs, 10 * kMs, 6 * kMs };
+		uint64_t frame = 0;
+		for (size_t step = 0; step < 3; ++step) {
+			CHECK_EQ(sweep.CurrentFps(), step == 0 ? 60 : (step == 1 ? 144 : 240));
+			for (int sample = 0; sample < 3; ++sample) {
+				CHECK(!sweep.Update(probe));
+				AddSample(probe, frame, static_cast<int64_t>(frame) * 100 * kMs, latencies[step]);
+				frame++;
+			}
+			CHECK(sweep.Update(probe));
+			// Each step starts from a fresh probe.
+			CHECK_EQ(probe.Samples(), 0);
+		}
+		CHECK(!sweep.Active());
+		CHECK(!sweep.Update(probe));
+
+		const std::vector<LatencySummary>& results = sweep.Results();
+		CHECK_EQ(results.size(), 3);
+		for (size_t step = 0; step < results.size() && step < 3; ++step) {
+			CHECK_EQ(results[step].inputToPresent.frames, 3);
+			CHECK(results[step].inputToPresent.meanMs * kMs == static_cast<double>(latencies[step]));
+			CHECK(results[step].inputToSubmit.meanMs * kMs == static_cast<double>(latencies[step] / 2));
+		}
+		CHECK_EQ(results[1].targetFps, 144);
+
+		sweep.Start({ 30 }, 5);
+		sweep.Stop();
+		CHECK(!sweep.Active());
+		CHECK(sweep.Results().empty());
+	}
+}
+
+int main() {
+	TestCoalescing();
+	TestPresentDelay();
+	TestInputDuringDelayedFlash();
+	TestSweep();
+	return TestExitCode();
+}
@@ -0,0 +1,76 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "BenchmarkRun.h"
+#include "FrameLogWriter.h"
+#include "MultiOutputRun.h"
+#include "TestCheck.h"
+
+namespace {
+	void TestFormatForPath() {
+		CHECK(FrameLogFormatForPath("frames.csv") == FrameLogFormat::Csv);
+		CHECK(FrameLogFormatForPath("C:\\logs\\Frames.CSV") == FrameLogFormat::Csv);
+		CHECK(FrameLogFormatForPath("frames.bin") == FrameLogFormat::Binary);
+		CHECK(FrameLogFormatForPath("frames.csv.bin") == FrameLogFormat::Binary);
+		CHECK(FrameLogFormatForPath("csv") == FrameLogFormat::Binary);
+		CHECK(FrameLogFormatForPath("") == FrameLogFormat::Binary);
+	}
+
+	// Lines after the two header lines; -1 when the header is not a CSV frame log's.
+	long long CsvFrameLines(const std::string& path) {
+		FILE* file = fopen(path.c_str(), "r");
+		if (!file) return -1;
+		char line[256];
+		long long lines = -1;
+		if (fgets(line, sizeof(line), file) && strncmp(line, "# frequency=", 12) == 0 &&
+			fgets(line, sizeof(line), file) && strcmp(line, "frame,deadline,wake,submit,present,interval\n") == 0) {
+			lines = 0;
+			while (fgets(line, sizeof(line), file)) lines++;
+		}
+		fclose(file);
+		return lines;
+	}
+
+	// Four headless outputs, each on its own render thread at its own rate, with the test
+	// pattern checked on every present and a CSV frame log per output.
+	void TestHeadlessOutputs() {
+		RunConfig config;
+		config.backend = RenderBackendType::Headless;
+		config.width = 160;
+		config.height = 120;
+		config.outputs = { 0, 1, 2, 3 };
+		config.outputFps = { 120, 240, 90 };
+		config.warmupSeconds = 0.1;
+		config.durationSeconds = 0.4;
+		config.pattern.barcode = true;
+		config.frameLogPath = "multi_output.CSV";
+
+		std::vector<RunStepResult> results;
+		std::string error;
+		CHECK_EQ(RunHeadlessMultiOutput(config, results, error), kRunExitOk);
+		CHECK_EQ(results.size(), 4);
+
+		const int expectedFps[] = { 120, 240, 90, 90 };
+		for (size_t i = 0; i < results.size() && i < 4; ++i) {
+			const RunStepResult& result = results[i];
+			CHECK_EQ(result.output, static_cast<int>(i));
+			CHECK_EQ(result.targetFps, expectedFps[i]);
+			CHECK(result.summary.frames > 0);
+			CHECK(result.pattern.frames > 0);
+			CHECK_EQ(result.pattern.undecoded, 0);
+			CHECK_EQ(result.pattern.reordered, 0);
+
+			std::string path = OutputFrameLogPath(config.frameLogPath, config.outputs[i]);
+			long long lines = CsvFrameLines(path);
+			CHECK(lines > static_cast<long long>(result.summary.frames));
+			remove(path.c_str());
+		}
+	}
+}
+
+int main() {
+	TestFormatForPath();
+	TestHeadlessOutputs();
+	return TestExitCode();
+}
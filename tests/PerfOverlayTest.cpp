@@ -0,0 +1,121 @@
+#include <cstdint>
+#include <cstring>
+#include "FrameStatistics.h"
+#include "HeadlessBackend.h"
+#include "PerfOverlay.h"
+#include "TestCheck.h"
+
+// The overlay composed into a real HeadlessBackend buffer through its SoftwareFill. At
+// scale 2 the panel is 304x164 and the backend puts it 16 pixels in from the top-left;
+// text starts 8 pixels further in.
+
+namespace {
+	const int kMargin = 16;
+	const int kPadding = 8;
+	const int64_t kFrequency = 1000;
+	const float kClear[4] = { 1.0f, 0.0f, 1.0f, 1.0f };
+
+	const uint32_t kBackground = PerfOverlay::PackRgba(24, 24, 24);
+	const uint32_t kText = PerfOverlay::PackRgba(235, 235, 235);
+	const uint32_t kOnTarget = PerfOverlay::PackRgba(76, 175, 80);
+	const uint32_t kLate = PerfOverlay::PackRgba(244, 67, 54);
+	const uint32_t kTargetLine = PerfOverlay::PackRgba(255, 193, 7);
+
+	// 100 fps on a 1 kHz clock: one on-target and one late frame, and text refreshed.
+	void PrepareOverlay(PerfOverlay& overlay) {
+		FrameStatistics statistics(kFrequency);
+		statistics.Add(10);
+		overlay.AddFrame(10);
+		overlay.AddFrame(20);
+		overlay.Refresh(statistics, 100, 1000);
+		overlay.Refresh(statistics, 100, 1250);
+	}
+
+	uint32_t Pixel(HeadlessBackend& backend, int x, int y) {
+		return backend.BackBuffer()[static_cast<size_t>(y) * backend.Width() + x];
+	}
+
+	// Pixels outside [x, x + width) x [y, y + height) that are not the clear colour.
+	int ChangedOutside(HeadlessBackend& backend, int x, int y, int width, int height) {
+		uint32_t clear = HeadlessBackend::PackColor(kClear);
+		int changed = 0;
+		for (int row = 0; row < backend.Height(); ++row) {
+			for (int column = 0; column < backend.Width(); ++column) {
+				bool inside = column >= x && column < x + width && row >= y && row < y + height;
+				if (!inside && Pixel(backend, column, row) != clear) changed++;
+			}
+		}
+		return changed;
+	}
+
+	void TestComposite() {
+		PerfOverlay overlay(kFrequency);
+		PrepareOverlay(overlay);
+		CHECK(strncmp(overlay.Line(0), "FPS ", 4) == 0);
+		CHECK_EQ(overlay.Width(), 304);
+		CHECK_EQ(overlay.Height(), 164);
+
+		HeadlessBackend backend(2, 0);
+		CHECK(backend.Init(400, 240));
+		backend.Clear(kClear);
+		backend.DrawOverlay(overlay);
+
+		// Panel corners.
+		CHECK_EQ(Pixel(backend, kMargin, kMargin), kBackground);
+		CHECK_EQ(Pixel(backend, kMargin + 303, kMargin + 163), kBackground);
+
+		// 'F': a full top row two pixels high, then only the left column.
+		int textX = kMargin + kPadding;
+		int textY = kMargin + kPadding;
+		for (int x = textX; x < textX + 10; ++x) {
+			CHECK_EQ(Pixel(backend, x, textY), kText);
+			CHECK_EQ(Pixel(backend, x, textY + 1), kText);
+		}
+		CHECK_EQ(Pixel(backend, textX - 1, textY), kBackground);
+		CHECK_EQ(Pixel(backend, textX, textY - 1), kBackground);
+		CHECK_EQ(Pixel(backend, textX, textY + 4), kText);
+		CHECK_EQ(Pixel(backend, textX + 2, textY + 4), kBackground);
+
+		// Graph: 60 pixels tall below the text, target line at half height.
+		int graphTop = textY + PerfOverlay::kLineCount * 20 + kPadding;
+		int targetY = graphTop + PerfOverlay::kGraphHeight / 2;
+		CHECK_EQ(Pixel(backend, textX, targetY), kTargetLine);
+		CHECK_EQ(Pixel(backend, textX, targetY + 1), kOnTarget);
+		CHECK_EQ(Pixel(backend, textX, targetY - 1), kBackground);
+		CHECK_EQ(Pixel(backend, textX + 2, graphTop), kLate);
+		CHECK_EQ(Pixel(backend, textX + 4, targetY + 1), kBackground);
+
+		CHECK_EQ(ChangedOutside(backend, kMargin, kMargin, overlay.Width(), overlay.Height()), 0);
+	}
+
+	// A panel that does not fit with its margin is skipped rather than clipped.
+	void TestOversizedSkipped() {
+		PerfOverlay overlay(kFrequency);
+		PrepareOverlay(overlay);
+		HeadlessBackend backend(2, 0);
+
+		CHECK(backend.Init(overlay.Width() + kMargin - 1, 240));
+		backend.Clear(kClear);
+		backend.DrawOverlay(overlay);
+		CHECK_EQ(ChangedOutside(backend, 0, 0, 0, 0), 0);
+
+		backend.Resize(400, overlay.Height() + kMargin - 1);
+		backend.Clear(kClear);
+		backend.DrawOverlay(overlay);
+		CHECK_EQ(ChangedOutside(backend, 0, 0, 0, 0), 0);
+
+		// Exactly the panel plus one margin fits, flush with the right and bottom edges.
+		backend.Resize(overlay.Width() + kMargin, overlay.Height() + kMargin);
+		backend.Clear(kClear);
+		backend.DrawOverlay(overlay);
+		CHECK_EQ(Pixel(backend, backend.Width() - 1, backend.Height() - 1), kBackground);
+		CHECK_EQ(ChangedOutside(backend, kMargin, kMargin, overlay.Width(), overlay.Height()), 0);
+		backend.Cleanup();
+	}
+}
+
+int main() {
+	TestComposite();
+	TestOversizedSkipped();
+	return TestExitCode();
+}
@@ -0,0 +1,83 @@
+#include <cstdio>
+#include <string>
+#include "PresentPolicy.h"
+#include "TestCheck.h"
+
+// PlanPresent is a pure function of its arguments, so each case is one table row: the
+// inputs and the plan fields the render loop acts on.
+
+namespace {
+	struct PlanCase {
+		const char* name;
+		PresentMode mode;
+		int targetFps;
+		int refreshRate;
+		bool tearingSupported;
+		unsigned syncInterval;
+		bool allowTearing;
+		bool useCpuLimiter;
+		int plannedFps;
+	};
+
+	const PlanCase kCases[] = {
+		// 144 / 60 rounds to interval 2, which runs at 72 Hz; the limiter holds 60.
+		{ "vsync 144 -> 60", PresentMode::VSync, 60, 144, true, 2, false, true, 60 },
+		// Exact divisors: vsync alone paces and the target snaps to the vsync rate.
+		{ "vsync 120 -> 60", PresentMode::VSync, 60, 120, false, 2, false, false, 60 },
+		{ "vsync 60 -> 60", PresentMode::VSync, 60, 60, false, 1, false, false, 60 },
+		{ "vsync 144 -> 72", PresentMode::VSync, 72, 144, false, 2, false, false, 72 },
+		// 145 Hz at interval 2 runs at 72 Hz once truncated, so it counts as a divisor.
+		{ "vsync 145 -> 72", PresentMode::VSync, 72, 145, false, 2, false, false, 72 },
+		// Above the refresh rate the interval stays at 1 and the limiter cannot help.
+		{ "vsync 60 -> 144", PresentMode::VSync, 144, 60, false, 1, false, true, 144 },
+		// Interval 8 is clamped to the DXGI maximum of 4.
+		{ "vsync 240 -> 30", PresentMode::VSync, 30, 240, false, 4, false, true, 30 },
+		// An unknown refresh rate falls back to interval 1 behind the limiter.
+		{ "vsync refresh 0", PresentMode::VSync, 60, 0, false, 1, false, true, 60 },
+		{ "vsync refresh -1", PresentMode::VSync, 60, -1, false, 1, false, true, 60 },
+		{ "vsync target 0", PresentMode::VSync, 0, 0, false, 1, false, true, 1 },
+		// Tearing is only requested when the adapter supports it.
+		{ "immediate tearing", PresentMode::Immediate, 300, 144, true, 0, true, true, 300 },
+		{ "immediate no tearing", PresentMode::Immediate, 300, 144, false, 0, false, true, 300 },
+		{ "vrr no tearing", PresentMode::Vrr, 100, 144, false, 0, false, true, 100 },
+		// VRR targets are held a few percent under the panel maximum.
+		{ "vrr ceiling", PresentMode::Vrr, 200, 144, true, 0, true, true, 139 },
+		{ "vrr at refresh", PresentMode::Vrr, 144, 144, true, 0, true, true, 139 },
+		{ "vrr under ceiling", PresentMode::Vrr, 100, 144, true, 0, true, true, 100 },
+		{ "vrr refresh 0", PresentMode::Vrr, 200, 0, true, 0, true, true, 200 },
+	};
+
+	void TestPlanTable() {
+		for (const PlanCase& row : kCases) {
+			PresentPlan plan = PlanPresent(row.mode, row.targetFps, row.refreshRate, row.tearingSupported);
+			int failuresBefore = TestDetail::Failures();
+			CHECK(plan.mode == row.mode);
+			CHECK_EQ(plan.syncInterval, row.syncInterval);
+			CHECK_EQ(plan.allowTearing, row.allowTearing);
+			CHECK_EQ(plan.useCpuLimiter, row.useCpuLimiter);
+			CHECK_EQ(plan.targetFps, row.plannedFps);
+			if (TestDetail::Failures() != failuresBefore) fprintf(stderr, "  in case \"%s\"\n", row.name);
+		}
+	}
+
+	void TestModeNames() {
+		const PresentMode modes[] = { PresentMode::VSync, PresentMode::Immediate, PresentMode::Vrr };
+		for (PresentMode mode : modes) {
+			PresentMode parsed = PresentMode::VSync;
+			CHECK(ParsePresentMode(PresentModeName(mode), parsed));
+			CHECK(parsed == mode);
+		}
+		PresentMode parsed = PresentMode::Vrr;
+		CHECK(ParsePresentMode("tearing", parsed));
+		CHECK(parsed == PresentMode::Immediate);
+		CHECK(!ParsePresentMode("VSYNC", parsed));
+		CHECK(!ParsePresentMode("", parsed));
+		CHECK(parsed == PresentMode::Immediate);
+	}
+}
+
+int main() {
+	TestPlanTable();
+	TestModeNames();
+	return TestExitCode();
+}
@@ -0,0 +1,135 @@
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "FrameClock.h"
+#include "FrameLoop.h"
+#include "HeadlessBackend.h"
+#include "RenderThread.h"
+#include "TestCheck.h"
+
+// The render thread driving a real FrameLoop on the headless backend, unpaced so frames
+// run flat out while the test thread plays the UI thread.
+
+namespace {
+	struct Receiver {
+		HeadlessBackend& backend;
+		uint64_t received = 0;
+		uint64_t outOfOrder = 0;
+		uint64_t resizes = 0;
+		// What the UI side may poll while the render thread runs.
+		std::atomic<uint64_t> drained{ 0 };
+
+		// Every command carries its sequence number in timestamp.
+		void OnCommand(const RenderCommand& command) {
+			if (static_cast<uint64_t>(command.timestamp) != received) outOfOrder++;
+			received = static_cast<uint64_t>(command.timestamp) + 1;
+			if (command.type == RenderCommandType::Resize) {
+				backend.Resize(command.width, command.height);
+				resizes++;
+			}
+			drained.store(received, std::memory_order_release);
+		}
+	};
+
+	RenderCommand MakeCommand(uint64_t sequence) {
+		RenderCommand command;
+		command.type = sequence % 8 == 0 ? RenderCommandType::Resize : RenderCommandType::Input;
+		command.width = 32 + static_cast<int>(sequence % 5) * 16;
+		command.height = 24 + static_cast<int>(sequence % 3) * 8;
+		command.timestamp = static_cast<int64_t>(sequence);
+		return command;
+	}
+
+	// A producer far faster than the frames: every command is either delivered, in order,
+	// or refused by Post and counted as dropped; nothing is lost or duplicated.
+	void TestCommandFlood() {
+		SystemClock clock;
+		HeadlessBackend backend(2, 0);
+		CHECK(backend.Init(64, 48));
+		FrameLoop loop(backend, clock, 1000);
+		loop.SetCpuLimiter(false);
+		loop.Start();
+		Receiver receiver{ backend };
+
+		RenderThread thread;
+		std::atomic<int> exits{ 0 };
+		CHECK(thread.Start(RenderThreadConfig(), [&receiver](const RenderCommand& command) { receiver.OnCommand(command); },
+			[&loop]() { loop.RunFrame(); return true; }, [&exits]() { exits++; }));
+
+		const uint64_t kCommands = 200000;
+		uint64_t refused = 0;
+		uint64_t sequence = 0;
+		while (sequence < kCommands) {
+			if (thread.Post(MakeCommand(sequence))) sequence++;
+			else {
+				refused++;
+				std::this_thread::yield();
+			}
+		}
+		// Stop only once everything posted has been drained.
+		while (thread.Running() && receiver.drained.load(std::memory_order_acquire) < kCommands) std::this_thread::yield();
+		thread.RequestStop();
+		thread.Join();
+
+		CHECK(!thread.Running());
+		CHECK_EQ(exits.load(), 1);
+		CHECK_EQ(receiver.received, kCommands);
+		CHECK_EQ(receiver.outOfOrder, 0);
+		CHECK_EQ(receiver.resizes, kCommands / 8);
+		CHECK_EQ(thread.DroppedCommands(), refused);
+		CHECK(thread.Frames() > 0);
+		CHECK_EQ(backend.PresentCount(), thread.Frames());
+	}
+
+	// Start, post, stop, join, over and over: every cycle ends with the thread joined and
+	// onExit run exactly once, whether it stopped on request or because a frame said so.
+	void TestStartStopCycles() {
+		SystemClock clock;
+		HeadlessBackend backend(2, 0);
+		CHECK(backend.Init(64, 48));
+		FrameLoop loop(backend, clock, 1000);
+		loop.SetCpuLimiter(false);
+		loop.Start();
+		Receiver receiver{ backend };
+
+		RenderThread thread;
+		std::atomic<int> exits{ 0 };
+		uint64_t posted = 0;
+		const int kCycles = 500;
+		for (int cycle = 0; cycle < kCycles; ++cycle) {
+			// Odd cycles end themselves after a few frames instead of being stopped.
+			uint64_t frameLimit = cycle % 2 ? 3 : UINT64_MAX;
+			uint64_t frames = 0;
+			bool started = thread.Start(RenderThreadConfig(), [&receiver](const RenderCommand& command) { receiver.OnCommand(command); },
+				[&loop, &frames, frameLimit]() {
+					loop.RunFrame();
+					return ++frames < frameLimit;
+				},
+				[&exits]() { exits++; });
+			CHECK(started);
+			// A second Start while running is refused.
+			CHECK(!thread.Start(RenderThreadConfig(), nullptr, []() { return false; }, nullptr));
+			for (int i = 0; i < 10; ++i) {
+				if (thread.Post(MakeCommand(posted))) posted++;
+			}
+			if (cycle % 2 == 0) thread.RequestStop();
+			thread.Join();
+			CHECK(!thread.Running());
+			if (cycle % 2) CHECK_EQ(frames, 3);
+		}
+		CHECK_EQ(exits.load(), kCycles);
+
+		// Commands still queued when a cycle stopped are delivered by the next one.
+		thread.Start(RenderThreadConfig(), [&receiver](const RenderCommand& command) { receiver.OnCommand(command); }, []() { return false; }, nullptr);
+		thread.Join();
+		CHECK_EQ(receiver.received, posted);
+		CHECK_EQ(receiver.outOfOrder, 0);
+		CHECK_EQ(thread.DroppedCommands(), 0);
+	}
+}
+
+int main() {
+	TestCommandFlood();
+	TestStartStopCycles();
+	return TestExitCode();
+}
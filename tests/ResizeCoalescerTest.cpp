@@ -0,0 +1,89 @@
+#include "ResizeCoalescer.h"
+#include "TestCheck.h"
+
+// A 1 kHz clock keeps the arithmetic readable: the 100 ms debounce is 100 ticks.
+
+namespace {
+	const int64_t kFrequency = 1000;
+
+	// A drag delivers a burst of sizes; only the last one is applied, once the burst
+	// has been quiet for the debounce interval.
+	void TestBurst() {
+		ResizeCoalescer resizes(kFrequency);
+		resizes.SetCurrent(800, 600);
+		for (int i = 0; i < 10; ++i) resizes.Request(800 + 10 * i, 600 + 5 * i, i);
+		CHECK(resizes.Pending());
+
+		int width = 0, height = 0;
+		CHECK(!resizes.Poll(50, width, height));
+		CHECK(!resizes.Poll(108, width, height));
+		CHECK(resizes.Poll(109, width, height));
+		CHECK_EQ(width, 890);
+		CHECK_EQ(height, 645);
+		resizes.OnApplied(7);
+		CHECK(!resizes.Pending());
+		CHECK(!resizes.Poll(500, width, height));
+
+		const ResizeStats& stats = resizes.Stats();
+		CHECK_EQ(stats.requests, 10);
+		CHECK_EQ(stats.coalesced, 9);
+		CHECK_EQ(stats.applied, 1);
+		CHECK_EQ(resizes.Cost().Count(), 1);
+	}
+
+	// Each request restarts the debounce interval.
+	void TestDebounceRestarts() {
+		ResizeCoalescer resizes(kFrequency);
+		resizes.SetCurrent(800, 600);
+		int width = 0, height = 0;
+		resizes.Request(1024, 768, 0);
+		CHECK(!resizes.Poll(99, width, height));
+		resizes.Request(1280, 720, 99);
+		CHECK(!resizes.Poll(150, width, height));
+		CHECK(resizes.Poll(199, width, height));
+		CHECK_EQ(width, 1280);
+		CHECK_EQ(height, 720);
+	}
+
+	// A drag that ends where it started applies nothing; the next size change is
+	// judged against the size in use, not the abandoned one.
+	void TestDragBackToStart() {
+		ResizeCoalescer resizes(kFrequency);
+		resizes.SetCurrent(800, 600);
+		int width = 0, height = 0;
+		resizes.Request(900, 700, 0);
+		resizes.Request(1000, 750, 10);
+		resizes.Request(800, 600, 20);
+		CHECK(!resizes.Poll(120, width, height));
+		CHECK(!resizes.Pending());
+		CHECK_EQ(width, 0);
+		CHECK_EQ(resizes.Stats().coalesced, 3);
+		CHECK_EQ(resizes.Stats().applied, 0);
+
+		resizes.Request(900, 700, 200);
+		CHECK(resizes.Poll(300, width, height));
+		CHECK_EQ(width, 900);
+		resizes.OnApplied(1);
+		resizes.Request(900, 700, 400);
+		CHECK(!resizes.Poll(500, width, height));
+		CHECK_EQ(resizes.Stats().applied, 1);
+	}
+
+	// Minimised or zero-sized windows never reach the backend.
+	void TestEmptySizeIgnored() {
+		ResizeCoalescer resizes(kFrequency);
+		resizes.SetCurrent(800, 600);
+		resizes.Request(0, 600, 0);
+		resizes.Request(800, -1, 0);
+		CHECK(!resizes.Pending());
+		CHECK_EQ(resizes.Stats().requests, 0);
+	}
+}
+
+int main() {
+	TestBurst();
+	TestDebounceRestarts();
+	TestDragBackToStart();
+	TestEmptySizeIgnored();
+	return TestExitCode();
+}
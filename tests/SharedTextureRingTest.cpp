@@ -0,0 +1,139 @@
+#include <cstdint>
+#include <vector>
+#include "SharedTextureRing.h"
+#include "TestCheck.h"
+
+// The multi-GPU copy ordering with the GPUs taken out: render, submit and copy are
+// driven the way D3D11Backend drives them, and the frame each copy delivers is recorded.
+
+namespace {
+	// Copies one ready slot the way CopyReadySharedTexture does; -1 when none is ready.
+	int64_t CopyOne(SharedTextureRing& ring) {
+		int slot = ring.BeginCopy();
+		if (slot < 0) return -1;
+		int64_t frame = static_cast<int64_t>(ring.SlotFrame(slot));
+		ring.EndCopy(slot);
+		return frame;
+	}
+
+	// Slots are handed out, filled and copied strictly in ring order, across many wraps.
+	void TestOrderAcrossWrap() {
+		SharedTextureRing ring(3);
+		CHECK_EQ(ring.SlotCount(), 3);
+		uint64_t misordered = 0;
+		for (uint64_t frame = 0; frame < 20; ++frame) {
+			int slot = ring.BeginRender();
+			if (slot != static_cast<int>(frame % 3)) misordered++;
+			CHECK(ring.State(slot) == SharedSlotState::Rendering);
+			ring.EndRender(slot);
+			CHECK(ring.State(slot) == SharedSlotState::Ready);
+			CHECK_EQ(ring.SlotFrame(slot), frame);
+			if (CopyOne(ring) != static_cast<int64_t>(frame)) misordered++;
+			CHECK(ring.State(slot) == SharedSlotState::Free);
+		}
+		CHECK_EQ(misordered, 0);
+		CHECK_EQ(ring.RenderedFrames(), 20);
+		CHECK_EQ(ring.CopiedFrames(), 20);
+
+		// Copies of several ready frames also come out oldest first.
+		for (int i = 0; i < 3; ++i) ring.EndRender(ring.BeginRender());
+		CHECK_EQ(ring.ReadyCount(), 3);
+		CHECK_EQ(CopyOne(ring), 20);
+		CHECK_EQ(CopyOne(ring), 21);
+		CHECK_EQ(CopyOne(ring), 22);
+		CHECK_EQ(CopyOne(ring), -1);
+	}
+
+	// With every slot rendering, ready or copying there is nothing to render into, and
+	// out-of-turn calls leave the ring alone.
+	void TestAllInFlight() {
+		SharedTextureRing ring(3);
+		int first = ring.BeginRender();
+		int second = ring.BeginRender();
+		ring.EndRender(second);
+		int third = ring.BeginRender();
+		CHECK(first == 0 && second == 1 && third == 2);
+		CHECK_EQ(ring.BeginRender(), -1);
+		// The oldest is still rendering, so nothing can be copied yet.
+		CHECK_EQ(ring.BeginCopy(), -1);
+
+		ring.EndRender(first);
+		int copying = ring.BeginCopy();
+		CHECK_EQ(copying, 0);
+		CHECK_EQ(ring.BeginRender(), -1);
+		ring.EndCopy(copying);
+		CHECK_EQ(ring.BeginRender(), 0);
+
+		ring.EndRender(-1);
+		ring.EndCopy(2);
+		CHECK(ring.State(2) == SharedSlotState::Rendering);
+		CHECK_EQ(ring.CopiedFrames(), 1);
+	}
+
+	// Each Present copies what CopiesDue asks for; the back buffer then shows the last
+	// frame copied. It runs one frame behind, with the first frame shown twice.
+	void TestCopyPreviousReady() {
+		SharedTextureRing ring(3);
+		std::vector<int64_t> shown;
+		int64_t backBuffer = -1;
+		for (int frame = 0; frame < 10; ++frame) {
+			int slot = ring.BeginRender();
+			if (slot < 0) {
+				CopyOne(ring);
+				slot = ring.BeginRender();
+			}
+			ring.EndRender(slot);
+			for (int due = ring.CopiesDue(); due > 0; --due) {
+				int64_t copied = CopyOne(ring);
+				if (copied < 0) break;
+				backBuffer = copied;
+			}
+			shown.push_back(backBuffer);
+		}
+		const int64_t expected[] = { 0, 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+		for (size_t i = 0; i < shown.size(); ++i) CHECK_EQ(shown[i], expected[i]);
+		CHECK_EQ(ring.ReadyCount(), 1);
+
+		// A backlog is drained down to the newest frame in one go.
+		SharedTextureRing backlog(4);
+		for (int i = 0; i < 3; ++i) backlog.EndRender(backlog.BeginRender());
+		CHECK_EQ(backlog.CopiesDue(), 2);
+		CopyOne(backlog);
+		CopyOne(backlog);
+		CHECK_EQ(backlog.CopiesDue(), 0);
+		CHECK_EQ(SharedTextureRing(2).CopiesDue(), 0);
+	}
+
+	// Reset frees every slot, restarts frame numbering and clamps the slot count.
+	void TestReset() {
+		SharedTextureRing ring(3);
+		for (int i = 0; i < 5; ++i) {
+			ring.EndRender(ring.BeginRender());
+			CopyOne(ring);
+		}
+		ring.BeginRender();
+		ring.Reset(4);
+		CHECK_EQ(ring.SlotCount(), 4);
+		CHECK_EQ(ring.RenderedFrames(), 0);
+		CHECK_EQ(ring.CopiedFrames(), 0);
+		CHECK_EQ(ring.ReadyCount(), 0);
+		int slot = ring.BeginRender();
+		CHECK_EQ(slot, 0);
+		ring.EndRender(slot);
+		CHECK_EQ(ring.SlotFrame(slot), 0);
+		CHECK_EQ(ring.CopiesDue(), 1);
+
+		ring.Reset(0);
+		CHECK_EQ(ring.SlotCount(), 1);
+		ring.Reset(100);
+		CHECK_EQ(ring.SlotCount(), SharedTextureRing::kMaxSlots);
+	}
+}
+
+int main() {
+	TestOrderAcrossWrap();
+	TestAllInFlight();
+	TestCopyPreviousReady();
+	TestReset();
+	return TestExitCode();
+}
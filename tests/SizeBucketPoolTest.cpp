@@ -0,0 +1,132 @@
+#include <vector>
+#include "SizeBucketPool.h"
+#include "TestCheck.h"
+
+// Entries are plain ids handed out by the create hook; the destroy hook records which
+// ids were freed and in what order.
+
+namespace {
+	struct Hooks {
+		int nextId = 1;
+		bool failCreate = false;
+		std::vector<int> created;
+		std::vector<int> destroyed;
+		std::vector<int> createdWidths;
+
+		bool Acquire(SizeBucketPool<int>& pool, int width, int height, int& entry, int& bucketWidth, int& bucketHeight) {
+			return pool.Acquire(width, height, entry, bucketWidth, bucketHeight,
+				[this](int w, int, int& created) {
+					if (failCreate) return false;
+					created = nextId++;
+					this->created.push_back(created);
+					createdWidths.push_back(w);
+					return true;
+				},
+				[this](int& entry) { destroyed.push_back(entry); });
+		}
+	};
+
+	void TestBuckets() {
+		SizeBucketPool<int> pool;
+		CHECK_EQ(pool.BucketSize(1), 128);
+		CHECK_EQ(pool.BucketSize(128), 128);
+		CHECK_EQ(pool.BucketSize(129), 256);
+
+		Hooks hooks;
+		int entry = 0, bucketWidth = 0, bucketHeight = 0;
+		CHECK(hooks.Acquire(pool, 800, 600, entry, bucketWidth, bucketHeight));
+		CHECK_EQ(bucketWidth, 896);
+		CHECK_EQ(bucketHeight, 640);
+		CHECK_EQ(hooks.createdWidths.size(), 1);
+		CHECK_EQ(hooks.createdWidths[0], 896);
+
+		// A nearby size lands in the same bucket and takes the released entry back.
+		pool.Release(entry, bucketWidth, bucketHeight);
+		int again = 0;
+		CHECK(hooks.Acquire(pool, 810, 610, again, bucketWidth, bucketHeight));
+		CHECK_EQ(again, entry);
+		CHECK_EQ(pool.Stats().allocations, 1);
+		CHECK_EQ(pool.Stats().reuses, 1);
+		CHECK_EQ(pool.IdleCount(), 0);
+	}
+
+	// Resizing away and back: the first size is still idle when the second is acquired,
+	// so returning to it reuses the allocation instead of making a new one.
+	void TestReturnToRecentSize() {
+		SizeBucketPool<int> pool;
+		Hooks hooks;
+		int small = 0, large = 0, back = 0, bucketWidth = 0, bucketHeight = 0;
+		CHECK(hooks.Acquire(pool, 800, 600, small, bucketWidth, bucketHeight));
+		pool.Release(small, bucketWidth, bucketHeight);
+		CHECK(hooks.Acquire(pool, 1920, 1080, large, bucketWidth, bucketHeight));
+		CHECK(large != small);
+		CHECK_EQ(pool.IdleCount(), 1);
+		pool.Release(large, bucketWidth, bucketHeight);
+
+		CHECK(hooks.Acquire(pool, 800, 600, back, bucketWidth, bucketHeight));
+		CHECK_EQ(back, small);
+		CHECK_EQ(pool.IdleCount(), 1);
+		CHECK(hooks.destroyed.empty());
+		CHECK_EQ(pool.Stats().allocations, 2);
+		CHECK_EQ(pool.Stats().reuses, 1);
+		CHECK_EQ(pool.Stats().evictions, 0);
+	}
+
+	// Idle entries past maxIdle go oldest first, after the acquired one is taken out.
+	void TestEviction() {
+		SizeBucketPool<int> pool(128, 2);
+		Hooks hooks;
+		int entries[4] = {};
+		int bucketWidth = 0, bucketHeight = 0;
+		for (int i = 0; i < 4; ++i) {
+			CHECK(hooks.Acquire(pool, 256 * (i + 1), 256, entries[i], bucketWidth, bucketHeight));
+		}
+		for (int i = 0; i < 4; ++i) pool.Release(entries[i], 256 * (i + 1), 256);
+		CHECK_EQ(pool.IdleCount(), 4);
+
+		int reused = 0;
+		CHECK(hooks.Acquire(pool, 512, 256, reused, bucketWidth, bucketHeight));
+		CHECK_EQ(reused, entries[1]);
+		CHECK_EQ(hooks.destroyed.size(), 1);
+		CHECK_EQ(hooks.destroyed[0], entries[0]);
+		CHECK_EQ(pool.IdleCount(), 2);
+		CHECK_EQ(pool.Stats().evictions, 1);
+
+		// A miss trims too, even when the new entry cannot be created.
+		hooks.failCreate = true;
+		int missing = -1;
+		pool.Release(reused, 512, 256);
+		CHECK(!hooks.Acquire(pool, 4096, 256, missing, bucketWidth, bucketHeight));
+		CHECK_EQ(missing, 0);
+		CHECK_EQ(hooks.destroyed.size(), 2);
+		CHECK_EQ(hooks.destroyed[1], entries[2]);
+		CHECK_EQ(pool.Stats().allocations, 4);
+
+		pool.Clear([&hooks](int& entry) { hooks.destroyed.push_back(entry); });
+		CHECK_EQ(pool.IdleCount(), 0);
+		CHECK_EQ(hooks.destroyed.size(), 4);
+		CHECK_EQ(hooks.destroyed[2], entries[3]);
+		CHECK_EQ(hooks.destroyed[3], entries[1]);
+	}
+
+	// maxIdle 0 keeps nothing idle once the next Acquire runs.
+	void TestNoIdle() {
+		SizeBucketPool<int> pool(64, 0);
+		Hooks hooks;
+		int first = 0, second = 0, bucketWidth = 0, bucketHeight = 0;
+		CHECK(hooks.Acquire(pool, 100, 100, first, bucketWidth, bucketHeight));
+		pool.Release(first, bucketWidth, bucketHeight);
+		CHECK(hooks.Acquire(pool, 200, 100, second, bucketWidth, bucketHeight));
+		CHECK_EQ(pool.IdleCount(), 0);
+		CHECK_EQ(hooks.destroyed.size(), 1);
+		CHECK_EQ(hooks.destroyed[0], first);
+	}
+}
+
+int main() {
+	TestBuckets();
+	TestReturnToRecentSize();
+	TestEviction();
+	TestNoIdle();
+	return TestExitCode();
+}
@@ -0,0 +1,127 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FakeClock.h"
+#include "StartupTasks.h"
+#include "TestCheck.h"
+
+// Every task runs on its own thread, so these run the real graph; the fake clock is
+// only read, which keeps the phase timings out of the picture.
+
+namespace {
+	// A failure skips everything downstream of it without running it, and leaves
+	// independent tasks alone.
+	void TestFailedDependency() {
+		FakeClock clock;
+		StartupTasks tasks(clock);
+		std::atomic<int> ran{ 0 };
+		int failing = tasks.Add("gdiplus", [&ran]() { ran++; return false; });
+		int direct = tasks.Add("logo", [&ran]() { ran++; return true; }, { failing });
+		int indirect = tasks.Add("splash", [&ran]() { ran++; return true; }, { direct });
+		int independent = tasks.Add("adapters", [&ran]() { ran++; return true; });
+		int mixed = tasks.Add("window", [&ran]() { ran++; return true; }, { independent, failing });
+		tasks.Start();
+
+		CHECK(!tasks.WaitAll());
+		CHECK(!tasks.Wait(failing));
+		CHECK(!tasks.Wait(direct));
+		CHECK(!tasks.Wait(indirect));
+		CHECK(tasks.Wait(independent));
+		CHECK(!tasks.Wait(mixed));
+		CHECK_EQ(ran.load(), 2);
+
+		std::vector<StartupPhase> phases = tasks.Phases();
+		CHECK_EQ(phases.size(), 5);
+		int skipped = 0, failed = 0;
+		for (const StartupPhase& phase : phases) {
+			CHECK(phase.background);
+			if (phase.skipped) skipped++;
+			else if (!phase.ok) failed++;
+		}
+		CHECK_EQ(skipped, 3);
+		CHECK_EQ(failed, 1);
+		std::string text = FormatStartupPhases(phases);
+		CHECK(text.find("gdiplus* 0.00+0.00 ms failed") != std::string::npos);
+		CHECK(text.find("logo* 0.00+0.00 ms skipped") != std::string::npos);
+	}
+
+	// Results stay available once everything has finished, and out-of-order calls fail
+	// instead of blocking.
+	void TestWaitAfterCompletion() {
+		FakeClock clock;
+		StartupTasks tasks(clock);
+		int first = tasks.Add("first", []() { return true; });
+		int second = tasks.Add("second", []() { return true; }, { first });
+		CHECK_EQ(tasks.Add("forward", []() { return true; }, { 5 }), -1);
+		CHECK(!tasks.Wait(first));
+		tasks.Start();
+		tasks.Start();
+		CHECK_EQ(tasks.Add("late", []() { return true; }), -1);
+
+		CHECK(tasks.WaitAll());
+		CHECK(tasks.WaitAll());
+		CHECK(tasks.Wait(second));
+		CHECK(tasks.Wait(first));
+		CHECK(!tasks.Wait(2));
+		CHECK(!tasks.Wait(-1));
+
+		CHECK(!tasks.RunInline("inline", []() { return false; }));
+		std::vector<StartupPhase> phases = tasks.Phases();
+		CHECK_EQ(phases.size(), 3);
+		CHECK(phases[0].name == "inline" && !phases[0].background && !phases[0].ok);
+
+		// Nothing added is trivially done.
+		StartupTasks empty(clock);
+		empty.Start();
+		CHECK(empty.WaitAll());
+	}
+
+	// A layered graph run many times: every task starts only after each of its
+	// dependencies has finished, whatever order the threads get scheduled in.
+	void TestDependencyOrdering() {
+		const int kLayers = 4;
+		const int kWidth = 4;
+		const int kTasks = kLayers * kWidth;
+		int misordered = 0;
+		for (int round = 0; round < 50; ++round) {
+			FakeClock clock;
+			StartupTasks tasks(clock);
+			std::atomic<int> sequence{ 0 };
+			std::vector<int> started(kTasks, -1), finished(kTasks, -1);
+			std::vector<std::vector<int>> dependencies(kTasks);
+			for (int i = 0; i < kTasks; ++i) {
+				int layer = i / kWidth;
+				if (layer > 0) {
+					// Two parents from the layer above, different for each task.
+					int above = (layer - 1) * kWidth;
+					dependencies[i].push_back(above + i % kWidth);
+					dependencies[i].push_back(above + (i + 1 + round) % kWidth);
+				}
+				int id = tasks.Add("task" + std::to_string(i), [&, i]() {
+					started[i] = sequence++;
+					if ((i + round) % 3 == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+					finished[i] = sequence++;
+					return true;
+				}, dependencies[i]);
+				CHECK_EQ(id, i);
+			}
+			tasks.Start();
+			CHECK(tasks.WaitAll());
+			for (int i = 0; i < kTasks; ++i) {
+				for (int dependency : dependencies[i]) {
+					if (finished[dependency] < 0 || started[i] <= finished[dependency]) misordered++;
+				}
+			}
+		}
+		CHECK_EQ(misordered, 0);
+	}
+}
+
+int main() {
+	TestFailedDependency();
+	TestWaitAfterCompletion();
+	TestDependencyOrdering();
+	return TestExitCode();
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdio>
+
+// Checks for the ctest executables. A failed check prints its location and the test
+// keeps going; main returns TestExitCode() so ctest sees every failure in one run.
+namespace TestDetail {
+	inline int& Failures() {
+		static int failures = 0;
+		return failures;
+	}
+
+	inline void Fail(const char* file, int line, const char* text) {
+		fprintf(stderr, "%s:%d: CHECK(%s) failed\n", file, line, text);
+		Failures()++;
+	}
+}
+
+#define CHECK(condition) do { if (!(condition)) TestDetail::Fail(__FILE__, __LINE__, #condition); } while (0)
+// Compares as long long and prints both sides on failure.
+#define CHECK_EQ(actual, expected) do { \
+	long long checkActual = static_cast<long long>(actual), checkExpected = static_cast<long long>(expected); \
+	if (checkActual != checkExpected) { \
+		fprintf(stderr, "%s:%d: %s == %lld, expected %lld\n", __FILE__, __LINE__, #actual, checkActual, checkExpected); \
+		TestDetail::Failures()++; \
+	} \
+} while (0)
+
+inline int TestExitCode() {
+	if (TestDetail::Failures() > 0) fprintf(stderr, "%d check(s) failed\n", TestDetail::Failures());
+	return TestDetail::Failures() > 0 ? 1 : 0;
+}
@@ -0,0 +1,227 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "BenchmarkSuite.h"
+#include "SoftwareFill.h"
+#include "TestCheck.h"
+#include "TestPattern.h"
+
+// Frames are composed into plain buffers and read back, so the stamped counter goes
+// through the same pixels the headless check and a capture would see. 256x64 is small
+// enough that the barcode cells shrink to 5 pixels.
+
+namespace {
+	const int kWidth = 256;
+	const int kHeight = 64;
+
+	TestPatternConfig BarcodeConfig() {
+		TestPatternConfig config;
+		config.barcode = true;
+		return config;
+	}
+
+	TestPatternConfig ColorConfig() {
+		TestPatternConfig config;
+		config.colorSequence = true;
+		return config;
+	}
+
+	std::vector<uint32_t> BarcodeFrame(SoftwareFill& fill, uint64_t counter) {
+		std::vector<uint32_t> frame(static_cast<size_t>(kWidth) * kHeight, 0xFF000000u);
+		TestPattern pattern(BarcodeConfig());
+		pattern.SetFrame(counter);
+		pattern.Compose(fill, frame.data(), kWidth, kWidth, kHeight);
+		return frame;
+	}
+
+	// What the colour sequence clears the frame to.
+	std::vector<uint32_t> ColorFrame(uint64_t counter) {
+		return std::vector<uint32_t>(static_cast<size_t>(kWidth) * kHeight, TestPattern::PaletteColor(static_cast<int>(counter % TestPattern::kColorCount)));
+	}
+
+	void TestBarcodeRoundTrip() {
+		SoftwareFill fill(0);
+		TestPatternDecoder decoder(BarcodeConfig());
+		const uint64_t counters[] = { 0, 1, 0x12345678, 0xFFFFFFFF };
+		for (uint64_t counter : counters) {
+			std::vector<uint32_t> frame = BarcodeFrame(fill, counter);
+			uint64_t decoded = 0;
+			CHECK(decoder.Decode(frame.data(), kWidth, kHeight, kWidth, decoded));
+			CHECK_EQ(decoded, counter);
+		}
+		// Nothing stamped, or a surface too small for the barcode, does not decode.
+		std::vector<uint32_t> blank(static_cast<size_t>(kWidth) * kHeight, 0xFF000000u);
+		uint64_t decoded = 0;
+		CHECK(!decoder.Decode(blank.data(), kWidth, kHeight, kWidth, decoded));
+		CHECK(!decoder.Decode(blank.data(), kWidth, 40, kWidth, decoded));
+		CHECK(!decoder.Decode(nullptr, kWidth, kHeight, kWidth, decoded));
+	}
+
+	// A frame torn between two counters mixes their cells; the CRC belongs to only one
+	// of them, so the frame is rejected instead of read as a third counter.
+	void TestTornFrame() {
+		SoftwareFill fill(0);
+		std::vector<uint32_t> older = BarcodeFrame(fill, 0x0000FFFF);
+		std::vector<uint32_t> newer = BarcodeFrame(fill, 0x00010000);
+		PatternRegion region;
+		CHECK(TestPattern(BarcodeConfig()).BarcodeRegion(kWidth, kHeight, region));
+		int cellWidth = region.width / TestPattern::kBarcodeCells;
+		CHECK_EQ(cellWidth, 5);
+
+		// Older high half, newer low half and CRC: reads as counter 0 with 0x10000's CRC.
+		int split = region.x + (TestPattern::kGuardCells + 16) * cellWidth;
+		std::vector<uint32_t> torn = older;
+		for (int y = 0; y < kHeight; ++y) {
+			for (int x = split; x < kWidth; ++x) torn[static_cast<size_t>(y) * kWidth + x] = newer[static_cast<size_t>(y) * kWidth + x];
+		}
+		TestPatternDecoder decoder(BarcodeConfig());
+		uint64_t decoded = 0;
+		CHECK(!decoder.Decode(torn.data(), kWidth, kHeight, kWidth, decoded));
+
+		decoder.AddFrame(older.data(), kWidth, kHeight, kWidth);
+		decoder.AddFrame(torn.data(), kWidth, kHeight, kWidth);
+		decoder.AddFrame(newer.data(), kWidth, kHeight, kWidth);
+		const PatternCheckStats& stats = decoder.Stats();
+		CHECK_EQ(stats.frames, 3);
+		CHECK_EQ(stats.decoded, 2);
+		CHECK_EQ(stats.undecoded, 1);
+		CHECK_EQ(stats.dropped, 0);
+		CHECK(!PatternCheckPassed(stats));
+	}
+
+	// Only 32 bits are stamped; the decoder extends them around the last counter, so the
+	// wrap reads as +1 and a step back across it still reads as a step back.
+	void TestCounterWrap() {
+		SoftwareFill fill(0);
+		TestPatternDecoder decoder(BarcodeConfig());
+		const uint64_t counters[] = { 0xFFFFFFFEull, 0xFFFFFFFFull, 0x100000000ull, 0x100000001ull };
+		for (uint64_t counter : counters) {
+			std::vector<uint32_t> frame = BarcodeFrame(fill, counter);
+			uint64_t decoded = 0;
+			CHECK(decoder.Decode(frame.data(), kWidth, kHeight, kWidth, decoded));
+			CHECK_EQ(decoded, counter);
+			decoder.AddFrame(frame.data(), kWidth, kHeight, kWidth);
+		}
+		CHECK(PatternCheckPassed(decoder.Stats()));
+		CHECK_EQ(decoder.Stats().decoded, 4);
+
+		std::vector<uint32_t> late = BarcodeFrame(fill, 0xFFFFFFFFull);
+		uint64_t decoded = 0;
+		CHECK(decoder.Decode(late.data(), kWidth, kHeight, kWidth, decoded));
+		CHECK_EQ(decoded, 0xFFFFFFFFull);
+		decoder.AddFrame(late.data(), kWidth, kHeight, kWidth);
+		CHECK_EQ(decoder.Stats().reordered, 1);
+		CHECK_EQ(decoder.Stats().dropped, 0);
+	}
+
+	// Without the barcode only counter % kColorCount is visible: gaps shorter than the
+	// cycle are counted exactly, a whole cycle reads as a repeat and a step back reads
+	// as a forward jump.
+	void TestColorSequence() {
+		TestPatternDecoder decoder(ColorConfig());
+		const uint64_t shown[] = { 3, 4, 5, 7, 7, 8, 9, 15, 11, 10 };
+		for (uint64_t counter : shown) {
+			std::vector<uint32_t> frame = ColorFrame(counter);
+			decoder.AddFrame(frame.data(), kWidth, kHeight, kWidth);
+		}
+		const PatternCheckStats& stats = decoder.Stats();
+		CHECK_EQ(stats.frames, 10);
+		CHECK_EQ(stats.decoded, 10);
+		// 15 after 9 reads as a repeat of 9, so 11 then counts 10 as dropped; 10 after 11
+		// reads as 16, dropping 12..15.
+		CHECK_EQ(stats.dropped, 1 + 1 + 4);
+		CHECK_EQ(stats.dropEvents, 3);
+		CHECK_EQ(stats.repeated, 2);
+		CHECK_EQ(stats.reordered, 0);
+
+		// The first frame only knows its index; black and white never decode.
+		decoder.Reset();
+		std::vector<uint32_t> frame = ColorFrame(10);
+		uint64_t decoded = 99;
+		CHECK(decoder.Decode(frame.data(), kWidth, kHeight, kWidth, decoded));
+		CHECK_EQ(decoded, 4);
+		std::vector<uint32_t> white(frame.size(), 0xFFFFFFFFu);
+		CHECK(!decoder.Decode(white.data(), kWidth, kHeight, kWidth, decoded));
+	}
+
+	bool WriteFrames(const char* path, const std::vector<std::vector<uint32_t>>& frames, size_t trailingPixels) {
+		FILE* file = fopen(path, "wb");
+		if (!file) return false;
+		for (const std::vector<uint32_t>& frame : frames) fwrite(frame.data(), sizeof(uint32_t), frame.size(), file);
+		if (trailingPixels > 0) fwrite(frames.front().data(), sizeof(uint32_t), trailingPixels, file);
+		return fclose(file) == 0;
+	}
+
+	void TestCaptureFile() {
+		SoftwareFill fill(0);
+		const char* path = "pattern_capture.rgba";
+		std::vector<std::vector<uint32_t>> frames;
+		for (uint64_t counter = 40; counter < 43; ++counter) frames.push_back(BarcodeFrame(fill, counter));
+
+		CHECK(WriteFrames(path, frames, 0));
+		TestPatternDecoder whole(BarcodeConfig());
+		std::string error;
+		CHECK(CheckPatternCapture(path, kWidth, kHeight, whole, error));
+		CHECK_EQ(whole.Stats().decoded, 3);
+		CHECK(PatternCheckPassed(whole.Stats()));
+
+		// A capture cut off mid-frame fails, but the whole frames before it still count.
+		CHECK(WriteFrames(path, frames, static_cast<size_t>(kWidth) * kHeight / 2));
+		TestPatternDecoder truncated(BarcodeConfig());
+		error.clear();
+		CHECK(!CheckPatternCapture(path, kWidth, kHeight, truncated, error));
+		CHECK(error.find("not a whole number") != std::string::npos);
+		CHECK_EQ(truncated.Stats().frames, 3);
+		CHECK_EQ(truncated.Stats().decoded, 3);
+		remove(path);
+
+		TestPatternDecoder missing(BarcodeConfig());
+		CHECK(!CheckPatternCapture(path, kWidth, kHeight, missing, error));
+		CHECK(error.find("cannot open") != std::string::npos);
+		CHECK(!CheckPatternCapture(path, 0, kHeight, missing, error));
+		CHECK_EQ(missing.Stats().frames, 0);
+	}
+
+	// A step with pattern errors fails the suite; results and the later steps are kept.
+	void TestSuiteFailsOnPatternErrors() {
+		RunConfig config;
+		config.backend = RenderBackendType::Headless;
+		std::vector<RunStepResult> results;
+		std::string error;
+
+		PatternCheckStats clean;
+		clean.frames = clean.decoded = 100;
+		PatternCheckStats repeated = clean;
+		repeated.repeated = 1;
+		auto runCell = [&](const RunConfig&, std::vector<RunStepResult>& cellResults, std::string&) {
+			RunStepResult step;
+			step.targetFps = 120;
+			step.pattern = clean;
+			cellResults.push_back(step);
+			step.targetFps = 240;
+			step.pattern = repeated;
+			cellResults.push_back(step);
+			return static_cast<int>(kRunExitOk);
+		};
+		CHECK_EQ(RunBenchmarkSuite(config, runCell, results, error), kRunExitPatternFailed);
+		CHECK_EQ(results.size(), 2);
+		CHECK(error.find("240 fps") != std::string::npos);
+		CHECK(error.find("repeated=1") != std::string::npos);
+
+		// Steps nobody checked have no pattern frames and pass.
+		repeated = PatternCheckStats();
+		error.clear();
+		CHECK_EQ(RunBenchmarkSuite(config, runCell, results, error), kRunExitOk);
+		CHECK(error.empty());
+	}
+}
+
+int main() {
+	TestBarcodeRoundTrip();
+	TestTornFrame();
+	TestCounterWrap();
+	TestColorSequence();
+	TestCaptureFile();
+	TestSuiteFailsOnPatternErrors();
+	return TestExitCode();
+}
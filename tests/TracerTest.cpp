@@ -0,0 +1,68 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "TestCheck.h"
+#include "Tracer.h"
+
+namespace {
+	// 1024 chunks of 4096 events per thread.
+	const uint64_t kCapacity = 4096ull * 1024ull;
+
+	uint64_t ZoneCount(const char* name) {
+		for (const TraceZoneSummary& zone : Tracer::Instance().Summarize()) {
+			if (zone.name == name) return zone.count;
+		}
+		return 0;
+	}
+
+	void RecordZones(const char* name, uint64_t count) {
+		Tracer& tracer = Tracer::Instance();
+		int64_t now = Tracer::Now();
+		for (uint64_t i = 0; i < count; ++i) tracer.Record(name, now, now + 1);
+	}
+
+	// A capture longer than the ring drops the excess, and says so in the export.
+	void TestFullCaptureDrops() {
+		Tracer& tracer = Tracer::Instance();
+		tracer.Start();
+		RecordZones("full", kCapacity + 100);
+		tracer.Stop();
+		CHECK_EQ(tracer.DroppedEvents(), 100);
+		CHECK_EQ(ZoneCount("full"), kCapacity);
+
+		std::string error;
+		CHECK(tracer.WriteChromeTrace("tracer_test.json", error));
+		FILE* file = fopen("tracer_test.json", "r");
+		if (!file) {
+			CHECK(!"cannot reopen trace");
+			return;
+		}
+		std::string text;
+		char chunk[4096];
+		size_t read = 0;
+		while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) text.append(chunk, read);
+		fclose(file);
+		remove("tracer_test.json");
+		CHECK(text.find("\"otherData\": {\"dropped_events\": 100}") != std::string::npos);
+	}
+
+	// Later captures reuse the ring instead of finding it used up.
+	void TestCapturesReuseRing() {
+		Tracer& tracer = Tracer::Instance();
+		for (int capture = 0; capture < 2; ++capture) {
+			tracer.Start();
+			RecordZones("reused", kCapacity);
+			tracer.Stop();
+			CHECK_EQ(tracer.DroppedEvents(), 0);
+			CHECK_EQ(ZoneCount("reused"), kCapacity);
+			CHECK_EQ(ZoneCount("full"), 0);
+		}
+	}
+}
+
+int main() {
+	TestFullCaptureDrops();
+	TestCapturesReuseRing();
+	return TestExitCode();
+}